@@ -0,0 +1,89 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <core/position_analyzer.h>
+
+using connect_four::Evaluator;
+using connect_four::PositionAnalyzer;
+using connect_four::PositionFormat;
+using connect_four::PositionReader;
+using connect_four::analysis_options;
+using connect_four::analysis_stats;
+
+namespace {
+
+void PrintUsage() {
+  std::cout << "Usage: analyze-positions <input path> <numeric|string|moves> "
+               "<output path> [--depth <plies>] [--movetime <ms>] "
+               "[--threads <n>] [--evaluator <threats|network>]"
+            << std::endl;
+}
+
+// Reads the flags after the paths, returning false if any are unknown or
+// missing a value
+bool ParseFlags(int argc, char *argv[], analysis_options& options) {
+  for (int arg = 4; arg < argc; arg += 2) {
+    std::string flag = argv[arg];
+    if (arg + 1 >= argc) {
+      return false;
+    }
+    std::string value = argv[arg + 1];
+
+    if (flag == "--depth") {
+      options.depth = std::stoul(value);
+    } else if (flag == "--movetime") {
+      options.move_time_ms = std::stoul(value);
+    } else if (flag == "--threads") {
+      options.number_threads = std::stoul(value);
+    } else if (flag == "--evaluator" && value == "threats") {
+      options.evaluator = Evaluator::Threats;
+    } else if (flag == "--evaluator" && value == "network") {
+      options.evaluator = Evaluator::NeuralNetwork;
+    } else {
+      return false;
+    }
+  }
+
+  // Without either limit a search would run to the end of every game
+  return options.depth > 0 || options.move_time_ms > 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  // Analyzes every position in a file, streaming the results so inputs of
+  // any size run in the same memory
+  analysis_options options;
+  if (argc < 4 || !ParseFlags(argc, argv, options)) {
+    PrintUsage();
+    return 1;
+  }
+
+  std::string format_name = argv[2];
+  PositionFormat format = PositionFormat::Numeric;
+  if (format_name == "string") {
+    format = PositionFormat::String;
+  } else if (format_name == "moves") {
+    format = PositionFormat::Moves;
+  }
+
+  PositionReader reader(argv[1], format);
+  std::ofstream output(argv[3]);
+  if (!output.is_open()) {
+    std::cout << "Can't write " << argv[3] << std::endl;
+    return 1;
+  }
+
+  PositionAnalyzer analyzer(options);
+  analysis_stats stats = analyzer.Run(reader, output);
+  std::cout << "Analyzed " << stats.positions << " positions ("
+            << stats.positions_skipped << " invalid skipped) on "
+            << analyzer.GetNumberThreads() << " threads in " << stats.seconds
+            << " s" << std::endl;
+  if (stats.seconds > 0) {
+    std::cout << stats.CalculatePositionsPerSecond() << " positions/sec, "
+              << stats.nodes / stats.seconds << " nodes/sec" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,201 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <core/arena.h>
+
+using connect_four::Arena;
+using connect_four::Evaluator;
+using connect_four::SearchAlgorithm;
+using connect_four::SprtResult;
+using connect_four::arena_options;
+using connect_four::arena_stats;
+using connect_four::player_config;
+
+namespace {
+
+// Openings a shallow search scores within this of even count as balanced
+const float kBalancedScore = 0.2f;
+
+// A struct storing the settings given on the command line
+struct arena_flags {
+  player_config first;
+  player_config second;
+  arena_options options;
+  std::string openings_path;
+  size_t opening_plies = 4;
+  // Progress is printed after this many game pairs
+  size_t report_interval = 10;
+};
+
+void PrintUsage() {
+  std::cout << "Usage: arena [--pairs <n>] [--threads <n>] "
+               "[--openings <move file> | --opening-plies <n>] "
+               "[--sprt-elo0 <elo>] [--sprt-elo1 <elo>] "
+               "[--record <game file>]\n"
+               "             [--first-<setting> <value>] "
+               "[--second-<setting> <value>]\n"
+               "Settings: depth, movetime (ms), evaluator (threats|network), "
+               "algorithm (pvs|mtdf|alphabeta), model (path)"
+            << std::endl;
+}
+
+// Sets one setting of a player, returning false if it is unknown
+bool ParsePlayerSetting(const std::string& setting, const std::string& value,
+                        player_config& config) {
+  if (setting == "depth") {
+    config.depth = std::stoul(value);
+  } else if (setting == "movetime") {
+    config.move_time_ms = std::stoul(value);
+  } else if (setting == "evaluator" && value == "threats") {
+    config.evaluator = Evaluator::Threats;
+  } else if (setting == "evaluator" && value == "network") {
+    config.evaluator = Evaluator::NeuralNetwork;
+  } else if (setting == "algorithm" && value == "pvs") {
+    config.algorithm = SearchAlgorithm::PrincipalVariation;
+  } else if (setting == "algorithm" && value == "mtdf") {
+    config.algorithm = SearchAlgorithm::Mtdf;
+  } else if (setting == "algorithm" && value == "alphabeta") {
+    config.algorithm = SearchAlgorithm::AlphaBeta;
+  } else if (setting == "model") {
+    config.model_path = value;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Whether a player's searches end before the end of the game
+bool IsLimited(const player_config& config) {
+  // Alpha-beta ignores time limits, so it always needs a depth
+  return config.depth > 0 ||
+         (config.move_time_ms > 0 &&
+          config.algorithm != SearchAlgorithm::AlphaBeta);
+}
+
+// Reads the flags, returning false if any are unknown or missing a value, or
+// a player would search every move to the end of the game
+bool ParseFlags(int argc, char *argv[], arena_flags& flags) {
+  const std::string kFirstPrefix = "--first-";
+  const std::string kSecondPrefix = "--second-";
+
+  for (int arg = 1; arg < argc; arg += 2) {
+    std::string flag = argv[arg];
+    if (arg + 1 >= argc) {
+      return false;
+    }
+    std::string value = argv[arg + 1];
+
+    if (flag.compare(0, kFirstPrefix.size(), kFirstPrefix) == 0) {
+      if (!ParsePlayerSetting(flag.substr(kFirstPrefix.size()), value,
+                              flags.first)) {
+        return false;
+      }
+    } else if (flag.compare(0, kSecondPrefix.size(), kSecondPrefix) == 0) {
+      if (!ParsePlayerSetting(flag.substr(kSecondPrefix.size()), value,
+                              flags.second)) {
+        return false;
+      }
+    } else if (flag == "--pairs") {
+      flags.options.number_game_pairs = std::stoul(value);
+    } else if (flag == "--threads") {
+      flags.options.number_threads = std::stoul(value);
+    } else if (flag == "--openings") {
+      flags.openings_path = value;
+    } else if (flag == "--opening-plies") {
+      flags.opening_plies = std::stoul(value);
+    } else if (flag == "--record") {
+      flags.options.record_path = value;
+    } else if (flag == "--sprt-elo0") {
+      flags.options.sprt.is_enabled = true;
+      flags.options.sprt.elo_0 = std::stod(value);
+    } else if (flag == "--sprt-elo1") {
+      flags.options.sprt.is_enabled = true;
+      flags.options.sprt.elo_1 = std::stod(value);
+    } else {
+      return false;
+    }
+  }
+  return IsLimited(flags.first) && IsLimited(flags.second);
+}
+
+// Reads one move string per line, ignoring blank lines
+bool ReadOpenings(const std::string& path,
+                  std::vector<std::string>& openings) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first != std::string::npos) {
+      size_t last = line.find_last_not_of(" \t\r");
+      openings.push_back(line.substr(first, last - first + 1));
+    }
+  }
+  return true;
+}
+
+void PrintStats(const arena_stats& stats,
+                const connect_four::sprt_options& sprt) {
+  std::cout << "Games: " << stats.GetNumberGames() << "  W/D/L: "
+            << stats.wins << "/" << stats.draws << "/" << stats.losses
+            << "  Elo: " << stats.CalculateEloDifference() << " +/- "
+            << stats.CalculateEloError();
+  if (sprt.is_enabled) {
+    std::cout << "  LLR: " << stats.CalculateLogLikelihoodRatio(sprt);
+  }
+  std::cout << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  // Plays two configurations against each other from balanced openings
+  // with colors swapped, to check that a change makes the computer stronger
+  arena_flags flags;
+  if (!ParseFlags(argc, argv, flags)) {
+    PrintUsage();
+    return 1;
+  }
+
+  if (!flags.openings_path.empty()) {
+    if (!ReadOpenings(flags.openings_path, flags.options.openings)) {
+      std::cout << "Can't read " << flags.openings_path << std::endl;
+      return 1;
+    }
+  } else {
+    flags.options.openings = Arena::GenerateOpenings(flags.opening_plies,
+                                                     kBalancedScore);
+  }
+  std::cout << "Playing up to " << flags.options.number_game_pairs
+            << " game pairs from " << flags.options.openings.size()
+            << " openings" << std::endl;
+
+  Arena arena(flags.first, flags.second);
+  size_t pairs_played = 0;
+  arena_stats stats = arena.Run(flags.options,
+                                [&](const arena_stats& progress) {
+    pairs_played++;
+    if (pairs_played % flags.report_interval == 0) {
+      PrintStats(progress, flags.options.sprt);
+    }
+  });
+
+  std::cout << "Finished in " << stats.seconds << " s" << std::endl;
+  PrintStats(stats, flags.options.sprt);
+  if (flags.options.sprt.is_enabled) {
+    SprtResult result = stats.CalculateSprtResult(flags.options.sprt);
+    if (result == SprtResult::AcceptH1) {
+      std::cout << "SPRT: H1 accepted, the first player is stronger"
+                << std::endl;
+    } else if (result == SprtResult::AcceptH0) {
+      std::cout << "SPRT: H0 accepted, the first player isn't stronger"
+                << std::endl;
+    } else {
+      std::cout << "SPRT: inconclusive" << std::endl;
+    }
+  }
+  return 0;
+}
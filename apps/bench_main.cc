@@ -0,0 +1,274 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <core/computer_agent.h>
+#include <core/search_bench.h>
+
+using connect_four::Computer;
+using connect_four::Evaluator;
+using connect_four::GameBoard;
+using connect_four::MoveList;
+using connect_four::SearchAlgorithm;
+using connect_four::SearchBench;
+using connect_four::bench_result;
+using connect_four::search_options;
+using connect_four::search_result;
+
+// Every allocation in the process goes through these, so benchmarks can
+// count how many allocations an operation makes
+std::atomic<size_t> allocation_count(0);
+
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+  std::free(memory);
+}
+
+namespace {
+
+// Positions as strings of zero-indexed columns, played from the empty
+// board, from the opening to the endgame
+const std::vector<std::string> kPositions = {
+    "",
+    "33322",
+    "3324453",
+    "334242",
+    "32334455",
+    "2344532",
+    "33333311",
+    "4432255",
+    "3152403",
+    "33332222444400",
+    "3333332222224444",
+    "3333332222224444006",
+};
+
+// Each benchmark runs for at least this long
+const double kMinimumSeconds = 0.2;
+
+// A struct storing the measurements of one benchmark
+struct benchmark_result {
+  std::string name;
+  size_t operations;
+  double seconds;
+  size_t allocations;
+  // Search nodes visited, 0 for benchmarks that don't search
+  size_t nodes;
+};
+
+// Keeps results of timed operations alive so they aren't optimized away
+volatile size_t sink = 0;
+
+/**
+ * Repeats a pass over the position set until enough time has passed.
+ * @param pass Runs the operation once per position, adding to the node
+ * count if it searches, and returns the number of operations it ran
+ */
+template <typename Pass>
+benchmark_result RunBenchmark(const std::string& name, Pass pass) {
+  benchmark_result result = {name, 0, 0, 0, 0};
+
+  // Warm up caches and lazily allocated buffers first
+  size_t warmup_nodes = 0;
+  pass(warmup_nodes);
+
+  size_t allocations_before = allocation_count.load();
+  auto start = std::chrono::steady_clock::now();
+  do {
+    result.operations += pass(result.nodes);
+    result.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+  } while (result.seconds < kMinimumSeconds);
+  result.allocations = allocation_count.load() - allocations_before;
+  return result;
+}
+
+void PrintTable(const std::vector<benchmark_result>& results) {
+  std::cout << "benchmark\tns/op\tallocs/op\tnodes/sec" << std::endl;
+  for (const benchmark_result& result : results) {
+    std::cout << result.name << "\t"
+              << result.seconds * 1e9 / result.operations << "\t"
+              << static_cast<double>(result.allocations) / result.operations
+              << "\t";
+    if (result.nodes != 0) {
+      std::cout << result.nodes / result.seconds;
+    } else {
+      std::cout << "-";
+    }
+    std::cout << std::endl;
+  }
+}
+
+void WriteJson(std::ostream& output,
+               const std::vector<benchmark_result>& results) {
+  output << "{\"benchmarks\":[";
+  for (size_t index = 0; index < results.size(); index++) {
+    const benchmark_result& result = results[index];
+    output << (index == 0 ? "" : ",")
+           << "{\"name\":\"" << result.name << "\""
+           << ",\"operations\":" << result.operations
+           << ",\"seconds\":" << result.seconds
+           << ",\"ns_per_op\":" << result.seconds * 1e9 / result.operations
+           << ",\"allocations_per_op\":"
+           << static_cast<double>(result.allocations) / result.operations
+           << ",\"nodes\":" << result.nodes
+           << ",\"nodes_per_sec\":" << result.nodes / result.seconds << "}";
+  }
+  output << "]}" << std::endl;
+}
+
+} // namespace
+
+// Prints the node count of a fixed-depth search over the bench positions,
+// which only changes when the search does, and the speed
+int RunSignature(size_t depth) {
+  Computer computer;
+  bench_result result = SearchBench(depth).Run(computer);
+  std::cout << "Positions: " << result.positions << std::endl
+            << "Depth: " << depth << std::endl
+            << "Seconds: " << result.seconds << std::endl
+            << "Nodes/second: "
+            << static_cast<size_t>(result.CalculateNodesPerSecond())
+            << std::endl
+            << "Nodes searched: " << result.nodes << std::endl;
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && std::string(argv[1]) == "signature") {
+    size_t depth = SearchBench::kDefaultDepth;
+    if (argc > 2) {
+      depth = std::stoul(argv[2]);
+    }
+    return RunSignature(depth);
+  }
+
+  // Times the core operations over a fixed position set, so runs can be
+  // compared across commits
+  std::string json_path;
+  size_t max_depth = 5;
+  for (int arg = 1; arg + 1 < argc; arg += 2) {
+    std::string flag = argv[arg];
+    if (flag == "--json") {
+      json_path = argv[arg + 1];
+    } else if (flag == "--max-depth") {
+      max_depth = std::stoul(argv[arg + 1]);
+    }
+  }
+  if (argc % 2 == 0) {
+    std::cout << "Usage: connect-four-bench [--json <path>] "
+                 "[--max-depth <depth>]" << std::endl
+              << "       connect-four-bench signature [depth]" << std::endl;
+    return 1;
+  }
+
+  std::vector<GameBoard> boards;
+  for (const std::string& moves : kPositions) {
+    boards.push_back(GameBoard::FromMoves(moves));
+  }
+  Computer computer;
+  std::vector<benchmark_result> results;
+
+  // UpdateGameState is private to GameBoard and runs at the end of every
+  // DropPiece, so it is timed as part of DropPiece
+  results.push_back(RunBenchmark("DropPiece", [&](size_t&) {
+    size_t operations = 0;
+    for (const GameBoard& board : boards) {
+      for (size_t col : board.CalculateValidColumns()) {
+        GameBoard copy = board;
+        sink = sink + copy.DropPiece(col);
+        operations++;
+      }
+    }
+    return operations;
+  }));
+
+  results.push_back(RunBenchmark("CalculateValidColumns", [&](size_t&) {
+    for (const GameBoard& board : boards) {
+      MoveList columns = board.CalculateValidColumns();
+      sink = sink + columns.size();
+    }
+    return boards.size();
+  }));
+
+  results.push_back(RunBenchmark("GenerateVectorFeatures", [&](size_t&) {
+    for (const GameBoard& board : boards) {
+      std::vector<float> features = board.GenerateVectorFeatures();
+      sink = sink + features.size();
+    }
+    return boards.size();
+  }));
+
+  results.push_back(RunBenchmark("FloatEvaluateBoard/network", [&](size_t&) {
+    for (const GameBoard& board : boards) {
+      float score = computer.FloatEvaluateBoard(board, board.GetIsXTurn(),
+                                                Evaluator::NeuralNetwork);
+      sink = sink + (score > 0);
+    }
+    return boards.size();
+  }));
+
+  results.push_back(RunBenchmark("FloatEvaluateBoard/threats", [&](size_t&) {
+    for (const GameBoard& board : boards) {
+      float score = computer.FloatEvaluateBoard(board, board.GetIsXTurn(),
+                                                Evaluator::Threats);
+      sink = sink + (score > 0);
+    }
+    return boards.size();
+  }));
+
+  // The alpha-beta driver is MiniMaxSearch with a full window, and counts
+  // the nodes it visits
+  for (size_t depth = 1; depth <= max_depth; depth++) {
+    std::string name = "MiniMaxSearch/depth" + std::to_string(depth);
+    results.push_back(RunBenchmark(name, [&](size_t& nodes) {
+      for (const GameBoard& board : boards) {
+        search_result result = computer.Search(
+            board, search_options(depth, SearchAlgorithm::AlphaBeta));
+        nodes += result.nodes;
+        sink = sink + result.column;
+      }
+      return boards.size();
+    }));
+  }
+
+  PrintTable(results);
+  if (!json_path.empty()) {
+    std::ofstream json(json_path);
+    if (!json.is_open()) {
+      std::cout << "Can't write " << json_path << std::endl;
+      return 1;
+    }
+    WriteJson(json, results);
+  }
+  return 0;
+}
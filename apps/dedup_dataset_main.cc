@@ -0,0 +1,44 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <core/data_parser.h>
+#include <core/deduplicator.h>
+
+using connect_four::DataFormat;
+using connect_four::DataStream;
+using connect_four::Deduplicator;
+
+int main(int argc, char *argv[]) {
+  // Merges duplicate positions across any number of datasets into one
+  // aggregated dataset with win/draw/loss counts per position
+  if (argc < 5 || (argc - 3) % 2 != 0) {
+    std::cout << "Usage: dedup-dataset <output path> <partition prefix> "
+                 "<csv path> <numeric|string> [<csv path> <numeric|string> "
+                 "...]" << std::endl;
+    return 1;
+  }
+
+  std::string output_path = argv[1];
+  std::string partition_prefix = argv[2];
+
+  auto start = std::chrono::steady_clock::now();
+  Deduplicator deduplicator(partition_prefix);
+  for (int arg = 3; arg < argc; arg += 2) {
+    DataFormat format = std::string(argv[arg + 1]) == "string"
+                            ? DataFormat::String
+                            : DataFormat::Numeric;
+    DataStream stream(argv[arg], format);
+    deduplicator.AddDataset(stream);
+  }
+  size_t number_read = deduplicator.GetNumberExamplesRead();
+  size_t number_unique = deduplicator.Finish(output_path);
+  auto end = std::chrono::steady_clock::now();
+
+  std::cout << "Read " << number_read << " examples, wrote " << number_unique
+            << " unique positions to " << output_path << " in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(
+                   end - start).count()
+            << " ms" << std::endl;
+  return 0;
+}
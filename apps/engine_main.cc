@@ -0,0 +1,20 @@
+#include <iostream>
+#include <string>
+
+#include <core/engine.h>
+
+int main() {
+  // Speaks the engine protocol over stdin and stdout, without any window,
+  // so the computer can run behind a game server
+  connect_four::Engine engine(std::cout);
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    if (!engine.HandleCommand(line)) {
+      return 0;
+    }
+  }
+
+  // The input closed, so let the last search finish
+  engine.Wait();
+  return 0;
+}
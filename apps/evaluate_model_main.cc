@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include <core/data_parser.h>
+#include <core/model_evaluator.h>
+#include <core/parallel_parser.h>
+
+using connect_four::DataFormat;
+using connect_four::ModelEvaluator;
+using connect_four::ParallelParser;
+using connect_four::ThreadPool;
+using connect_four::evaluation_result;
+using connect_four::example_buffer;
+
+int main(int argc, char *argv[]) {
+  // Scores a model on a test set, by default the whole CSV
+  if (argc < 4) {
+    std::cout << "Usage: evaluate-model <model path> <csv path> "
+                 "<numeric|string> [<threads>] [<first example>] "
+                 "[<number of examples>]" << std::endl;
+    return 1;
+  }
+
+  DataFormat format = std::string(argv[3]) == "string" ? DataFormat::String
+                                                       : DataFormat::Numeric;
+  size_t number_threads = argc > 4 ? std::stoul(argv[4]) : 0;
+  // Examples are one-indexed, like DataParser's start
+  size_t first = argc > 5 ? std::stoul(argv[5]) : 1;
+  size_t number_examples = argc > 6 ? std::stoul(argv[6]) : 0;
+
+  ModelEvaluator evaluator(argv[1], number_threads);
+  example_buffer buffer;
+  {
+    ThreadPool pool(number_threads);
+    ParallelParser(pool).Parse(argv[2], format, buffer);
+  }
+
+  // The examples are evaluated where they were parsed
+  size_t begin = std::min<size_t>(first == 0 ? 0 : first - 1,
+                                  buffer.labels.size());
+  size_t end = buffer.labels.size();
+  if (number_examples != 0) {
+    end = std::min(end, begin + number_examples);
+  }
+  evaluation_result result = evaluator.Evaluate(
+      buffer.features.data() + begin * ParallelParser::kNumberFeatures,
+      buffer.labels.data() + begin, end - begin);
+
+  std::cout << "Accuracy: " << result.number_correct << "/"
+            << result.number_examples << " (" << result.CalculateAccuracy()
+            << "%)" << std::endl;
+  std::cout << "Confusion (rows are labels, columns are predictions, "
+               "loss draw win):" << std::endl;
+  for (size_t label = 0; label < 3; label++) {
+    for (size_t predicted = 0; predicted < 3; predicted++) {
+      std::cout << "\t" << result.confusion[label][predicted];
+    }
+    std::cout << std::endl;
+  }
+  std::cout << evaluator.GetNumberThreads() << " threads, "
+            << result.seconds << " s";
+  if (result.seconds > 0) {
+    std::cout << ", " << result.number_examples / result.seconds
+              << " examples/sec";
+  }
+  std::cout << std::endl;
+  return 0;
+}
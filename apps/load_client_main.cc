@@ -0,0 +1,83 @@
+#include <iostream>
+#include <string>
+
+#include <core/load_generator.h>
+#include <core/socket.h>
+
+using connect_four::LoadGenerator;
+using connect_four::Socket;
+using connect_four::load_options;
+using connect_four::load_stats;
+
+namespace {
+
+void PrintUsage() {
+  std::cout << "Usage: connect-four-load [--address <unix:path|tcp:port>] "
+               "[--sessions <n>] [--games <n per session>]\n"
+               "             [--depth <plies>] [--movetime <ms>]"
+            << std::endl;
+}
+
+// Reads the flags, returning false if any are unknown or missing a value
+bool ParseFlags(int argc, char *argv[], load_options& options) {
+  for (int arg = 1; arg < argc; arg += 2) {
+    std::string flag = argv[arg];
+    if (arg + 1 >= argc) {
+      return false;
+    }
+    std::string value = argv[arg + 1];
+
+    if (flag == "--address") {
+      options.address = value;
+    } else if (flag == "--sessions") {
+      options.number_sessions = std::stoul(value);
+    } else if (flag == "--games") {
+      options.games_per_session = std::stoul(value);
+    } else if (flag == "--depth") {
+      options.depth = std::stoul(value);
+    } else if (flag == "--movetime") {
+      options.move_time_ms = std::stoul(value);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  // Plays games against a running server from many sessions at once and
+  // reports the latencies the clients saw, then the server's own stats
+  load_options options;
+  if (!ParseFlags(argc, argv, options)) {
+    PrintUsage();
+    return 1;
+  }
+
+  load_stats stats;
+  std::string server_stats;
+  try {
+    stats = LoadGenerator(options).Run();
+
+    Socket socket = Socket::Connect(options.address);
+    socket.WriteLine("stats");
+    socket.ReadLine(server_stats);
+    socket.WriteLine("quit");
+  } catch (const std::invalid_argument& error) {
+    std::cout << error.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "Played " << stats.games << " games with " << stats.requests
+            << " searches (" << stats.rejected_requests << " turned away) in "
+            << stats.seconds << " s, " << stats.CalculateRequestsPerSecond()
+            << " searches/sec" << std::endl;
+  std::cout << "Connections refused: " << stats.refused_connections
+            << std::endl;
+  std::cout << "Latency (ms): p50 " << stats.latency_p50_ms << "  p90 "
+            << stats.latency_p90_ms << "  p99 " << stats.latency_p99_ms
+            << "  max " << stats.latency_max_ms << std::endl;
+  std::cout << "Server: " << server_stats << std::endl;
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <core/data_parser.h>
+#include <core/mapped_file.h>
+#include <core/packed_dataset.h>
+#include <core/parallel_parser.h>
+#include <core/thread_pool.h>
+
+using connect_four::DataFormat;
+using connect_four::PackedDataset;
+
+double CalculateMilliseconds(std::chrono::steady_clock::time_point start,
+                             std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char *argv[]) {
+  // Converts a dataset CSV into the packed binary format, timing the
+  // parallel parse and loading the result back
+  if (argc < 4) {
+    std::cout << "Usage: pack-dataset <csv path> <numeric|string> "
+                 "<output path> [threads]" << std::endl;
+    return 1;
+  }
+
+  std::string csv_path = argv[1];
+  DataFormat format = std::string(argv[2]) == "string" ? DataFormat::String
+                                                       : DataFormat::Numeric;
+  std::string packed_path = argv[3];
+  size_t number_threads = 0;
+  if (argc > 4) {
+    number_threads = std::stoul(argv[4]);
+  }
+
+  connect_four::ThreadPool pool(number_threads);
+  connect_four::ParallelParser parser(pool);
+  connect_four::example_buffer buffer;
+
+  auto start = std::chrono::steady_clock::now();
+  parser.Parse(csv_path, format, buffer);
+  auto parsed = std::chrono::steady_clock::now();
+  size_t number_examples = PackedDataset::Convert(buffer, packed_path);
+  auto converted = std::chrono::steady_clock::now();
+
+  // Map the result and expand every example once
+  PackedDataset dataset(packed_path);
+  connect_four::DataParser expanded;
+  expanded.YieldTrainingData(dataset, 1, dataset.GetNumberExamples());
+  auto loaded = std::chrono::steady_clock::now();
+
+  double csv_megabytes =
+      connect_four::MappedFile(csv_path).GetSize() / (1024.0 * 1024.0);
+  double parse_ms = CalculateMilliseconds(start, parsed);
+
+  std::cout << "Packed " << number_examples << " examples into "
+            << packed_path << " ("
+            << number_examples * PackedDataset::kRecordSize << " bytes)"
+            << std::endl;
+  std::cout << "Parsing on " << pool.GetNumberThreads() << " threads: "
+            << parse_ms << " ms (" << csv_megabytes / (parse_ms / 1000)
+            << " MB/s)" << std::endl;
+  std::cout << "Writing: " << CalculateMilliseconds(parsed, converted)
+            << " ms" << std::endl;
+  std::cout << "Mapping and expanding: "
+            << CalculateMilliseconds(converted, loaded) << " ms" << std::endl;
+  return 0;
+}
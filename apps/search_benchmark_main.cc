@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <core/computer_agent.h>
+
+using connect_four::Computer;
+using connect_four::Evaluator;
+using connect_four::GameBoard;
+using connect_four::SearchAlgorithm;
+using connect_four::search_options;
+using connect_four::search_result;
+
+// Middle-game positions as strings of zero-indexed columns, played from the
+// empty board
+const std::vector<std::string> kPositions = {
+    "33322",
+    "3324453",
+    "334242",
+    "32334455",
+    "2344532",
+    "33333311",
+    "4432255",
+    "3152436",
+};
+
+int main(int argc, char *argv[]) {
+  // Compare the search drivers on the same positions and depths, optionally
+  // with the threat evaluator instead of the network
+  size_t max_depth = 7;
+  if (argc > 1) {
+    max_depth = std::stoul(argv[1]);
+  }
+  Evaluator evaluator = Evaluator::NeuralNetwork;
+  if (argc > 2 && std::string(argv[2]) == "threats") {
+    evaluator = Evaluator::Threats;
+  }
+
+  const std::vector<std::string> kNames = {"alpha-beta", "pvs", "mtd(f)"};
+  const std::vector<SearchAlgorithm> kAlgorithms = {
+      SearchAlgorithm::AlphaBeta,
+      SearchAlgorithm::PrincipalVariation,
+      SearchAlgorithm::Mtdf};
+
+  Computer computer;
+
+  std::cout << "depth\talgorithm\tnodes\tms\tmismatches" << std::endl;
+  for (size_t depth = 1; depth <= max_depth; depth++) {
+    // Scores from plain alpha-beta, which the other drivers should match
+    std::vector<float> reference_scores;
+
+    for (size_t index = 0; index < kAlgorithms.size(); index++) {
+      size_t nodes = 0;
+      size_t mismatches = 0;
+      std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+
+      for (size_t position = 0; position < kPositions.size(); position++) {
+        GameBoard board = GameBoard::FromMoves(kPositions[position]);
+        search_result result = computer.Search(
+            board, search_options(depth, kAlgorithms[index], evaluator));
+        nodes += result.nodes;
+
+        if (index == 0) {
+          reference_scores.push_back(result.score);
+        } else if (std::fabs(result.score - reference_scores[position]) >
+                   computer.kNullWindow) {
+          mismatches++;
+        }
+      }
+
+      std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+      std::cout << depth << "\t" << kNames[index] << "\t" << nodes << "\t"
+                << elapsed.count() << "\t" << mismatches << std::endl;
+    }
+  }
+  return 0;
+}
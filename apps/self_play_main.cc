@@ -0,0 +1,48 @@
+#include <iostream>
+#include <string>
+
+#include <core/self_play.h>
+
+using connect_four::Evaluator;
+using connect_four::SelfPlay;
+using connect_four::self_play_options;
+using connect_four::self_play_stats;
+
+int main(int argc, char *argv[]) {
+  // Plays the computer against itself and writes every position, labeled
+  // with the game's result, as packed dataset shards
+  if (argc < 3) {
+    std::cout << "Usage: self-play <output prefix> <games> [<threads>] "
+                 "[<depth>] [<root noise>] [network|threats]" << std::endl;
+    return 1;
+  }
+
+  self_play_options options;
+  options.number_games = std::stoul(argv[2]);
+  if (argc > 3) {
+    options.number_threads = std::stoul(argv[3]);
+  }
+  if (argc > 4) {
+    options.depth = std::stoul(argv[4]);
+  }
+  if (argc > 5) {
+    options.root_noise = std::stof(argv[5]);
+  }
+  if (argc > 6 && std::string(argv[6]) == "network") {
+    options.evaluator = Evaluator::NeuralNetwork;
+  }
+
+  SelfPlay self_play(options);
+  self_play_stats stats = self_play.Run(argv[1]);
+
+  std::cout << "Played " << stats.games << " games (" << stats.x_wins
+            << " X wins, " << stats.draws << " draws, " << stats.o_wins
+            << " O wins) with " << stats.positions << " positions in "
+            << stats.seconds << " s" << std::endl;
+  if (stats.seconds > 0) {
+    std::cout << stats.games / stats.seconds << " games/sec, "
+              << stats.positions / stats.seconds << " positions/sec"
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include <csignal>
+#include <iostream>
+#include <string>
+
+#include <pthread.h>
+
+#include <core/server.h>
+
+using connect_four::Evaluator;
+using connect_four::Server;
+using connect_four::server_options;
+
+namespace {
+
+void PrintUsage() {
+  std::cout << "Usage: connect-four-server [--address <unix:path|tcp:port>] "
+               "[--threads <n>] [--max-sessions <n>] [--max-queue <n>]\n"
+               "             [--movetime <ms>] [--max-movetime <ms>] "
+               "[--tables <n>] [--table-size <log2 entries>] "
+               "[--evaluator <threats|network>]"
+            << std::endl;
+}
+
+// Reads the flags, returning false if any are unknown or missing a value
+bool ParseFlags(int argc, char *argv[], server_options& options) {
+  for (int arg = 1; arg < argc; arg += 2) {
+    std::string flag = argv[arg];
+    if (arg + 1 >= argc) {
+      return false;
+    }
+    std::string value = argv[arg + 1];
+
+    if (flag == "--address") {
+      options.address = value;
+    } else if (flag == "--threads") {
+      options.number_threads = std::stoul(value);
+    } else if (flag == "--max-sessions") {
+      options.max_sessions = std::stoul(value);
+    } else if (flag == "--max-queue") {
+      options.max_queue_depth = std::stoul(value);
+    } else if (flag == "--movetime") {
+      options.default_move_time_ms = std::stoul(value);
+    } else if (flag == "--max-movetime") {
+      options.max_move_time_ms = std::stoul(value);
+    } else if (flag == "--tables") {
+      options.max_tables = std::stoul(value);
+    } else if (flag == "--table-size") {
+      options.table_size_log2 = std::stoul(value);
+    } else if (flag == "--evaluator" && value == "threats") {
+      options.evaluator = Evaluator::Threats;
+    } else if (flag == "--evaluator" && value == "network") {
+      options.evaluator = Evaluator::NeuralNetwork;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  // Serves concurrent game sessions on a local socket until interrupted
+  server_options options;
+  if (!ParseFlags(argc, argv, options)) {
+    PrintUsage();
+    return 1;
+  }
+
+  // Block the stop signals before any thread starts, so every thread
+  // inherits the mask and this one alone waits for them
+  sigset_t stop_signals;
+  sigemptyset(&stop_signals);
+  sigaddset(&stop_signals, SIGINT);
+  sigaddset(&stop_signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+
+  Server server(options);
+  try {
+    server.Start();
+  } catch (const std::invalid_argument& error) {
+    std::cout << error.what() << std::endl;
+    return 1;
+  }
+  std::cout << "Listening on " << server.GetAddress() << std::endl;
+
+  int signal_number;
+  sigwait(&stop_signals, &signal_number);
+  std::cout << server.GetStats().Format() << std::endl;
+  server.Stop();
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <string>
+
+#include <core/data_parser.h>
+#include <core/solver.h>
+
+using connect_four::DataFormat;
+using connect_four::DataStream;
+using connect_four::DatasetSolver;
+using connect_four::dataset_solver_options;
+using connect_four::dataset_solver_stats;
+
+int main(int argc, char *argv[]) {
+  // Relabels a dataset with the exact result of every position, resuming
+  // from the output's checkpoint if a previous run was interrupted
+  if (argc < 4) {
+    std::cout << "Usage: solve-dataset <csv path> <numeric|string> "
+                 "<output path> [<threads>] [<table size log2>]" << std::endl;
+    return 1;
+  }
+
+  DataFormat format = std::string(argv[2]) == "string" ? DataFormat::String
+                                                       : DataFormat::Numeric;
+  dataset_solver_options options;
+  if (argc > 4) {
+    options.number_threads = std::stoul(argv[4]);
+  }
+  if (argc > 5) {
+    options.table_size_log2 = std::stoul(argv[5]);
+  }
+
+  // Resuming seeks far into the CSV, so use the sidecar index
+  DataStream stream(argv[1], format);
+  stream.LoadOrBuildIndex(1000);
+
+  DatasetSolver solver(options);
+  dataset_solver_stats stats = solver.Run(stream, argv[3]);
+
+  if (stats.first_example > 1) {
+    std::cout << "Resumed from example " << stats.first_example << std::endl;
+  }
+  std::cout << "Solved " << stats.examples_solved << " positions ("
+            << stats.examples_skipped << " invalid skipped) in "
+            << stats.seconds << " s" << std::endl;
+  if (stats.seconds > 0) {
+    std::cout << stats.examples_solved / stats.seconds << " positions/sec, "
+              << stats.nodes / stats.seconds << " nodes/sec" << std::endl;
+  }
+  return 0;
+}
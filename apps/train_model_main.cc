@@ -1,64 +1,291 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <string>
+#include <thread>
 
 #include "tiny_dnn/tiny_dnn.h"
+#include <core/batch_loader.h>
+#include <core/data_parallel_trainer.h>
 #include <core/data_parser.h>
+#include <core/minibatch_sampler.h>
+#include <core/parallel_parser.h>
+#include <core/persistent_adam.h>
+#include <core/run_log.h>
+#include <core/training_checkpoint.h>
+#include <core/thread_pool.h>
 
 using namespace tiny_dnn;
 using namespace tiny_dnn::activation;
 using namespace tiny_dnn::layers;
 
+namespace {
+
+// A struct storing the settings given on the command line
+struct training_flags {
+  size_t epochs = 4;
+  float learning_rate = 0.001f;
+  // Threads parsing the training set and training each minibatch, 0 for
+  // one per hardware thread
+  size_t threads = 0;
+  size_t batch_size = 64;
+  unsigned int seed = 0;
+  // Whether each example served is mirrored with probability one half
+  bool is_mirrored = true;
+  std::string log_path = "train_log.jsonl";
+  // The best model by test accuracy is kept here
+  std::string model_path = "net_2";
+  std::string checkpoint_path = "train_checkpoint";
+  // Chunks of minibatches between checkpoints, besides one every epoch
+  size_t checkpoint_interval = 50;
+  bool is_resuming = false;
+};
+
+void PrintUsage() {
+  std::cout << "Usage: train-model [--epochs <n>] [--lr <rate>] "
+               "[--threads <n>] [--batch-size <n>] [--seed <n>] "
+               "[--log <path>] [--model <path>] [--checkpoint <path>] "
+               "[--checkpoint-every <chunks>] [--resume <checkpoint path>]"
+            << std::endl;
+}
+
+network<sequential> CreateNetwork() {
+  network<sequential> net;
+  net << fully_connected_layer(42,128) << relu()
+      << fully_connected_layer(128,64) << relu()
+      << fully_connected_layer(64,3) << softmax();
+  return net;
+}
+
+// Reads the flags, returning false if any are unknown or missing a value
+bool ParseFlags(int argc, char *argv[], training_flags& flags) {
+  for (int arg = 1; arg < argc; arg += 2) {
+    std::string flag = argv[arg];
+    if (arg + 1 >= argc) {
+      return false;
+    }
+    std::string value = argv[arg + 1];
+
+    if (flag == "--epochs") {
+      flags.epochs = std::stoul(value);
+    } else if (flag == "--lr") {
+      flags.learning_rate = std::stof(value);
+    } else if (flag == "--threads") {
+      flags.threads = std::stoul(value);
+    } else if (flag == "--batch-size") {
+      flags.batch_size = std::stoul(value);
+    } else if (flag == "--seed") {
+      flags.seed = static_cast<unsigned int>(std::stoul(value));
+    } else if (flag == "--log") {
+      flags.log_path = value;
+    } else if (flag == "--model") {
+      flags.model_path = value;
+    } else if (flag == "--checkpoint") {
+      flags.checkpoint_path = value;
+    } else if (flag == "--checkpoint-every") {
+      flags.checkpoint_interval = std::stoul(value);
+    } else if (flag == "--resume") {
+      flags.checkpoint_path = value;
+      flags.is_resuming = true;
+    } else {
+      return false;
+    }
+  }
+  return flags.batch_size > 0;
+}
+
+} // namespace
+
 int main(int argc, char *argv[]) {
   // Tutorial: https://gist.github.com/marty1885/dd648a1806348bf4cd2c2fd0feafae36
-  std::cout << "Hi!" << std::endl;
+  training_flags flags;
+  if (!ParseFlags(argc, argv, flags)) {
+    PrintUsage();
+    return 1;
+  }
+  if (flags.threads == 0) {
+    flags.threads = std::max(1u, std::thread::hardware_concurrency());
+  }
 
   connect_four::DataParser parser;
   parser.YieldTestDataNumericCSV("data/c4_game_database.csv", 1,
                           1640);
   parser.YieldTestDataStringCSV("data/connect-4.data", 1,
                            1557);
-  std::vector<tiny_dnn::vec_t> testIn = parser.GetTestFeatures();
-  std::vector<tiny_dnn::label_t> testOut = parser.GetTestLabels();
+  const std::vector<tiny_dnn::vec_t>& testIn = parser.GetTestFeatures();
+  const std::vector<tiny_dnn::label_t>& testOut = parser.GetTestLabels();
 
-  network<sequential> net;
-  net << fully_connected_layer(42,128) << relu()
-      << fully_connected_layer(128,64) << relu()
-      << fully_connected_layer(64,3) << softmax();
+  network<sequential> net = CreateNetwork();
+  // Splits each minibatch across the threads, with a replica of the
+  // network on each. It initializes the network, so it comes before any
+  // checkpoint is loaded.
+  connect_four::DataParallelTrainer trainer(net, CreateNetwork,
+                                            flags.threads);
 
-  adam optimizer;
+  // Keeps its moments across the chunks below
+  connect_four::PersistentAdam optimizer;
+  optimizer.alpha = flags.learning_rate;
 
-  // Train and validate the model (375000 training examples)
-  // Number of loops through the entire training dataset
-  size_t epochs = 4;
+  // Resuming restores the network, the optimizer and where training was
+  connect_four::TrainingCheckpoint checkpoint(flags.checkpoint_path);
+  connect_four::training_state state;
+  state.batch_size = flags.batch_size;
+  state.seed = flags.seed;
+  state.is_mirrored = flags.is_mirrored;
+  if (flags.is_resuming) {
+    if (!checkpoint.Load(net, optimizer, state)) {
+      std::cout << "No checkpoint at " << flags.checkpoint_path << std::endl;
+      return 1;
+    }
+    // The same minibatches have to follow the position, so the sampler
+    // shuffles and mirrors the way it did before
+    flags.batch_size = state.batch_size;
+    flags.seed = state.seed;
+    flags.is_mirrored = state.is_mirrored;
+    std::cout << "Resuming epoch " << state.epoch << " after "
+              << state.position << " examples with seed " << state.seed
+              << std::endl;
+  }
+
+  // Load the whole training set once, packed so it fits in memory many
+  // times over. Use 24 to 375 for c4_game_database, first 1640 positions as
+  // test. For connect-4.data, everything after the test positions.
+  connect_four::MinibatchSampler sampler(flags.seed);
+  sampler.SetMirrorAugmentation(flags.is_mirrored);
+  {
+    connect_four::ThreadPool pool(flags.threads);
+    connect_four::ParallelParser csv_parser(pool);
+    connect_four::example_buffer buffer;
+    csv_parser.Parse("data/c4_game_database.csv",
+                     connect_four::DataFormat::Numeric, buffer);
+    sampler.AddExamples(buffer, 1640 + 24 * 1000 - 1, buffer.labels.size());
+    csv_parser.Parse("data/connect-4.data", connect_four::DataFormat::String,
+                     buffer);
+    sampler.AddExamples(buffer, 1557 - 1, buffer.labels.size());
+  }
+  std::cout << "Training on " << sampler.GetNumberExamples() << " examples"
+            << std::endl;
+
+  // Each Train call covers a chunk of minibatches, so the loader can
+  // prepare the next chunk meanwhile.
+  const size_t kMinibatchesPerChunk = 64;
+  size_t chunk_size = kMinibatchesPerChunk * flags.batch_size;
+  size_t chunks_per_epoch = (sampler.GetNumberExamples() + chunk_size - 1) /
+                            chunk_size;
+  size_t first_chunk = state.position / chunk_size;
 
-  for (size_t epoch = 0; epoch < epochs; epoch++) {
+  // The sampler is only touched by the loader thread from here on. Epochs
+  // always shuffle the same way, so starting one again is harmless.
+  sampler.StartEpoch(state.epoch);
+  sampler.Seek(first_chunk * chunk_size);
+  size_t chunks_loaded = state.epoch * chunks_per_epoch + first_chunk;
+  connect_four::BatchLoader loader([&](connect_four::training_batch& batch) {
+    if (chunks_loaded >= flags.epochs * chunks_per_epoch) {
+      return false;
+    }
+    if (chunks_loaded % chunks_per_epoch == 0) {
+      sampler.StartEpoch(chunks_loaded / chunks_per_epoch);
+    }
+    chunks_loaded++;
+    return sampler.Next(chunk_size, batch);
+  });
+
+  // Loss is measured on the start of each chunk after training on it, since
+  // a forward pass over the whole chunk would cost a third of the step
+  const size_t kLossExamples = 1024;
+  connect_four::RunLog run_log(flags.log_path, flags.is_resuming);
+
+  connect_four::training_batch batch;
+  for (size_t epoch = state.epoch; epoch < flags.epochs; epoch++) {
     std::cout << "Epoch: " << epoch << std::endl;
     std::cout << "Training..." << std::endl;
+    loader.ResetStallTime();
+    auto epoch_start = std::chrono::steady_clock::now();
+    size_t epoch_examples = 0;
+
+    size_t start_chunk = epoch == state.epoch ? first_chunk : 0;
+    for (size_t chunk = start_chunk; chunk < chunks_per_epoch; chunk++) {
+      if (chunk % 10 == 0) {
+        std::cout << "Step: " << chunk * kMinibatchesPerChunk << std::endl;
+      }
 
-    // Use 24 to 375 for c4_game_database, first 1640 positions as test
-    // For connect-4.data, there are 66000 training positions
-    for (size_t batch = 0; batch < 66; batch++) {
-      if (batch % 10 == 0) {
-        std::cout << "Step: " << batch << std::endl;
+      connect_four::step_record step;
+      step.epoch = epoch;
+      step.step = chunk;
+      double stall_before = loader.GetStallSeconds();
+      if (!loader.Next(batch)) {
+        break;
       }
+      step.stall_seconds = loader.GetStallSeconds() - stall_before;
+      step.load_seconds = loader.GetLoadSeconds();
+      step.examples = batch.features.size();
 
-      parser.Clear();
-      parser.YieldTrainingDataNumericCSV("data/c4_game_database.csv",
-                                   1640 + (24 + batch) * 1000,
-                                   1000);
-      parser.YieldTrainingDataStringCSV("data/connect-4.data",
-                                   1557 + batch * 1000,
-                            1000);
-      std::vector<tiny_dnn::vec_t> trainIn = parser.GetTrainFeatures();
-      std::vector<tiny_dnn::label_t> trainOut = parser.GetTrainLabels();
-      size_t batch_size = trainIn.size();
-      net.train<cross_entropy>(optimizer, trainIn, trainOut, batch_size, 1);
+      auto train_start = std::chrono::steady_clock::now();
+      trainer.Train(optimizer, batch.features, batch.labels,
+                    flags.batch_size);
+      step.train_seconds = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - train_start).count();
+
+      size_t loss_examples = std::min(kLossExamples, batch.features.size());
+      std::vector<tiny_dnn::vec_t> loss_features(
+          batch.features.begin(), batch.features.begin() + loss_examples);
+      std::vector<tiny_dnn::label_t> loss_labels(
+          batch.labels.begin(), batch.labels.begin() + loss_examples);
+      step.loss = net.get_loss<cross_entropy>(loss_features, loss_labels) /
+                  loss_examples;
+
+      run_log.LogStep(step);
+      epoch_examples += step.examples;
+
+      if (flags.checkpoint_interval != 0 &&
+          (chunk + 1) % flags.checkpoint_interval == 0 &&
+          chunk + 1 < chunks_per_epoch) {
+        state.epoch = epoch;
+        state.position = (chunk + 1) * chunk_size;
+        checkpoint.Save(net, optimizer, state);
+      }
     }
 
+    // Time the trainer spent waiting for data instead of training
+    std::cout << "Loader stall: " << loader.GetStallSeconds() << " s"
+              << std::endl;
+
     std::cout << "Testing..." << std::endl;
     result res = net.test(testIn, testOut);
     std::cout << res.num_success << "/" << res.num_total << std::endl;
-  }
 
-  net.save("net_2");
+    connect_four::epoch_record record;
+    record.epoch = epoch;
+    record.examples = epoch_examples;
+    record.test_accuracy = res.accuracy();
+    record.epoch_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - epoch_start).count();
+    run_log.LogEpoch(record);
+
+    // A worse epoch never replaces a better model
+    if (res.accuracy() > state.best_accuracy) {
+      state.best_accuracy = res.accuracy();
+      // Written beside the model and renamed over it, so a crash mid-save
+      // leaves the previous best model whole
+      std::string temporary_path = flags.model_path + ".tmp";
+      net.save(temporary_path);
+#ifdef _WIN32
+      // Windows won't rename over an existing file
+      std::remove(flags.model_path.c_str());
+#endif
+      if (std::rename(temporary_path.c_str(),
+                      flags.model_path.c_str()) != 0) {
+        std::cout << "Can't save the model to " << flags.model_path
+                  << std::endl;
+        return 1;
+      }
+      std::cout << "Saved best model to " << flags.model_path << std::endl;
+    }
+
+    state.epoch = epoch + 1;
+    state.position = 0;
+    checkpoint.Save(net, optimizer, state);
+  }
   return 0;
 }
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <core/computer_agent.h>
+#include <core/game_record.h>
+#include <core/gameboard.h>
+
+namespace connect_four {
+
+// A struct storing how one side of a match searches
+struct player_config {
+  // 0 to search until the end of the game, which needs a time limit
+  size_t depth;
+  // The longest a move is searched, 0 for no limit. The first depth always
+  // completes.
+  size_t move_time_ms;
+  SearchAlgorithm algorithm;
+  Evaluator evaluator;
+  std::string model_path;
+
+  player_config() : depth(6), move_time_ms(0),
+      algorithm(SearchAlgorithm::PrincipalVariation),
+      evaluator(Evaluator::Threats),
+      model_path(Computer::kDefaultModelPath) {};
+};
+
+// A struct storing a sequential probability ratio test of whether the first
+// player is elo_1 stronger rather than elo_0 stronger
+struct sprt_options {
+  bool is_enabled;
+  double elo_0;
+  double elo_1;
+  // The chances of accepting elo_1 when elo_0 is true, and the reverse
+  double alpha;
+  double beta;
+
+  sprt_options() : is_enabled(false), elo_0(0), elo_1(10), alpha(0.05),
+      beta(0.05) {};
+};
+
+// The outcomes of a sequential probability ratio test
+enum class SprtResult {
+  // Keep playing
+  Continue,
+  // The first player is elo_1 stronger
+  AcceptH1,
+  // The first player is at most elo_0 stronger
+  AcceptH0,
+};
+
+// A struct storing the results of a match from the first player's
+// perspective
+struct arena_stats {
+  size_t wins;
+  size_t draws;
+  size_t losses;
+  double seconds;
+
+  arena_stats() : wins(0), draws(0), losses(0), seconds(0) {};
+
+  size_t GetNumberGames() const;
+
+  /**
+   * @return The average points per game, 1 for a win and 0.5 for a draw.
+   */
+  double CalculateScore() const;
+
+  /**
+   * @return The Elo difference that the score implies, 0 without games.
+   */
+  double CalculateEloDifference() const;
+
+  /**
+   * @return Half the width of the 95% confidence interval of the Elo
+   * difference, 0 until there are both better and worse results than the
+   * mean.
+   */
+  double CalculateEloError() const;
+
+  /**
+   * @return The log likelihood ratio of elo_1 against elo_0, with the
+   * normal approximation used by engine testing frameworks. 0 without
+   * games.
+   */
+  double CalculateLogLikelihoodRatio(const sprt_options& sprt) const;
+
+  /**
+   * @return Whether the test has reached a decision.
+   */
+  SprtResult CalculateSprtResult(const sprt_options& sprt) const;
+};
+
+// A struct storing the settings of a match
+struct arena_options {
+  // Each opening is played twice, once with each player moving first, and
+  // game pairs go through the openings in turn
+  size_t number_game_pairs;
+  // 0 for one worker per hardware thread
+  size_t number_threads;
+  // Strings of zero-indexed columns, played from the empty board
+  std::vector<std::string> openings;
+  sprt_options sprt;
+  // Where to record the games, empty for nowhere. Each pair is recorded
+  // together, with the first player as X in the first game.
+  std::string record_path;
+
+  arena_options() : number_game_pairs(100), number_threads(0) {};
+};
+
+/**
+ * Plays games between two player configurations to measure which is
+ * stronger. Game pairs run concurrently on a thread pool, and each worker
+ * has a Computer for each player, since the players may use different
+ * models. Since both players search deterministically, each opening is
+ * played once with each color, and variety comes from the openings.
+ */
+class Arena {
+ public:
+  /**
+   * @param first The player results are reported for
+   * @param second The opponent
+   */
+  Arena(const player_config& first, const player_config& second);
+
+  /**
+   * Plays the match, stopping early once the test reaches a decision.
+   * @param on_pair Called after each game pair with the totals so far, on
+   * one thread at a time. May be empty.
+   * @return The totals of the match.
+   * @throw invalid_argument exception if there are no openings, one can't
+   * be played or the games can't be recorded
+   */
+  arena_stats Run(const arena_options& options,
+                  const std::function<void(const arena_stats&)>& on_pair =
+                      nullptr) const;
+
+  /**
+   * Plays one game from an opening.
+   * @param first_computer The Computer of the first player
+   * @param second_computer The Computer of the second player
+   * @param is_first_x Whether the first player plays X, who moves first
+   * @param record If not null, the moves played are appended to it and its
+   * result is set
+   * @return The final state of the game.
+   */
+  BoardState PlayGame(Computer& first_computer, Computer& second_computer,
+                      const GameBoard& opening, bool is_first_x,
+                      game_record* record = nullptr) const;
+
+  /**
+   * Finds every position a number of plies from the empty board that a
+   * shallow search with the threat evaluator scores as close to even. Only
+   * one of each pair of mirror images is kept.
+   * @param plies The number of moves in each opening
+   * @param max_score The largest score either side may have, from -1 to 1
+   * @return Move strings in a fixed order.
+   */
+  static std::vector<std::string> GenerateOpenings(size_t plies,
+                                                   float max_score);
+
+ private:
+  player_config first_;
+  player_config second_;
+
+  /**
+   * Searches for a player's move with its limits.
+   */
+  static size_t ChooseMove(Computer& computer, const player_config& config,
+                           const GameBoard& board);
+};
+
+} // namespace connect_four
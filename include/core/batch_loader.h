@@ -0,0 +1,95 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tiny_dnn/tiny_dnn.h"
+
+namespace connect_four {
+
+// A struct storing one batch of training examples
+struct training_batch {
+  std::vector<tiny_dnn::vec_t> features;
+  std::vector<tiny_dnn::label_t> labels;
+};
+
+/**
+ * Prepares batches on a background thread, one ahead of the trainer, so
+ * loading batch k + 1 overlaps training on batch k. Batches are handed over
+ * by moving them, never by copying.
+ */
+class BatchLoader {
+ public:
+  /**
+   * Fills a batch on the loader thread.
+   * @return False once there are no more batches.
+   */
+  typedef std::function<bool(training_batch&)> BatchSource;
+
+  /**
+   * Starts the loader thread, which begins preparing the first batch.
+   * @param source Called on the loader thread for each batch in order
+   */
+  explicit BatchLoader(BatchSource source);
+
+  /**
+   * Stops the loader thread once the batch it is preparing is done.
+   */
+  ~BatchLoader();
+
+  BatchLoader(const BatchLoader&) = delete;
+  BatchLoader& operator=(const BatchLoader&) = delete;
+
+  /**
+   * Waits for the next batch if it isn't ready yet and moves it out.
+   * @param batch Replaced with the next batch
+   * @return False once the source has no more batches.
+   * @throw Whatever the source threw while preparing the batch
+   */
+  bool Next(training_batch& batch);
+
+  /**
+   * @return The total time Next spent waiting for the loader, in seconds.
+   */
+  double GetStallSeconds() const;
+
+  /**
+   * Starts counting stall time from zero, for example at a new epoch.
+   */
+  void ResetStallTime();
+
+  /**
+   * @return The time the source took to prepare the batch last returned by
+   * Next, in seconds.
+   */
+  double GetLoadSeconds() const;
+
+ private:
+  BatchSource source_;
+  // The prepared batch waiting for the trainer, while the loader thread
+  // fills the next one
+  training_batch ready_batch_;
+  bool is_ready_;
+  bool is_finished_;
+  bool is_stopping_;
+  std::exception_ptr error_;
+  double stall_seconds_;
+  // Preparation times of the ready batch and of the batch last handed over
+  double ready_load_seconds_;
+  double load_seconds_;
+
+  std::mutex mutex_;
+  std::condition_variable state_changed_;
+  std::thread loader_;
+
+  /**
+   * Prepares batches until the source runs out or the loader is stopped.
+   */
+  void RunLoader();
+};
+
+} // namespace connect_four
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
 #include <core/gameboard.h>
+#include <core/threat_evaluator.h>
+#include <core/transposition_table.h>
 
 #include "tiny_dnn/tiny_dnn.h"
 
@@ -14,6 +22,68 @@ struct move_evaluation_pair {
   move_evaluation_pair(size_t col, float val) : column(col), score(val) {};
 };
 
+// A struct storing the result of a full search: the best column, its
+// evaluation, the principal variation starting with that column, the number
+// of nodes visited and the depth of the last complete iteration
+struct search_result {
+  size_t column;
+  float score;
+  std::vector<size_t> principal_variation;
+  size_t nodes;
+  size_t depth;
+
+  search_result() : column(0), score(0), nodes(0), depth(0) {};
+};
+
+// The algorithms Computer can search with
+enum class SearchAlgorithm {
+  // MiniMaxSearch with a full alpha-beta window
+  AlphaBeta,
+  // Negamax principal variation search with aspiration windows
+  PrincipalVariation,
+  // MTD(f) over null-window searches backed by the transposition table
+  Mtdf,
+};
+
+// The evaluators Computer can score leaves with
+enum class Evaluator {
+  // The tiny_dnn model, slower but more accurate
+  NeuralNetwork,
+  // ThreatEvaluator, fast enough to search deeper in the same time
+  Threats,
+};
+
+// A struct storing the settings of a single search
+struct search_options {
+  size_t depth;
+  SearchAlgorithm algorithm;
+  Evaluator evaluator;
+  // Once set, the iterative drivers give up on the iteration they're in and
+  // return the last complete one. The first iteration always completes, so
+  // there is a move to play. Ignored by AlphaBeta. May be null.
+  const std::atomic<bool>* stop;
+  // Stops the iterative drivers like the stop flag once the clock passes
+  // it. Never by default.
+  std::chrono::steady_clock::time_point deadline;
+  // Called by the iterative drivers with the result after each complete
+  // iteration. May be empty.
+  std::function<void(const search_result&)> on_iteration;
+  // The table MTD(f) keeps its bounds in. The computer's own table is
+  // cleared before each search, while a table passed in keeps what earlier
+  // searches learned, so it must only be shared by searches with the same
+  // evaluator. May be null.
+  TranspositionTable* table;
+
+  explicit search_options(size_t max_depth,
+                          SearchAlgorithm search_algorithm =
+                              SearchAlgorithm::PrincipalVariation,
+                          Evaluator leaf_evaluator = Evaluator::NeuralNetwork) :
+      depth(max_depth), algorithm(search_algorithm),
+      evaluator(leaf_evaluator), stop(nullptr),
+      deadline(std::chrono::steady_clock::time_point::max()),
+      table(nullptr) {};
+};
+
 /**
  * A computer model to evaluate connect four positions and suggest the
  * best moves using the minimax search algorithm with alpha-beta pruning.
@@ -25,11 +95,26 @@ class Computer {
   const float kWinLossValue = 10;
   // Set above WinLossValue
   const float kAlphaBeta = 100;
+  // Half-width of the root aspiration window around the previous iteration
+  const float kAspirationWindow = 0.25f;
+  // Width of the null windows used to test moves after the first
+  const float kNullWindow = 0.0001f;
+  // Width of the windows MTD(f) tests its guesses with
+  const float kMtdfWindow = 0.01f;
+  // No game lasts longer than the number of cells
+  static constexpr size_t kMaxPly = GameBoard::kWidth * GameBoard::kHeight;
+  // Reading the clock costs more than a node, so the deadline is only
+  // checked every this many nodes
+  static constexpr size_t kDeadlineInterval = 1024;
+
+  // The model loaded unless another is given
+  static constexpr const char* kDefaultModelPath = "net_2";
 
   /**
-   * Loads the default model.
+   * Loads a model.
+   * @param model_path The path of a model saved by network::save
    */
-  Computer();
+  explicit Computer(const std::string& model_path = kDefaultModelPath);
 
   /**
    * Gives an evaluation from -1 to 1 from the specified player's perspective.
@@ -41,6 +126,18 @@ class Computer {
   float FloatEvaluateBoard(const GameBoard& board,
                            bool is_x_perspective);
 
+  /**
+   * Gives an evaluation from -1 to 1 from the specified player's perspective
+   * with the chosen evaluator. A position and its mirror image always get
+   * the same evaluation, so they can share transposition table entries.
+   * @param board A constant board reference
+   * @param is_x_perspective Whether the score is from X's perspective
+   * @param evaluator The evaluator to score the board with
+   * @return A float value from -1 to 1 representing the evaluation.
+   */
+  float FloatEvaluateBoard(const GameBoard& board, bool is_x_perspective,
+                           Evaluator evaluator);
+
   /**
    * Gives the loss draw win probabilities of a position.
    */
@@ -61,8 +158,164 @@ class Computer {
                                      bool is_computer_x,
                                      bool maximizing_player);
 
+  /**
+   * Given a board, use iterative deepening negamax principal variation search
+   * to find the best move. Each iteration searches the root inside an
+   * aspiration window around the previous iteration's score and falls back
+   * to a full window if the score lands outside of it.
+   * @param board A constant board reference
+   * @param depth The number of plies to search
+   * @return A search result with the best move, its evaluation from the
+   * perspective of the player to move, and the principal variation.
+   * Returns a column of 0 and an empty principal variation if no moves exist.
+   */
+  search_result Search(const GameBoard& board, size_t depth);
+
+  /**
+   * Given a board, find the best move with the algorithm and depth in the
+   * options.
+   * @param board A constant board reference
+   * @param options The settings of the search
+   * @return A search result with the best move, its evaluation from the
+   * perspective of the player to move, and the principal variation.
+   * Returns a column of 0 and an empty principal variation if no moves exist.
+   */
+  search_result Search(const GameBoard& board, const search_options& options);
+
+  /**
+   * Given a board, run one principal variation search to the depth in the
+   * options inside a window, for callers that drive iterative deepening
+   * themselves. The search may be stopped at any point, even at the first
+   * depth, which leaves the result meaningless.
+   * @param board A constant board reference
+   * @param options The depth, evaluator, stop flag and deadline to use
+   * @param alpha The lower bound from the player to move's perspective
+   * @param beta The upper bound from the player to move's perspective
+   * @param previous_pv The line to try first, usually the principal
+   * variation of the same board one ply shallower
+   * @return A search result whose score is an upper bound if at most alpha
+   * and a lower bound if at least beta. The principal variation is empty if
+   * the game is over or no move beat alpha.
+   */
+  search_result SearchWindow(const GameBoard& board,
+                             const search_options& options, float alpha,
+                             float beta,
+                             const std::vector<size_t>& previous_pv);
+
+  /**
+   * Caps a search depth at the end of the game, since nothing is left to
+   * search past the last empty cell.
+   * @param board A constant board reference
+   * @param depth The depth asked for, 0 to search until the end of the game
+   * @return The number of plies to search.
+   */
+  static size_t CapDepth(const GameBoard& board, size_t depth);
+
  private:
   tiny_dnn::network<tiny_dnn::sequential> model_;
+  ThreatEvaluator threat_evaluator_;
+
+  // The evaluator used at the leaves of the current search
+  Evaluator evaluator_ = Evaluator::NeuralNetwork;
+
+  // Bounds from MTD(f) searches, cleared at the start of each search. Entries
+  // are keyed by canonical keys so mirror images share them. Only allocated
+  // by the first MTD(f) search not given a table, since it takes 24 MB.
+  std::unique_ptr<TranspositionTable> table_;
+  // The table the current MTD(f) search uses, table_ unless one was passed
+  TranspositionTable* active_table_ = nullptr;
+
+  // The principal variation of the previous iteration, tried first at each ply
+  std::vector<size_t> previous_pv_;
+  // Triangular table of principal variations so the search never allocates.
+  // Row ply holds the best line found from the node at that ply.
+  size_t pv_table_[kMaxPly + 1][kMaxPly + 1];
+  size_t pv_length_[kMaxPly + 1];
+  // Nodes visited by the current search
+  size_t nodes_ = 0;
+
+  // The stop flag and deadline of the current search
+  const std::atomic<bool>* stop_ = nullptr;
+  std::chrono::steady_clock::time_point deadline_;
+  // Whether the current iteration may be given up on, and whether it was
+  bool is_stoppable_ = false;
+  bool is_stopped_ = false;
+
+  /**
+   * Negamax principal variation search. The first move is searched with the
+   * full window, the rest with a null window and re-searched if they beat
+   * alpha.
+   * @param board A constant board reference
+   * @param depth The remaining depth
+   * @param ply The distance from the root
+   * @param alpha The lower bound from the player to move's perspective
+   * @param beta The upper bound from the player to move's perspective
+   * @return The evaluation from the perspective of the player to move.
+   * The principal variation from this node is left in row ply of pv_table_.
+   */
+  float PrincipalVariationSearch(const GameBoard& board, size_t depth,
+                                 size_t ply, float alpha, float beta);
+
+  /**
+   * Iterative deepening principal variation search, with each root iteration
+   * searched inside an aspiration window around the previous score.
+   */
+  search_result AspirationSearch(const GameBoard& board,
+                                const search_options& options);
+
+  /**
+   * Iterative deepening MTD(f). Each depth converges on the minimax value
+   * with a sequence of narrow window searches, starting from the previous
+   * depth's value as the first guess.
+   */
+  search_result MtdfSearch(const GameBoard& board,
+                           const search_options& options);
+
+  /**
+   * Negamax alpha-beta search that stores bounds in the transposition table
+   * and uses them to cut off or narrow later searches of the same position.
+   * @param board A constant board reference
+   * @param depth The remaining depth
+   * @param alpha The lower bound from the player to move's perspective
+   * @param beta The upper bound from the player to move's perspective
+   * @param column Set to the best column found from this node
+   * @return The evaluation from the perspective of the player to move
+   */
+  float AlphaBetaWithMemory(const GameBoard& board, size_t depth,
+                            float alpha, float beta, size_t& column);
+
+  /**
+   * Follows the best columns stored in the transposition table from a board.
+   * @return The principal variation, at most depth moves long
+   */
+  std::vector<size_t> ExtractPrincipalVariation(const GameBoard& board,
+                                                size_t depth) const;
+
+  /**
+   * Looks for immediate wins and moves that lose right away before a node
+   * is searched.
+   * @param board A constant board reference
+   * @param depth The remaining depth, at least 1
+   * @param winning_column Set to a winning column if one exists
+   * @param moves Set to the columns worth searching, from center to edge.
+   * Empty if every move loses.
+   * @return True if the player to move can win right away, false otherwise.
+   */
+  bool ResolveThreats(const GameBoard& board, size_t depth,
+                      size_t& winning_column,
+                      MoveList& moves) const;
+
+  /**
+   * Scores a finished game from the perspective of the player to move.
+   */
+  float EvaluateGameOver(const GameBoard& board) const;
+
+  /**
+   * Checks the stop flag and the deadline, remembering once either is hit so
+   * every node on the way back to the root returns at once.
+   * @return True if the current iteration should be given up on.
+   */
+  bool IsStopped();
 };
 
 } // namespace connect_four
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <core/thread_pool.h>
+
+#include "tiny_dnn/tiny_dnn.h"
+
+namespace connect_four {
+
+/**
+ * Trains a network with each minibatch split across a thread pool. Every
+ * worker has a replica of the network that takes its current weights and
+ * works out the gradient of the worker's slice of the minibatch. The
+ * slices' gradients are averaged, weighted by their sizes, and applied to
+ * the network in one optimizer update per minibatch, as if the whole
+ * minibatch had been trained on one thread.
+ */
+class DataParallelTrainer {
+ public:
+  /**
+   * Builds one replica per worker. The network's weights are initialized,
+   * so load any saved weights after this.
+   * @param network The network to train, which must outlive the trainer
+   * @param create_network Builds an untrained network of the same shape,
+   * since copies of a tiny_dnn network share their layers
+   * @param number_threads 0 for one worker per hardware thread
+   */
+  DataParallelTrainer(
+      tiny_dnn::network<tiny_dnn::sequential>& network,
+      const std::function<tiny_dnn::network<tiny_dnn::sequential>()>&
+          create_network,
+      size_t number_threads = 0);
+
+  /**
+   * Trains one pass over the examples in minibatches, the last of which may
+   * be smaller, with cross entropy loss.
+   * @param optimizer Updates the network once per minibatch
+   * @throw invalid_argument exception if there isn't a label for every
+   * example, or a replica's weights don't match the network's
+   */
+  void Train(tiny_dnn::optimizer& optimizer,
+             const std::vector<tiny_dnn::vec_t>& features,
+             const std::vector<tiny_dnn::label_t>& labels,
+             size_t batch_size);
+
+  // Getters
+  size_t GetNumberThreads() const;
+
+ private:
+  tiny_dnn::network<tiny_dnn::sequential>& network_;
+  ThreadPool pool_;
+  std::vector<tiny_dnn::network<tiny_dnn::sequential>> replicas_;
+
+  /**
+   * @return The weight vectors of a network, in the order tiny_dnn updates
+   * them.
+   */
+  static std::vector<tiny_dnn::vec_t*> GetWeights(
+      tiny_dnn::network<tiny_dnn::sequential>& network);
+};
+
+} // namespace connect_four
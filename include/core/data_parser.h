@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 #include "tiny_dnn/tiny_dnn.h"
 
@@ -9,6 +12,131 @@ namespace connect_four {
 using std::istream;
 using std::string;
 
+// The CSV layouts DataParser understands
+enum class DataFormat {
+  // A header row, then 42 cells as 1, -1 or 0 row by row from the top and a
+  // label of 1, -1 or 0 (c4_game_database.csv)
+  Numeric,
+  // No header, 42 cells as x, o or b column by column from the bottom and a
+  // label of win, loss or draw (connect-4.data)
+  String,
+};
+
+class PackedDataset;
+
+/**
+ * A cursor into a CSV file that stays open between reads, so consecutive
+ * chunks of examples can be read without re-reading the file from the
+ * start. Examples are one-indexed rows after the header, matching the start
+ * argument of the DataParser Yield methods.
+ */
+class DataStream {
+ public:
+  /**
+   * Opens a CSV and places the cursor on the first example.
+   * @param csv_path The path of the CSV
+   * @param format The layout of the CSV
+   * @throw invalid_argument exception if the file can't be opened
+   */
+  DataStream(const std::string& csv_path, DataFormat format);
+
+  /**
+   * Scans the whole file once and records the byte offset of every
+   * interval-th example, so later seeks are one jump plus a short read.
+   * The cursor stays on the same example.
+   */
+  void BuildIndex(size_t interval);
+
+  /**
+   * Writes the offset index to a sidecar file, so later runs can load it
+   * instead of scanning the CSV again.
+   * @param index_path The path of the index file, see GetIndexPath
+   * @throw invalid_argument exception if no index was built or the file
+   * can't be written
+   */
+  void SaveIndex(const std::string& index_path) const;
+
+  /**
+   * Reads an offset index written by SaveIndex. The cursor stays on the
+   * same example.
+   * @param index_path The path of the index file, see GetIndexPath
+   * @return False if the file is missing or was built for a different
+   * version of the CSV, true otherwise.
+   */
+  bool LoadIndex(const std::string& index_path);
+
+  /**
+   * Loads the sidecar index next to the CSV, or builds one with the given
+   * interval and saves it there if it is missing or stale.
+   */
+  void LoadOrBuildIndex(size_t interval);
+
+  /**
+   * @return The path of the sidecar index file for a CSV.
+   */
+  static std::string GetIndexPath(const std::string& csv_path);
+
+  /**
+   * Moves the cursor so the next line read is the given example. Uses the
+   * offset index if one was built, and reads forward from the cursor when
+   * that is closer.
+   * @param example The one-indexed example to move to
+   * @throw invalid_argument exception if the file ends before the example
+   */
+  void SeekToExample(size_t example);
+
+  /**
+   * Reads the line at the cursor and moves to the next example.
+   * @param line Set to the line, without any line ending
+   * @return False if the file has no more lines, true otherwise.
+   */
+  bool ReadLine(string& line);
+
+  // Getters
+  DataFormat GetFormat() const;
+  size_t GetNextExample() const;
+  // The number of lines after the header, or 0 if no index was built
+  size_t GetNumberExamples() const;
+
+ private:
+  // Written at the start of index files to recognize them
+  static constexpr uint32_t kIndexMagic = 0x58493443;
+  static constexpr uint32_t kIndexVersion = 2;
+  // Bytes hashed at each end of the CSV to tell if an index file is stale
+  static constexpr std::streamoff kHashBlockSize = 4096;
+
+  std::string csv_path_;
+  std::ifstream csv_;
+  DataFormat format_;
+  // The example the next line read belongs to
+  size_t next_example_;
+  // Byte offset of example 1, just past the header if there is one
+  std::streamoff data_start_;
+  // Byte offsets of examples 1, 1 + interval, 1 + 2 * interval, ...
+  std::vector<std::streamoff> index_;
+  size_t index_interval_;
+  size_t number_examples_;
+
+  /**
+   * @return The size of the CSV in bytes, used to tell if an index file is
+   * stale.
+   */
+  std::streamoff CalculateFileSize() const;
+
+  /**
+   * @return The CSV's last modification time in seconds, or 0 if it can't
+   * be read, used to tell if an index file is stale.
+   */
+  int64_t CalculateModifiedTime() const;
+
+  /**
+   * Hashes the first and last blocks of the CSV, so a file rewritten to the
+   * same size within the same second is still told apart.
+   * @return The FNV-1a hash of both blocks.
+   */
+  uint64_t CalculateContentHash() const;
+};
+
 /**
  * Reads data from a csv file and turns it into vec_t format
  * to train and validate a model
@@ -24,6 +152,14 @@ class DataParser {
 
   DataParser() = default;
 
+  /**
+   * Sets whether each read of training examples also appends their mirror
+   * images, which have the same labels since connect four is symmetric.
+   * Mirrored examples are made as examples are read, so datasets don't
+   * store them. Test examples are never mirrored.
+   */
+  void SetMirrorAugmentation(bool is_mirroring);
+
   /**
    * Processes CSVs where pieces are represented as 1, -1, or 0 for blank.
    * The result is indicated as -1 for a yellow win, 1 for a red win, 0 for tie
@@ -84,12 +220,88 @@ class DataParser {
   void YieldTestDataStringCSV(const std::string& csv_path, size_t start,
                         size_t number_examples);
 
+  /**
+   * Reads the next examples from an open stream of either format as
+   * training examples, continuing where the last read of the stream ended.
+   * Stops early at the end of the file.
+   *
+   * Updates train_features and train_labels
+   */
+  void YieldTrainingData(DataStream& stream, size_t number_examples);
+
+  /**
+   * Reads the next examples from an open stream of either format as
+   * test examples, continuing where the last read of the stream ended.
+   * Stops early at the end of the file.
+   *
+   * Updates test_features and test_labels
+   */
+  void YieldTestData(DataStream& stream, size_t number_examples);
+
+  /**
+   * Seeks an open stream to a one-indexed start example and reads a number
+   * of examples from there as training examples. With an index this is one
+   * seek plus a short read, so minibatches can be sampled at random.
+   *
+   * Updates train_features and train_labels
+   */
+  void YieldTrainingData(DataStream& stream, size_t start,
+                         size_t number_examples);
+
+  /**
+   * Seeks an open stream to a one-indexed start example and reads a number
+   * of examples from there as test examples.
+   *
+   * Updates test_features and test_labels
+   */
+  void YieldTestData(DataStream& stream, size_t start,
+                     size_t number_examples);
+
+  /**
+   * Expands a range of examples from a packed dataset as training examples.
+   * Start is one-indexed, and reading stops early at the end of the dataset.
+   *
+   * Updates train_features and train_labels
+   */
+  void YieldTrainingData(const PackedDataset& dataset, size_t start,
+                         size_t number_examples);
+
+  /**
+   * Expands a range of examples from a packed dataset as test examples.
+   * Start is one-indexed, and reading stops early at the end of the dataset.
+   *
+   * Updates test_features and test_labels
+   */
+  void YieldTestData(const PackedDataset& dataset, size_t start,
+                     size_t number_examples);
+
   /**
    * Since all the data can't be loaded in-memory, this will reset
    * all the stored vectors.
    */
   void Clear();
 
+  /**
+   * Moves the training examples out without copying them, leaving the
+   * training vectors empty.
+   * @param features Replaced with the training features
+   * @param labels Replaced with the training labels
+   */
+  void TakeTrainingData(std::vector<tiny_dnn::vec_t>& features,
+                        std::vector<tiny_dnn::label_t>& labels);
+
+  /**
+   * Parses one line of a CSV, for callers that need to know which lines
+   * didn't parse.
+   * @param line A line without its line ending
+   * @param format The layout of the CSV the line is from
+   * @param features Set to the 42 cells, row by row from the top
+   * @param label Set to the category of the result
+   * @return False if the line isn't an example, true otherwise.
+   */
+  bool ParseLine(const string& line, DataFormat format,
+                 tiny_dnn::vec_t& features, tiny_dnn::label_t& label) const;
+
   // Getters
   const std::vector<tiny_dnn::vec_t>& GetTrainFeatures() const;
   const std::vector<tiny_dnn::label_t>& GetTrainLabels() const;
@@ -101,6 +313,14 @@ class DataParser {
   std::vector<tiny_dnn::label_t> train_labels;
   std::vector<tiny_dnn::vec_t> test_features;
   std::vector<tiny_dnn::label_t> test_labels;
+  bool is_mirroring = false;
+
+  /**
+   * Appends the mirror image of every training example from first on, if
+   * mirror augmentation is on.
+   * @param first The index of the first training example to mirror
+   */
+  void AppendMirroredExamples(size_t first);
 
   /**
    * A helper function to split strings by character.
@@ -109,6 +329,29 @@ class DataParser {
    * @return A vector of strings split by the delimiting character.
    */
   std::vector<string> Split(const string &line, char delim) const;
+
+  /**
+   * Reads a number of lines from a stream and appends the examples parsed
+   * from them to features and labels. Lines that don't parse are skipped.
+   */
+  void YieldExamples(DataStream& stream, size_t number_examples,
+                     std::vector<tiny_dnn::vec_t>& features,
+                     std::vector<tiny_dnn::label_t>& labels) const;
+
+  /**
+   * Parses a line of a numeric CSV.
+   * @return False if the line is empty or has the wrong number of cells.
+   */
+  bool ParseNumericLine(const string& line, tiny_dnn::vec_t& features,
+                        tiny_dnn::label_t& label) const;
+
+  /**
+   * Parses a line of a string CSV, reordering the cells row by row from
+   * the top to match the numeric format.
+   * @return False if the line is empty.
+   */
+  bool ParseStringLine(const string& line, tiny_dnn::vec_t& features,
+                       tiny_dnn::label_t& label) const;
 };
 
 } // namespace connect_four
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <core/data_parser.h>
+#include <core/mapped_file.h>
+
+namespace connect_four {
+
+// A struct storing a unique position, in the masks of packed_example, and
+// how many times each label was seen with it, indexed by category
+struct aggregated_example {
+  uint64_t x_mask;
+  uint64_t o_mask;
+  uint32_t counts[3];
+
+  aggregated_example() : x_mask(0), o_mask(0), counts{0, 0, 0} {};
+};
+
+/**
+ * Merges duplicate positions across datasets into one example each, with
+ * the counts of every label it was seen with. Examples are first spread
+ * over partition files on disk by a hash of the position, so duplicates
+ * always share a partition and only one partition at a time has to fit in
+ * memory.
+ */
+class Deduplicator {
+ public:
+  /**
+   * Creates the empty partition files.
+   * @param partition_prefix The partition files are this prefix followed by
+   * their number, so it can point into a temporary directory
+   * @param number_partitions Raise this until a partition fits in memory
+   * @throw invalid_argument exception if a partition file can't be created
+   */
+  Deduplicator(const std::string& partition_prefix,
+               size_t number_partitions = 64);
+
+  /**
+   * Removes the partition files if Finish wasn't called.
+   */
+  ~Deduplicator();
+
+  Deduplicator(const Deduplicator&) = delete;
+  Deduplicator& operator=(const Deduplicator&) = delete;
+
+  /**
+   * Reads every example left in a CSV stream into the partitions.
+   */
+  void AddDataset(DataStream& stream);
+
+  /**
+   * Merges each partition in turn and writes the unique positions as an
+   * aggregated dataset, then removes the partition files.
+   * @param output_path The path of the aggregated dataset
+   * @return The number of unique positions.
+   * @throw invalid_argument exception if a file can't be read or written
+   */
+  size_t Finish(const std::string& output_path);
+
+  // Getters
+  size_t GetNumberExamplesRead() const;
+
+ private:
+  // Bytes per partition record: both masks and the label
+  static constexpr size_t kRecordSize = 17;
+
+  std::string partition_prefix_;
+  std::vector<std::unique_ptr<std::ofstream>> partitions_;
+  size_t number_examples_read_;
+
+  /**
+   * @return The path of a partition file.
+   */
+  std::string GetPartitionPath(size_t partition) const;
+
+  /**
+   * Reads one partition and merges its duplicates.
+   * @return The unique positions, ordered by their masks.
+   */
+  std::vector<aggregated_example> MergePartition(size_t partition) const;
+
+  /**
+   * Closes and deletes every partition file.
+   */
+  void RemovePartitions();
+};
+
+/**
+ * A deduplicated dataset written by Deduplicator, mapped into memory.
+ */
+class AggregatedDataset {
+ public:
+  // Bytes per record on disk: both masks and three 32-bit counts
+  static constexpr size_t kRecordSize = 28;
+
+  /**
+   * Maps an aggregated dataset into memory.
+   * @throw invalid_argument exception if the file can't be opened or isn't
+   * an aggregated dataset
+   */
+  explicit AggregatedDataset(const std::string& aggregated_path);
+
+  /**
+   * Opens an aggregated dataset for writing and writes its header.
+   * @param number_examples The number of records that will follow
+   * @throw invalid_argument exception if the file can't be opened
+   */
+  static void WriteHeader(std::ofstream& aggregated_file,
+                          const std::string& aggregated_path,
+                          uint64_t number_examples);
+
+  /**
+   * Appends one unique position to an aggregated dataset.
+   */
+  static void WriteRecord(std::ofstream& aggregated_file,
+                          const aggregated_example& example);
+
+  /**
+   * Expands a range of examples with soft targets, the fraction of times
+   * each label was seen with the position, for training with fit.
+   * @param start The one-indexed first example, like DataParser's start
+   * @param number_examples The number of examples to read
+   */
+  void YieldExamples(size_t start, size_t number_examples,
+                     std::vector<tiny_dnn::vec_t>& features,
+                     std::vector<tiny_dnn::vec_t>& targets) const;
+
+  /**
+   * @param index The zero-indexed example
+   * @throw out_of_range exception if the index is past the end
+   */
+  aggregated_example GetExample(size_t index) const;
+
+  // Getters
+  size_t GetNumberExamples() const;
+
+ private:
+  // Written at the start of aggregated files to recognize them
+  static constexpr uint32_t kMagic = 0x47413443;
+  static constexpr uint32_t kVersion = 1;
+  // Magic, version and the number of examples
+  static constexpr size_t kHeaderSize = 16;
+
+  MappedFile file_;
+  size_t number_examples_;
+};
+
+} // namespace connect_four
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <core/computer_agent.h>
+#include <core/gameboard.h>
+
+namespace connect_four {
+
+// A struct storing the limits of one go command
+struct go_limits {
+  // 0 to search until the end of the game
+  size_t depth;
+  // 0 for no time limit
+  size_t move_time_ms;
+  size_t number_threads;
+
+  go_limits() : depth(0), move_time_ms(0), number_threads(1) {};
+};
+
+/**
+ * Drives the computer with a line-based text protocol, so it can run as a
+ * headless process behind a game server. Commands are read one line at a
+ * time and every reply is a line:
+ *
+ *   isready                        replies readyok
+ *   position [moves]               sets the board to the moves played from
+ *                                  the empty board, as zero-indexed columns
+ *   setoption evaluator <network|threats>
+ *   go [depth <plies>] [movetime <ms>] [threads <n>]
+ *                                  searches in the background, replying
+ *                                  with an info line after each depth and
+ *                                  a bestmove line at the end
+ *   stop                           ends the search, which still replies
+ *                                  with its best move so far
+ *   quit                           stops any search and exits
+ *
+ * Info lines read "info depth 5 score 0.21 nodes 1234 nps 56789 time 21
+ * pv 3 3 4", with the score from the perspective of the player to move and
+ * the time in milliseconds. "bestmove none" means the game is over.
+ * Problems are reported as "info string <message>".
+ */
+class Engine {
+ public:
+  /**
+   * Loads the first computer, so a missing model fails here instead of
+   * during a search.
+   * @param output Where replies are written. Search threads write to it
+   * too, always a whole line at a time.
+   */
+  explicit Engine(std::ostream& output);
+
+  /**
+   * Stops and waits for any search.
+   */
+  ~Engine();
+
+  /**
+   * Handles one line of the protocol.
+   * @return False if the line was quit, true otherwise.
+   */
+  bool HandleCommand(const std::string& line);
+
+  /**
+   * Blocks until the current search, if any, has replied with its best
+   * move.
+   */
+  void Wait();
+
+  /**
+   * Reads the limits of a go command.
+   * @param arguments The words after go
+   * @throw invalid_argument exception if a word isn't a limit or a limit
+   * isn't followed by a number
+   */
+  static go_limits ParseLimits(std::istringstream& arguments);
+
+  /**
+   * Formats the info line of a complete depth.
+   * @param seconds The time the search has taken so far
+   */
+  static std::string FormatInfo(const search_result& result, double seconds);
+
+ private:
+  std::ostream& output_;
+  std::mutex output_mutex_;
+
+  GameBoard board_;
+  Evaluator evaluator_;
+  // One computer per search thread, since a computer searches one position
+  // at a time. Only added to between searches.
+  std::vector<std::unique_ptr<Computer>> computers_;
+
+  std::thread search_thread_;
+  std::atomic<bool> stop_;
+  // Lets the time limit wake up early when a search finishes
+  std::mutex timer_mutex_;
+  std::condition_variable search_finished_;
+  bool is_searching_;
+
+  /**
+   * Writes one line to the output.
+   */
+  void PrintLine(const std::string& line);
+
+  /**
+   * Stops the current search and starts a new one on a background thread.
+   */
+  void Go(const go_limits& limits);
+
+  /**
+   * Runs a search to its end and replies with the best move.
+   */
+  void RunSearch(const GameBoard& board, const go_limits& limits,
+                 Evaluator evaluator);
+
+  /**
+   * Iterative deepening over the root moves. Each depth hands the root
+   * moves out to the threads, which each search their moves one ply less
+   * deep, and the first depth runs on one thread. The previous depth's best
+   * move goes first, and once any move has a score the rest are tested
+   * against the best so far with null windows. Each move starts from its
+   * own line of the previous depth, instead of deepening from scratch.
+   * @param on_iteration Called with the result after each complete depth
+   * @return The result of the last complete depth.
+   */
+  search_result SplitSearch(const GameBoard& board, size_t depth,
+                            size_t number_threads, Evaluator evaluator,
+                            const std::function<void(const search_result&)>&
+                                on_iteration);
+};
+
+} // namespace connect_four
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <core/gameboard.h>
+
+namespace connect_four {
+
+// A struct storing one game as the columns played from the empty board
+struct game_record {
+  // Zero-indexed columns in the order they were played
+  std::vector<uint8_t> moves;
+  // InProgress for a game stopped before its end
+  BoardState result;
+
+  game_record() : result(BoardState::InProgress) {};
+
+  /**
+   * @return The moves as a string GameBoard::FromMoves reads, such as "3342".
+   */
+  std::string GetMoveString() const;
+};
+
+/**
+ * Streams games into a game record file. Each game is stored as a one-byte
+ * header holding its result and number of moves, followed by its moves at
+ * three bits each, so a 30-move game takes 13 bytes. The file header
+ * holds a free-form metadata string describing how the games were made,
+ * and the number of games, which is filled in when the writer is closed.
+ */
+class GameRecordWriter {
+ public:
+  /**
+   * Creates the file and writes its header.
+   * @param path The path to write to
+   * @param metadata A description of the games, such as the settings of
+   * the run that played them
+   * @throw invalid_argument exception if the file can't be created
+   */
+  GameRecordWriter(const std::string& path, const std::string& metadata);
+
+  /**
+   * Closes the file if Close wasn't called.
+   */
+  ~GameRecordWriter();
+
+  GameRecordWriter(const GameRecordWriter&) = delete;
+  GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+  /**
+   * Appends one game.
+   * @throw invalid_argument exception if a move isn't a column or there
+   * are more moves than cells
+   */
+  void Write(const game_record& record);
+
+  /**
+   * Fills in the number of games and closes the file.
+   * @return The number of games written.
+   * @throw invalid_argument exception if any write failed
+   */
+  size_t Close();
+
+  /**
+   * Encodes one game as it is stored in a file.
+   * @throw invalid_argument exception if a move isn't a column or there
+   * are more moves than cells
+   */
+  static std::string Encode(const game_record& record);
+
+  // Getters
+  size_t GetNumberGames() const;
+
+  // Bits per move, and per result in the game header
+  static constexpr size_t kMoveBits = 3;
+  static constexpr size_t kResultBits = 2;
+
+ private:
+  friend class GameRecordReader;
+
+  // Written at the start of game record files to recognize them
+  static constexpr uint32_t kMagic = 0x52473443;
+  static constexpr uint32_t kVersion = 1;
+  // The number of games is written after the magic and version
+  static constexpr size_t kNumberGamesOffset = 8;
+
+  std::ofstream file_;
+  uint64_t number_games_;
+  bool is_closed_;
+};
+
+/**
+ * Reads the games of a game record file one at a time, so files of any
+ * size can be processed in constant memory.
+ */
+class GameRecordReader {
+ public:
+  /**
+   * Opens a game record file and reads its header.
+   * @param path The path of a file written by GameRecordWriter
+   * @throw invalid_argument exception if the file can't be opened or isn't
+   * a game record file
+   */
+  explicit GameRecordReader(const std::string& path);
+
+  /**
+   * Reads the next game.
+   * @param record Overwritten with the game
+   * @return False at the end of the file.
+   * @throw invalid_argument exception if the game is cut off or holds a
+   * move that isn't a column
+   */
+  bool Next(game_record& record);
+
+  // Getters
+  const std::string& GetMetadata() const;
+  // The number of games the writer recorded when it was closed
+  size_t GetNumberGames() const;
+
+ private:
+  std::ifstream file_;
+  std::string metadata_;
+  uint64_t number_games_;
+};
+
+/**
+ * Replays a game one move at a time, so every position of a game can be
+ * visited without keeping them all.
+ */
+class GameReplay {
+ public:
+  /**
+   * @param record The game to replay, which must outlive the replay
+   */
+  explicit GameReplay(const game_record& record);
+
+  /**
+   * Plays the next move.
+   * @return False once every move has been played.
+   * @throw invalid_argument exception if a move can't be played, or the
+   * moves don't lead to the recorded result
+   */
+  bool Next();
+
+  // Getters
+  const GameBoard& GetBoard() const;
+  // The number of moves played so far
+  size_t GetPly() const;
+
+ private:
+  const game_record& record_;
+  GameBoard board_;
+  size_t ply_;
+};
+
+} // namespace connect_four
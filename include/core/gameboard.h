@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <string>
 
 namespace connect_four {
 
@@ -15,18 +17,47 @@ enum class BoardState {
 };
 
 /**
- * A gameboard for connect-four
+ * A fixed-capacity list of columns, stored inline so that generating moves
+ * never allocates.
+ */
+class MoveList {
+ public:
+  // A list can hold every column of the board
+  static constexpr size_t kCapacity = 7;
+
+  MoveList() : size_(0) {};
+
+  // Adds a column to the end of the list, which must not be full
+  void push_back(size_t column);
+
+  // Container-style accessors so lists work with range-for and <algorithm>
+  size_t size() const;
+  bool empty() const;
+  size_t operator[](size_t index) const;
+  size_t* begin();
+  size_t* end();
+  const size_t* begin() const;
+  const size_t* end() const;
+
+ private:
+  size_t columns_[kCapacity];
+  size_t size_;
+};
+
+/**
+ * A gameboard for connect-four. The position is stored entirely in
+ * bitboards, so boards are trivially copyable and never allocate.
  */
 class GameBoard {
  public:
   // Constants for width and height
-  const size_t kWidth = 7;
-  const size_t kHeight = 6;
+  static constexpr size_t kWidth = 7;
+  static constexpr size_t kHeight = 6;
 
   // Constants for pieces corresponding to model inputs
-  const int kEmpty = 0;
-  const int kXPiece = 1;
-  const int kOPiece = -1;
+  static constexpr int kEmpty = 0;
+  static constexpr int kXPiece = 1;
+  static constexpr int kOPiece = -1;
 
   /**
    * Construct an empty gameboard
@@ -42,12 +73,20 @@ class GameBoard {
    */
   GameBoard(const vector<vector<int>>& pieces, bool is_x_turn);
 
+  /**
+   * Construct a gameboard by playing moves from the empty board
+   * @param moves A string of zero-indexed columns, such as "3342"
+   * @throw invalid_argument exception if a character isn't a column or a
+   * move can't be played, because its column is full or the game is over.
+   */
+  static GameBoard FromMoves(const std::string& moves);
+
   /**
    * Calculate the valid columns for a player to place a piece in.
-   * @return A vector with all the valid column indices to place in.
-   * Returns an empty vector if the game is over.
+   * @return A list with all the valid column indices to place in, from
+   * center to edge. Returns an empty list if the game is over.
    */
-  vector<size_t> CalculateValidColumns() const;
+  MoveList CalculateValidColumns() const;
 
   /**
    * Returns a boardstate enum corresponding to the state (InvalidState,
@@ -82,22 +121,104 @@ class GameBoard {
   // Getters
   bool GetIsXTurn() const;
 
+  // Bitboards of the pieces, with bit (column * 7 + height from the bottom)
+  // set if that cell holds a piece
+  uint64_t GetXBitboard() const;
+  uint64_t GetOBitboard() const;
+  uint64_t GetOccupiedBitboard() const;
+
+  /**
+   * Finds the empty cells that would complete four in a row for a player,
+   * whether or not they can be played yet.
+   * @param is_x Whether to find X's threats or O's threats
+   * @return A bitboard of the threatened cells
+   */
+  uint64_t CalculateThreats(bool is_x) const;
+
+  /**
+   * Finds the cells where the next piece dropped in each column would land.
+   * @return A bitboard with one cell for each column that isn't full
+   */
+  uint64_t CalculatePlayableCells() const;
+
+  /**
+   * Finds the cells a player could drop a piece in to win right away.
+   * @param is_x Whether to find X's winning moves or O's winning moves
+   * @return A bitboard of the winning cells
+   */
+  uint64_t CalculateWinningMoves(bool is_x) const;
+
+  /**
+   * Finds the moves for the player to move that don't let the opponent win
+   * on their next turn. If the opponent threatens to win, the only
+   * candidate is blocking them, and no move is safe if they threaten to win
+   * in two places. Moves right below an opponent threat are excluded.
+   * This assumes the player to move can't win right away.
+   * @return A bitboard of the cells to play in, empty if every move loses or
+   * the game is over.
+   */
+  uint64_t CalculateNonLosingMoves() const;
+
+  /**
+   * Calculate the non-losing columns for the player to move, as described
+   * in CalculateNonLosingMoves.
+   * @return A list with the column indices from center to edge.
+   * Returns an empty list if every move loses or the game is over.
+   */
+  MoveList CalculateNonLosingColumns() const;
+
+  /**
+   * Lists the columns that have a cell in a bitboard.
+   * @param cells A bitboard, such as the result of CalculateWinningMoves
+   * @return A list with the column indices from center to edge.
+   */
+  MoveList ConvertToColumns(uint64_t cells) const;
+
   /**
    * Create a vector representation of the position to input to the model.
    * @return A vector containing one vec_t of length 42 representing the board.
    */
   std::vector<float> GenerateVectorFeatures() const;
 
+  /**
+   * Gets a key that uniquely identifies the position, for use in
+   * transposition tables. The player to move is implied by the pieces.
+   * @return A 64-bit key where only the lowest 49 bits can be set.
+   */
+  uint64_t GetKey() const;
+
+  /**
+   * Reflects the board left to right. Connect four is symmetric, so the
+   * mirrored position has the same value with the columns reflected.
+   * @return A copy of the board with column c moved to column 6 - c.
+   */
+  GameBoard Mirror() const;
+
+  /**
+   * Gets a key shared by the position and its mirror image, so tables can
+   * store one entry for both.
+   * @return The smaller of GetKey() and the mirrored board's key.
+   */
+  uint64_t GetCanonicalKey() const;
+
  private:
-  // A 2D vector storing integers representing pieces
-  vector<vector<int>> pieces_;
   // The turn
   bool is_x_turn_;
   // Store the gamestate so it only has to be calculated each turn
   BoardState gamestate_;
 
+  // Bitboards of the pieces, one bit per cell going up each column from the
+  // bottom, with an unused bit on top of each column (bit = col * 7 + height)
+  uint64_t x_bitboard_;
+  uint64_t occupied_bitboard_;
+
+  // The bit below each column, used to build unique keys
+  static constexpr uint64_t kBottomMask = 0x40810204081ULL;
+  // Every cell on the board
+  static constexpr uint64_t kBoardMask = 0x3FULL * kBottomMask;
+
   // Return valid columns from center to edge
-  std::vector<size_t> kColumnOrder = {3, 4, 2, 5, 1, 6, 0};
+  static constexpr size_t kColumnOrder[kWidth] = {3, 4, 2, 5, 1, 6, 0};
 
   /**
    * Updates the gamestate for the current board position.
@@ -127,12 +248,21 @@ class GameBoard {
    */
   bool ArePiecesValid(int x_piece, int o_piece) const;
 
-  // Helpers to check for the existence of different types of wins based on the
-  // type of piece
-  bool HasVerticalWins(int piece) const;
-  bool HasHorizontalWins(int piece) const;
-  bool HasUpRightDiagonalWins(int piece) const;
-  bool HasDownRightDiagonalWins(int piece) const;
+  /**
+   * Gets the bitboard bit corresponding to a coordinate of the board.
+   */
+  uint64_t CalculateCellMask(size_t row, size_t column) const;
+
+  /**
+   * Checks if a bitboard of one player's pieces has four in a row in any
+   * direction.
+   */
+  bool HasFourInARow(uint64_t pieces) const;
+
+  /**
+   * Reverses the order of the columns of a bitboard or key.
+   */
+  static uint64_t MirrorBitboard(uint64_t bitboard);
 
   // Finds the number of matching pieces
   size_t CalculateNumberPieces(int piece) const;
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <core/socket.h>
+
+namespace connect_four {
+
+// A struct storing the settings of a load test
+struct load_options {
+  std::string address;
+  // Connections opened at once, each playing its games one after another
+  size_t number_sessions;
+  size_t games_per_session;
+  // Sent with every go, 0 to leave them out
+  size_t depth;
+  size_t move_time_ms;
+  // How long a session waits before asking again or reconnecting after
+  // being turned away
+  size_t retry_delay_ms;
+
+  load_options() : address("tcp:7474"), number_sessions(8),
+      games_per_session(4), depth(0), move_time_ms(50),
+      retry_delay_ms(10) {};
+};
+
+// A struct storing what the clients saw during a load test
+struct load_stats {
+  size_t games;
+  size_t requests;
+  size_t rejected_requests;
+  // Connections the server turned away because it had too many sessions
+  size_t refused_connections;
+  double seconds;
+  // Milliseconds from sending a go to reading its best move
+  double latency_p50_ms;
+  double latency_p90_ms;
+  double latency_p99_ms;
+  double latency_max_ms;
+
+  load_stats() : games(0), requests(0), rejected_requests(0),
+      refused_connections(0), seconds(0), latency_p50_ms(0),
+      latency_p90_ms(0), latency_p99_ms(0), latency_max_ms(0) {};
+
+  /**
+   * @return The searches answered per second, 0 without a measured time.
+   */
+  double CalculateRequestsPerSecond() const;
+};
+
+/**
+ * Loads a server with many concurrent sessions, each having the server play
+ * both sides of its games from the empty board, and measures the latency
+ * of every search from the client's side.
+ */
+class LoadGenerator {
+ public:
+  explicit LoadGenerator(const load_options& options);
+
+  /**
+   * Plays every session's games, one thread per session.
+   * @return The totals of every session.
+   * @throw invalid_argument exception if a session can't connect, or the
+   * server closes it after taking it or replies with something other than
+   * a move
+   */
+  load_stats Run() const;
+
+ private:
+  load_options options_;
+
+  /**
+   * Plays one session's games.
+   * @param stats Where the session's games and requests are counted
+   * @param latencies The latency of each answered search is appended
+   */
+  void RunSession(load_stats& stats, std::vector<double>& latencies) const;
+
+  /**
+   * Connects and waits for the server to take the session, connecting again
+   * after each refusal.
+   * @param stats Where refused connections are counted
+   * @return The connection to a session that is ready.
+   * @throw invalid_argument exception if nothing is listening
+   */
+  Socket Connect(load_stats& stats) const;
+};
+
+} // namespace connect_four
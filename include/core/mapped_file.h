@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace connect_four {
+
+/**
+ * A read-only view of a whole file mapped into memory, unmapped when the
+ * object is destroyed.
+ */
+class MappedFile {
+ public:
+  /**
+   * Maps a file. Empty files map to no data and a size of 0.
+   * @param path The path of the file
+   * @throw invalid_argument exception if the file can't be opened or mapped
+   */
+  explicit MappedFile(const std::string& path);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // Getters
+  const char* GetData() const;
+  size_t GetSize() const;
+
+ private:
+  const char* data_;
+  size_t size_;
+#ifdef _WIN32
+  void* file_handle_;
+  void* mapping_handle_;
+#endif
+
+  /**
+   * Releases the mapping and any handles.
+   */
+  void Unmap();
+};
+
+} // namespace connect_four
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <core/batch_loader.h>
+#include <core/packed_dataset.h>
+#include <core/parallel_parser.h>
+
+namespace connect_four {
+
+/**
+ * Holds a whole training set in memory as packed examples, 17 bytes each,
+ * and serves it in a new random order every epoch, so minibatches mix
+ * positions from across the dataset instead of following file order. The
+ * order and the mirrored examples only depend on the seed and the epoch,
+ * so training can resume partway through an epoch.
+ */
+class MinibatchSampler {
+ public:
+  /**
+   * Creates an empty sampler.
+   * @param seed Seeds the shuffles, so runs are reproducible
+   */
+  explicit MinibatchSampler(unsigned int seed = 0);
+
+  /**
+   * Packs a range of parsed examples into the training set.
+   * @param buffer The parsed examples
+   * @param first The zero-indexed first example to add
+   * @param number_examples The number of examples to add, cut short at the
+   * end of the buffer
+   */
+  void AddExamples(const example_buffer& buffer, size_t first,
+                   size_t number_examples);
+
+  /**
+   * Sets whether each example served is mirrored left to right with
+   * probability one half, in place of doubling the training set.
+   */
+  void SetMirrorAugmentation(bool is_mirroring);
+
+  /**
+   * Shuffles the training set for an epoch and moves back to its start.
+   * @param epoch The zero-indexed epoch, which picks the order
+   */
+  void StartEpoch(size_t epoch);
+
+  /**
+   * Moves to a position in the current epoch's order, for example to resume
+   * from a checkpoint.
+   * @param position The number of examples of the epoch already served
+   */
+  void Seek(size_t position);
+
+  /**
+   * Unpacks the next examples of the epoch, replacing the batch's contents.
+   * @param number_examples The number of examples to serve, fewer at the
+   * end of an epoch
+   * @return False if the epoch has no examples left, true otherwise.
+   */
+  bool Next(size_t number_examples, training_batch& batch);
+
+  // Getters
+  size_t GetNumberExamples() const;
+  size_t GetPosition() const;
+
+ private:
+  std::vector<packed_example> examples_;
+  // The indices of the examples in the current epoch's order
+  std::vector<uint32_t> order_;
+  // The position in the order of the next example to serve
+  size_t cursor_;
+  unsigned int seed_;
+  // Decides which examples of the current epoch are mirrored
+  uint64_t mirror_seed_;
+  bool is_mirroring_;
+
+  /**
+   * Decides whether the example at a position of the epoch is mirrored, in
+   * a way that doesn't depend on the examples served before it.
+   */
+  bool IsMirrored(size_t position) const;
+};
+
+} // namespace connect_four
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <core/thread_pool.h>
+
+#include "tiny_dnn/tiny_dnn.h"
+
+namespace connect_four {
+
+// A struct storing how a model did on a test set. confusion[i][j] counts
+// the examples labeled i that the model predicted as j, in DataParser's
+// categories.
+struct evaluation_result {
+  size_t confusion[3][3];
+  size_t number_examples;
+  size_t number_correct;
+  double seconds;
+
+  evaluation_result() : confusion{{0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
+      number_examples(0), number_correct(0), seconds(0) {};
+
+  /**
+   * @return The percentage of examples predicted correctly.
+   */
+  float CalculateAccuracy() const;
+};
+
+/**
+ * Runs a model over a test set on a thread pool. Workers take batches of
+ * examples in turn and predict each batch in one pass through the network.
+ * Each worker has its own copy of the model, since a tiny_dnn network keeps
+ * buffers from its last prediction and can't predict on several threads at
+ * once.
+ */
+class ModelEvaluator {
+ public:
+  /**
+   * Loads one copy of the model per worker.
+   * @param model_path The path of a model saved by network::save
+   * @param number_threads 0 for one worker per hardware thread
+   * @param batch_size The number of examples a worker takes at a time
+   */
+  ModelEvaluator(const std::string& model_path, size_t number_threads = 0,
+                 size_t batch_size = 1024);
+
+  /**
+   * Predicts every example and compares the most likely category with its
+   * label.
+   * @param features The features of the examples back to back, 42 each, as
+   * in an example_buffer
+   * @param labels The label of each example
+   * @param number_examples The number of examples to evaluate
+   */
+  evaluation_result Evaluate(const float* features,
+                             const tiny_dnn::label_t* labels,
+                             size_t number_examples);
+
+  /**
+   * Predicts every example and compares the most likely category with its
+   * label.
+   * @throw invalid_argument exception if there isn't a label for every
+   * example, or an example doesn't have 42 features
+   */
+  evaluation_result Evaluate(const std::vector<tiny_dnn::vec_t>& features,
+                             const std::vector<tiny_dnn::label_t>& labels);
+
+  // Getters
+  size_t GetNumberThreads() const;
+
+ private:
+  ThreadPool pool_;
+  std::vector<tiny_dnn::network<tiny_dnn::sequential>> models_;
+  size_t batch_size_;
+
+  /**
+   * Runs the examples through the workers' models a batch at a time.
+   * @param get_features Gives the 42 features of an example by its index
+   */
+  evaluation_result EvaluateBatches(
+      const std::function<const float*(size_t)>& get_features,
+      const tiny_dnn::label_t* labels, size_t number_examples);
+};
+
+} // namespace connect_four
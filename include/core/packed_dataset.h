@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <core/data_parser.h>
+#include <core/mapped_file.h>
+#include <core/parallel_parser.h>
+
+namespace connect_four {
+
+// A struct storing one example in two masks of the 42 feature cells, with
+// bit i set when feature i (row by row from the top) is 1 or -1
+struct packed_example {
+  uint64_t x_mask;
+  uint64_t o_mask;
+  uint8_t label;
+
+  packed_example() : x_mask(0), o_mask(0), label(0) {};
+};
+
+/**
+ * A dataset converted from CSV into fixed-size binary records and mapped
+ * into memory, so loading it costs no parsing and examples are only
+ * expanded into vec_t when a batch is read.
+ */
+class PackedDataset {
+ public:
+  // Bytes per record on disk: both masks and the label
+  static constexpr size_t kRecordSize = 17;
+
+  /**
+   * Maps a packed dataset into memory.
+   * @param packed_path The path of a file written by Convert
+   * @throw invalid_argument exception if the file can't be opened or isn't
+   * a packed dataset
+   */
+  explicit PackedDataset(const std::string& packed_path);
+
+  /**
+   * Reads every example left in a CSV stream and writes them as a packed
+   * dataset.
+   * @param stream An open CSV, read from its cursor to the end
+   * @param packed_path The path to write to
+   * @return The number of examples written.
+   * @throw invalid_argument exception if the file can't be written
+   */
+  static size_t Convert(DataStream& stream, const std::string& packed_path);
+
+  /**
+   * Writes every example of a parsed buffer as a packed dataset.
+   * @param buffer Examples from ParallelParser
+   * @param packed_path The path to write to
+   * @return The number of examples written.
+   * @throw invalid_argument exception if the file can't be written
+   */
+  static size_t Convert(const example_buffer& buffer,
+                        const std::string& packed_path);
+
+  /**
+   * Expands a range of examples and appends them to features and labels.
+   * Stops early at the end of the dataset.
+   * @param start The one-indexed first example, like DataParser's start
+   * @param number_examples The number of examples to read
+   */
+  void YieldExamples(size_t start, size_t number_examples,
+                     std::vector<tiny_dnn::vec_t>& features,
+                     std::vector<tiny_dnn::label_t>& labels) const;
+
+  /**
+   * @param index The zero-indexed example
+   * @throw out_of_range exception if the index is past the end
+   */
+  packed_example GetExample(size_t index) const;
+
+  /**
+   * Packs one parsed example into masks.
+   * @param features The example's 42 features
+   */
+  static packed_example Pack(const float* features, tiny_dnn::label_t label);
+
+  /**
+   * Expands the masks of a packed example back into 42 features.
+   */
+  static tiny_dnn::vec_t Unpack(uint64_t x_mask, uint64_t o_mask);
+
+  // Getters
+  size_t GetNumberExamples() const;
+
+ private:
+  friend class PackedDatasetWriter;
+
+  // Written at the start of packed files to recognize them
+  static constexpr uint32_t kMagic = 0x4B503443;
+  static constexpr uint32_t kVersion = 1;
+  // Magic, version and the number of examples
+  static constexpr size_t kHeaderSize = 16;
+  static constexpr size_t kNumberCells = 42;
+
+  MappedFile file_;
+  size_t number_examples_;
+};
+
+/**
+ * Streams examples into a packed dataset as they are made. The number of
+ * examples in the header is filled in when the writer is closed.
+ */
+class PackedDatasetWriter {
+ public:
+  /**
+   * Creates the file and writes its header.
+   * @param packed_path The path to write to
+   * @throw invalid_argument exception if the file can't be created
+   */
+  explicit PackedDatasetWriter(const std::string& packed_path);
+
+  /**
+   * Closes the file if Close wasn't called.
+   */
+  ~PackedDatasetWriter();
+
+  PackedDatasetWriter(const PackedDatasetWriter&) = delete;
+  PackedDatasetWriter& operator=(const PackedDatasetWriter&) = delete;
+
+  /**
+   * Appends one example.
+   */
+  void Write(const packed_example& example);
+
+  /**
+   * Fills in the number of examples and closes the file.
+   * @return The number of examples written.
+   * @throw invalid_argument exception if any write failed
+   */
+  size_t Close();
+
+  // Getters
+  size_t GetNumberExamples() const;
+
+ private:
+  std::ofstream packed_file_;
+  uint64_t number_examples_;
+  bool is_closed_;
+};
+
+} // namespace connect_four
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <core/data_parser.h>
+#include <core/thread_pool.h>
+
+namespace connect_four {
+
+// A struct storing parsed examples back to back: the features of example i
+// are features[42 * i] to features[42 * i + 41], and its label is labels[i]
+struct example_buffer {
+  std::vector<float> features;
+  std::vector<tiny_dnn::label_t> labels;
+};
+
+/**
+ * Parses whole CSVs on a thread pool. The file is memory-mapped and split
+ * into chunks at line breaks, and each worker parses its chunk in place
+ * into its own slice of one preallocated buffer, without allocating any
+ * strings.
+ */
+class ParallelParser {
+ public:
+  static constexpr size_t kNumberFeatures = 42;
+
+  /**
+   * @param pool The workers to parse on, which must outlive the parser
+   */
+  explicit ParallelParser(ThreadPool& pool);
+
+  /**
+   * Parses every example of a CSV into a buffer, replacing its contents.
+   * Lines that don't parse are skipped, like in DataParser.
+   * @param csv_path The path of the CSV
+   * @param format The layout of the CSV
+   * @param buffer Filled with the examples in file order
+   * @throw invalid_argument exception if the file can't be opened
+   */
+  void Parse(const std::string& csv_path, DataFormat format,
+             example_buffer& buffer) const;
+
+ private:
+  ThreadPool& pool_;
+
+  /**
+   * @return The number of lines starting in [begin, end), counting a last
+   * line without a line break.
+   */
+  static size_t CountLines(const char* begin, const char* end);
+
+  /**
+   * Parses the lines in [begin, end) into consecutive slots of the buffers.
+   * @return The number of examples parsed.
+   */
+  static size_t ParseChunk(const char* begin, const char* end,
+                           DataFormat format, float* features,
+                           tiny_dnn::label_t* labels);
+
+  /**
+   * Parses a line of a numeric CSV.
+   * @return False if the line doesn't have 42 features and a label.
+   */
+  static bool ParseNumericLine(const char* begin, const char* end,
+                               float* features, tiny_dnn::label_t& label);
+
+  /**
+   * Parses a line of a string CSV, reordering the cells row by row from
+   * the top to match the numeric format.
+   * @return False if the line is empty.
+   */
+  static bool ParseStringLine(const char* begin, const char* end,
+                              float* features, tiny_dnn::label_t& label);
+
+  /**
+   * Parses a decimal number such as -1, 0 or 0.5 at the start of a field.
+   * @return A pointer just past the number, or begin if there is none.
+   */
+  static const char* ParseNumber(const char* begin, const char* end,
+                                 float& value);
+};
+
+} // namespace connect_four
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+
+#include "tiny_dnn/tiny_dnn.h"
+
+namespace connect_four {
+
+/**
+ * Adam that keeps its moment estimates between calls to network::train.
+ * tiny_dnn resets the optimizer at the start of every train call, which
+ * would throw the estimates away each time a new chunk of shuffled
+ * minibatches is trained on. The state can also be saved with a checkpoint.
+ */
+class PersistentAdam : public tiny_dnn::adam {
+ public:
+  PersistentAdam() = default;
+
+  /**
+   * Keeps the moment estimates, see ClearState to actually reset them.
+   */
+  void reset() override;
+
+  /**
+   * Forgets the moment estimates, like a fresh optimizer.
+   */
+  void ClearState();
+
+  /**
+   * Writes the learning rate, the decay terms and the moment estimates of
+   * every weight vector of a network, in the network's layer order.
+   */
+  void SaveState(std::ostream& output,
+                 tiny_dnn::network<tiny_dnn::sequential>& network);
+
+  /**
+   * Reads a state written by SaveState for a network of the same shape.
+   * Estimates are keyed by the addresses of the weights, so this must be
+   * called after the network's weights are loaded.
+   * @throw invalid_argument exception if the state is cut short or was
+   * saved for a network of a different shape
+   */
+  void LoadState(std::istream& input,
+                 tiny_dnn::network<tiny_dnn::sequential>& network);
+};
+
+} // namespace connect_four
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <core/computer_agent.h>
+#include <core/data_parser.h>
+#include <core/gameboard.h>
+#include <core/thread_pool.h>
+
+namespace connect_four {
+
+// The files PositionReader reads
+enum class PositionFormat {
+  // A CSV in DataParser's numeric layout
+  Numeric,
+  // A CSV in DataParser's string layout
+  String,
+  // One string of zero-indexed columns per line, played from the empty
+  // board. A blank line is the empty board.
+  Moves,
+};
+
+/**
+ * Reads positions one at a time from a file in any PositionFormat, so
+ * files of any size can be analyzed in constant memory.
+ */
+class PositionReader {
+ public:
+  /**
+   * @throw invalid_argument exception if the file can't be opened
+   */
+  PositionReader(const std::string& path, PositionFormat format);
+
+  /**
+   * Reads the next position.
+   * @param board Set to the position if it is valid
+   * @return False at the end of the file, true otherwise.
+   * @throw invalid_argument exception if the line isn't a valid position
+   */
+  bool Next(GameBoard& board);
+
+  /**
+   * @return The one-indexed number of the last position read, counting the
+   * lines after any header.
+   */
+  size_t GetPositionNumber() const;
+
+ private:
+  PositionFormat format_;
+  // Only the one for the format is open
+  std::unique_ptr<DataStream> csv_;
+  std::ifstream moves_;
+  DataParser parser_;
+  size_t position_number_;
+};
+
+// A struct storing the settings of an analysis
+struct analysis_options {
+  // 0 to search until the end of the game, which needs a time limit
+  size_t depth;
+  // The longest a position is searched, 0 for no limit. The first depth
+  // always completes.
+  size_t move_time_ms;
+  // 0 for one worker per hardware thread
+  size_t number_threads;
+  Evaluator evaluator;
+  // Positions read and written at a time
+  size_t batch_size;
+
+  analysis_options() : depth(8), move_time_ms(0), number_threads(0),
+      evaluator(Evaluator::Threats), batch_size(1024) {};
+};
+
+// A struct storing the totals of an analysis
+struct analysis_stats {
+  size_t positions;
+  // Lines that weren't valid positions, left out of the output
+  size_t positions_skipped;
+  size_t nodes;
+  double seconds;
+
+  analysis_stats() : positions(0), positions_skipped(0), nodes(0),
+      seconds(0) {};
+
+  /**
+   * @return The positions analyzed per second, 0 if no time was measured.
+   */
+  double CalculatePositionsPerSecond() const;
+};
+
+/**
+ * Analyzes a file of positions on a thread pool. Positions are read and
+ * written a batch at a time, and workers take the next position of a batch
+ * until it is done, each searching with its own Computer.
+ *
+ * The output is a CSV with a line per valid position, in input order:
+ * position,best_move,score,depth,nodes,pv. The position is the number from
+ * PositionReader, the score is from the perspective of the player to move
+ * and the principal variation is a string of columns like the Moves
+ * format. Finished games have a best move of none.
+ */
+class PositionAnalyzer {
+ public:
+  /**
+   * Loads one Computer per worker.
+   */
+  explicit PositionAnalyzer(const analysis_options& options);
+
+  /**
+   * Analyzes every position left in a reader.
+   * @param reader The positions to analyze
+   * @param output Where the CSV is written
+   * @return The totals of the analysis.
+   * @throw invalid_argument exception if the output can't be written
+   */
+  analysis_stats Run(PositionReader& reader, std::ostream& output);
+
+  // Getters
+  size_t GetNumberThreads() const;
+
+ private:
+  analysis_options options_;
+  ThreadPool pool_;
+  std::vector<std::unique_ptr<Computer>> computers_;
+
+  /**
+   * Searches a position with the options' limits.
+   */
+  search_result Analyze(Computer& computer, const GameBoard& board) const;
+};
+
+} // namespace connect_four
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace connect_four {
+
+// A struct storing what happened in one training step
+struct step_record {
+  size_t epoch;
+  size_t step;
+  size_t examples;
+  // Time the loader spent parsing and preparing the step's examples, which
+  // overlaps the previous step's training
+  double load_seconds;
+  // Time the trainer waited for the loader
+  double stall_seconds;
+  double train_seconds;
+  float loss;
+
+  step_record() : epoch(0), step(0), examples(0), load_seconds(0),
+      stall_seconds(0), train_seconds(0), loss(0) {};
+};
+
+// A struct storing the results of one training epoch
+struct epoch_record {
+  size_t epoch;
+  size_t examples;
+  // Percentage of test examples classified correctly
+  float test_accuracy;
+  double epoch_seconds;
+
+  epoch_record() : epoch(0), examples(0), test_accuracy(0),
+      epoch_seconds(0) {};
+};
+
+/**
+ * Writes a training run as JSON Lines, one object per step or epoch with a
+ * "type" field telling them apart, so runs can be compared and plotted
+ * without parsing console output. Every line also has the wall-clock time
+ * since the log was opened.
+ */
+class RunLog {
+ public:
+  /**
+   * Opens the log.
+   * @param is_appending Whether to add to a previous log at the path, for
+   * example when training resumes, instead of replacing it
+   * @throw invalid_argument exception if the file can't be opened
+   */
+  explicit RunLog(const std::string& log_path, bool is_appending = false);
+
+  /**
+   * Writes a step, with the examples per second of its training.
+   */
+  void LogStep(const step_record& record);
+
+  /**
+   * Writes an epoch, with the peak memory use of the process so far.
+   */
+  void LogEpoch(const epoch_record& record);
+
+  /**
+   * @return The peak resident set size of the process in bytes, or 0 if
+   * the platform can't report it.
+   */
+  static uint64_t GetPeakMemoryBytes();
+
+ private:
+  std::ofstream log_;
+  std::chrono::steady_clock::time_point start_;
+
+  /**
+   * @return The seconds since the log was opened.
+   */
+  double CalculateElapsedSeconds() const;
+};
+
+} // namespace connect_four
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <core/computer_agent.h>
+#include <core/gameboard.h>
+
+namespace connect_four {
+
+// A struct storing the totals of a bench run
+struct bench_result {
+  size_t positions;
+  // The sum of the nodes searched over every position. Any change to the
+  // search that alters its behavior alters this, so it works as a signature.
+  size_t nodes;
+  double seconds;
+
+  bench_result() : positions(0), nodes(0), seconds(0) {};
+
+  /**
+   * @return The nodes searched per second, 0 if no time was measured.
+   */
+  double CalculateNodesPerSecond() const;
+};
+
+/**
+ * Searches a fixed list of middle-game positions to a fixed depth. The
+ * search runs with the threat evaluator, which doesn't depend on a model
+ * file, and each search starts from an empty table, so the same search code
+ * always visits the same number of nodes. The node count tells whether a
+ * change altered the search, and the speed can be compared across machines
+ * and builds separately from it.
+ */
+class SearchBench {
+ public:
+  // The depth of a bench run unless another is given
+  static constexpr size_t kDefaultDepth = 13;
+
+  /**
+   * @param depth The depth every position is searched to
+   * @param algorithm The search driver to bench
+   */
+  explicit SearchBench(size_t depth = kDefaultDepth,
+                       SearchAlgorithm algorithm =
+                           SearchAlgorithm::PrincipalVariation);
+
+  /**
+   * Searches every position in turn.
+   * @param computer The computer whose search is benched
+   * @return The node count and time over all positions.
+   */
+  bench_result Run(Computer& computer) const;
+
+  /**
+   * @return The positions benched, as strings of zero-indexed columns
+   * played from the empty board.
+   */
+  static const std::vector<std::string>& GetPositions();
+
+ private:
+  search_options options_;
+};
+
+} // namespace connect_four
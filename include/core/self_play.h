@@ -0,0 +1,88 @@
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <core/computer_agent.h>
+#include <core/gameboard.h>
+
+namespace connect_four {
+
+// A struct storing the settings of a self-play run
+struct self_play_options {
+  size_t number_games;
+  // Each root move is searched to one less than this depth
+  size_t depth;
+  // Root move scores are shifted by uniform noise in [-root_noise,
+  // root_noise] so games from the same position differ
+  float root_noise;
+  // 0 for one worker per hardware thread
+  size_t number_threads;
+  Evaluator evaluator;
+  // Game i is played with seed + i, so runs are reproducible
+  unsigned int seed;
+
+  self_play_options() : number_games(100), depth(4), root_noise(0.1f),
+      number_threads(0), evaluator(Evaluator::Threats), seed(0) {};
+};
+
+// A struct storing the totals of a self-play run
+struct self_play_stats {
+  size_t games;
+  size_t positions;
+  size_t x_wins;
+  size_t draws;
+  size_t o_wins;
+  double seconds;
+
+  self_play_stats() : games(0), positions(0), x_wins(0), draws(0), o_wins(0),
+      seconds(0) {};
+};
+
+/**
+ * Generates training data by having the computer play itself. Games run
+ * concurrently on a thread pool, each worker with its own Computer, and
+ * every position of a game is labeled with the game's final result.
+ */
+class SelfPlay {
+ public:
+  explicit SelfPlay(const self_play_options& options);
+
+  /**
+   * Plays every game and streams the positions into one packed dataset
+   * shard per worker, so workers never wait on each other.
+   * @param output_prefix Shards are written to GetShardPath(prefix, shard)
+   * @return The totals of the run.
+   * @throw invalid_argument exception if a shard can't be written
+   */
+  self_play_stats Run(const std::string& output_prefix) const;
+
+  /**
+   * Plays one game from the empty board.
+   * @param computer The computer to search with
+   * @param random The source of root noise
+   * @param positions Every position reached in the game is appended
+   * @return The final state of the game.
+   */
+  BoardState PlayGame(Computer& computer, std::mt19937& random,
+                      std::vector<GameBoard>& positions) const;
+
+  /**
+   * Picks a move by searching each root move and adding noise to its score.
+   * @return The column with the best noisy score.
+   */
+  size_t ChooseMove(Computer& computer, const GameBoard& board,
+                    std::mt19937& random) const;
+
+  /**
+   * @return The path of one shard of the output.
+   */
+  static std::string GetShardPath(const std::string& output_prefix,
+                                  size_t shard);
+
+ private:
+  self_play_options options_;
+};
+
+} // namespace connect_four
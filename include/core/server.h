@@ -0,0 +1,244 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <core/computer_agent.h>
+#include <core/gameboard.h>
+#include <core/socket.h>
+#include <core/thread_pool.h>
+#include <core/transposition_table.h>
+
+namespace connect_four {
+
+/**
+ * Keeps the most recent latencies to report percentiles of, so the
+ * percentiles follow the current load and memory stays fixed. Not safe to
+ * use from several threads at once.
+ */
+class LatencyRecorder {
+ public:
+  /**
+   * @param capacity The number of most recent latencies kept
+   */
+  explicit LatencyRecorder(size_t capacity = 4096);
+
+  void Record(double milliseconds);
+
+  /**
+   * @param percentile From 0 to 100
+   * @return The smallest kept latency that at least that percent of the
+   * kept latencies are at most, 0 if none have been recorded.
+   */
+  double CalculatePercentile(double percentile) const;
+
+  // The number of latencies recorded, including those no longer kept
+  size_t GetNumberRecorded() const;
+
+ private:
+  std::vector<double> latencies_;
+  size_t capacity_;
+  size_t number_recorded_;
+};
+
+// A struct storing the settings of a server
+struct server_options {
+  // "unix:<path>" or "tcp:<port>", on the loopback interface
+  std::string address;
+  // Searches running at once, 0 for one per hardware thread
+  size_t number_threads;
+  // Connections beyond this are refused
+  size_t max_sessions;
+  // Searches that may wait for a free thread. A go beyond them is refused,
+  // so a client learns the server is overloaded instead of timing out.
+  size_t max_queue_depth;
+  // The time budget of a go without a movetime, and the most any go gets.
+  // Budgets start when the request arrives, so queueing uses them up.
+  size_t default_move_time_ms;
+  size_t max_move_time_ms;
+  // The evaluator sessions start with
+  Evaluator evaluator;
+  // Each session's transposition table holds 2^table_size_log2 entries.
+  // Once max_tables sessions hold one, the least recently used table of a
+  // session that isn't searching is dropped to make room.
+  size_t table_size_log2;
+  size_t max_tables;
+
+  server_options() : address("tcp:7474"), number_threads(0),
+      max_sessions(256), max_queue_depth(64), default_move_time_ms(100),
+      max_move_time_ms(5000), evaluator(Evaluator::NeuralNetwork),
+      table_size_log2(16), max_tables(64) {};
+};
+
+// A struct storing a snapshot of what a server is doing
+struct server_stats {
+  size_t sessions;
+  // Searches waiting for a thread, and searches running
+  size_t queue_depth;
+  size_t active_searches;
+  size_t completed_searches;
+  size_t rejected_searches;
+  size_t tables;
+  size_t evicted_tables;
+  // Milliseconds from a go arriving to its best move being sent
+  double latency_p50_ms;
+  double latency_p90_ms;
+  double latency_p99_ms;
+
+  server_stats() : sessions(0), queue_depth(0), active_searches(0),
+      completed_searches(0), rejected_searches(0), tables(0),
+      evicted_tables(0), latency_p50_ms(0), latency_p90_ms(0),
+      latency_p99_ms(0) {};
+
+  /**
+   * @return The stats as one line of the protocol.
+   */
+  std::string Format() const;
+};
+
+// A struct storing what one thread of the pool searches with
+struct search_worker {
+  Computer computer;
+  // Cleared and used by a search whose session couldn't get a table, so the
+  // computer never allocates a table of its own
+  TranspositionTable fallback_table;
+
+  explicit search_worker(size_t table_size_log2) :
+      fallback_table(table_size_log2) {};
+};
+
+// A struct storing one client's game
+struct server_session {
+  Socket socket;
+  GameBoard board;
+  Evaluator evaluator;
+  // Kept between searches, so later moves of a game reuse what earlier
+  // ones learned. Null until the first search or once evicted.
+  std::unique_ptr<TranspositionTable> table;
+  // When the session last searched, in searches since the server started
+  uint64_t last_used;
+  bool is_searching;
+  bool is_finished;
+  std::thread thread;
+
+  server_session() : evaluator(Evaluator::NeuralNetwork), last_used(0),
+      is_searching(false), is_finished(false) {};
+};
+
+/**
+ * Serves many games at once over a local socket, each connection being one
+ * session with its own board. Sessions speak a subset of the engine
+ * protocol, one command per line:
+ *
+ *   isready                        replies readyok
+ *   position [moves]               sets the session's board
+ *   setoption evaluator <network|threats>
+ *   go [depth <plies>] [movetime <ms>]
+ *                                  replies with the info line of the last
+ *                                  complete depth and a bestmove line, or
+ *                                  with busy if the queue is full
+ *   stats                          replies with a stats line
+ *   quit                           closes the session
+ *
+ * Searches from every session share one thread pool, and use MTD(f) so
+ * each session's transposition table carries over between its moves.
+ */
+class Server {
+ public:
+  /**
+   * Loads a computer and a fallback table for each thread.
+   */
+  explicit Server(const server_options& options);
+
+  /**
+   * Stops the server if it is running.
+   */
+  ~Server();
+
+  Server(const Server&) = delete;
+  Server& operator=(const Server&) = delete;
+
+  /**
+   * Starts accepting connections on a background thread.
+   * @throw invalid_argument exception if the address can't be listened on
+   */
+  void Start();
+
+  /**
+   * Stops accepting connections, closes every session and waits for them.
+   */
+  void Stop();
+
+  server_stats GetStats() const;
+
+  // The address being listened on, with the port filled in
+  std::string GetAddress() const;
+
+ private:
+  server_options options_;
+  ThreadPool pool_;
+  Socket listener_;
+  std::thread accept_thread_;
+
+  // Guards everything below it
+  mutable std::mutex mutex_;
+  std::list<std::shared_ptr<server_session>> sessions_;
+  // Workers not searching, one per thread in total
+  std::vector<std::unique_ptr<search_worker>> workers_;
+  std::vector<search_worker*> free_workers_;
+  size_t queue_depth_;
+  size_t active_searches_;
+  size_t completed_searches_;
+  size_t rejected_searches_;
+  size_t tables_;
+  size_t evicted_tables_;
+  uint64_t number_searches_;
+  LatencyRecorder latencies_;
+  bool is_running_;
+
+  /**
+   * Accepts connections until the listener is shut down.
+   */
+  void RunAccept();
+
+  /**
+   * Handles one session's commands until it quits or disconnects.
+   */
+  void RunSession(std::shared_ptr<server_session> session);
+
+  /**
+   * Queues a search for the session, waits for it and replies.
+   */
+  void Go(server_session& session, const std::string& arguments);
+
+  /**
+   * Runs on the pool: searches with a free worker and the session's table,
+   * or the worker's fallback table if every table is in use.
+   */
+  search_result Search(server_session& session, search_options options);
+
+  /**
+   * Gives the session a table if it has none, evicting the least recently
+   * used one if the limit is reached. Called with the mutex held.
+   * @return False if every table is in use by a search.
+   */
+  bool AcquireTable(server_session& session);
+
+  /**
+   * Drops a session's table, if it has one. Called with the mutex held.
+   */
+  void ReleaseTable(server_session& session);
+
+  /**
+   * Joins and forgets sessions that have ended. Called with the mutex held.
+   */
+  void ReapSessions();
+};
+
+} // namespace connect_four
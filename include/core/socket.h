@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+
+namespace connect_four {
+
+/**
+ * A connected or listening stream socket that reads and writes whole lines.
+ * Addresses are "unix:<path>" for a Unix domain socket, or "tcp:<port>" for
+ * a TCP socket on the loopback interface, so nothing is reachable from
+ * other machines. Only available on POSIX systems.
+ */
+class Socket {
+ public:
+  /**
+   * Creates a socket that isn't open.
+   */
+  Socket();
+
+  /**
+   * Takes ownership of an open file descriptor.
+   */
+  explicit Socket(int descriptor);
+
+  /**
+   * Closes the socket if it is open.
+   */
+  ~Socket();
+
+  Socket(Socket&& other);
+  Socket& operator=(Socket&& other);
+  Socket(const Socket&) = delete;
+  Socket& operator=(const Socket&) = delete;
+
+  /**
+   * Starts listening for connections.
+   * @param address Where to listen. Port 0 picks a free port, and an
+   * existing Unix socket file is replaced.
+   * @throw invalid_argument exception if the address isn't valid or can't
+   * be listened on
+   */
+  static Socket Listen(const std::string& address);
+
+  /**
+   * Connects to a listening socket.
+   * @throw invalid_argument exception if the address isn't valid or nothing
+   * is listening on it
+   */
+  static Socket Connect(const std::string& address);
+
+  /**
+   * Waits for the next connection to a listening socket.
+   * @return The connection, which isn't open if the socket was shut down.
+   */
+  Socket Accept();
+
+  /**
+   * Reads the next line, without its line ending.
+   * @return False once the other side has closed the connection.
+   */
+  bool ReadLine(std::string& line);
+
+  /**
+   * Writes a line and its line ending.
+   * @return False if the other side has closed the connection.
+   */
+  bool WriteLine(const std::string& line);
+
+  /**
+   * Ends the connection in both directions, waking any thread blocked
+   * reading from or accepting on the socket. The socket stays open until it
+   * is destroyed.
+   */
+  void Shutdown();
+
+  /**
+   * @return The address the socket listens on, with the port filled in.
+   */
+  std::string GetAddress() const;
+
+  bool IsOpen() const;
+
+ private:
+  int descriptor_;
+  // Bytes read past the end of the last line
+  std::string buffer_;
+
+  void Close();
+};
+
+} // namespace connect_four
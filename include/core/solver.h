@@ -0,0 +1,161 @@
+#pragma once
+
+#include <string>
+
+#include <core/data_parser.h>
+#include <core/gameboard.h>
+#include <core/transposition_table.h>
+
+namespace connect_four {
+
+// A struct storing the exact result of a position under perfect play
+struct solve_result {
+  // Positive if the player to move wins, 22 minus the number of pieces the
+  // winner plays in total, so faster wins score higher. 0 for a draw.
+  int score;
+  // The number of plies until the game ends
+  size_t depth;
+  // The final state of the game
+  BoardState outcome;
+  // Nodes visited by the solve
+  size_t nodes;
+
+  solve_result() : score(0), depth(0), outcome(BoardState::Tie), nodes(0) {};
+};
+
+/**
+ * An exact solver that plays every line to the end. It runs a sequence of
+ * null-window negamax searches that narrow in on the exact score, backed by
+ * a transposition table that many solvers on different threads can share.
+ */
+class Solver {
+ public:
+  // Number of cells, and so the maximum length of a game
+  static constexpr int kNumberCells = GameBoard::kWidth * GameBoard::kHeight;
+
+  /**
+   * Creates a solver using a table that may be shared with other solvers.
+   */
+  explicit Solver(SharedTranspositionTable& table);
+
+  /**
+   * Solves a position exactly.
+   * @param board A constant board reference, which can be over
+   * @return The score, depth and outcome under perfect play.
+   */
+  solve_result Solve(const GameBoard& board);
+
+  /**
+   * Works out how many plies a game lasts from an exact score.
+   * @param score The score from the perspective of the player to move
+   * @param number_moves The number of pieces already played
+   * @return The number of plies until the game ends.
+   */
+  static size_t CalculateDepth(int score, int number_moves);
+
+ private:
+  SharedTranspositionTable& table_;
+  // Nodes visited by the current solve
+  size_t nodes_;
+
+  /**
+   * Null-window friendly negamax with alpha-beta pruning. Only moves that
+   * don't lose right away are searched, so it assumes the player to move
+   * can't win right away.
+   * @param board A constant board reference
+   * @param alpha The lower bound from the player to move's perspective
+   * @param beta The upper bound from the player to move's perspective
+   * @return The score, exact if it lies inside the window, otherwise a
+   * bound on the side of the window it fell.
+   */
+  int Negamax(const GameBoard& board, int alpha, int beta);
+};
+
+// A struct storing the settings of a dataset solve
+struct dataset_solver_options {
+  // 0 for one solver per hardware thread
+  size_t number_threads;
+  // The shared table holds 2^table_size_log2 entries of 8 bytes
+  size_t table_size_log2;
+  // Examples solved between checkpoints
+  size_t batch_size;
+
+  dataset_solver_options() : number_threads(0), table_size_log2(24),
+      batch_size(1024) {};
+};
+
+// A struct storing the totals of a dataset solve
+struct dataset_solver_stats {
+  // The example the run started from, past 1 if it resumed a checkpoint
+  size_t first_example;
+  size_t examples_solved;
+  // Examples that weren't valid positions, left out of the output
+  size_t examples_skipped;
+  size_t nodes;
+  double seconds;
+
+  dataset_solver_stats() : first_example(1), examples_solved(0),
+      examples_skipped(0), nodes(0), seconds(0) {};
+};
+
+/**
+ * Relabels a dataset with exact results. Each batch of examples is solved
+ * by one Solver per thread, all sharing one transposition table, and the
+ * output and a checkpoint are written after each batch so an interrupted
+ * run can resume where it stopped.
+ *
+ * The output is a numeric CSV with the winner under perfect play in place
+ * of the original label, followed by the solve depth in plies. DataParser
+ * reads it like any numeric CSV and ignores the depth.
+ */
+class DatasetSolver {
+ public:
+  explicit DatasetSolver(const dataset_solver_options& options);
+
+  /**
+   * Solves every example left in a stream. If a checkpoint for the output
+   * exists the stream is moved past the examples it covers and the output
+   * is continued, otherwise the output is started over.
+   * @param stream The dataset to solve
+   * @param output_path The path of the labeled CSV
+   * @return The totals of this run.
+   * @throw invalid_argument exception if a file can't be read or written
+   */
+  dataset_solver_stats Run(DataStream& stream, const std::string& output_path);
+
+  /**
+   * Builds the board an example describes. X moves first, so it is X's
+   * turn when both players have played the same number of pieces.
+   * @param features The 42 model inputs of an example
+   * @throw invalid_argument exception if the position is invalid
+   */
+  static GameBoard CreateBoard(const float* features);
+
+  /**
+   * @return The path of the checkpoint file for an output.
+   */
+  static std::string GetCheckpointPath(const std::string& output_path);
+
+ private:
+  dataset_solver_options options_;
+  SharedTranspositionTable table_;
+
+  /**
+   * Reads a checkpoint.
+   * @param next_example Set to the first example that wasn't solved
+   * @param output_size Set to the size of the output up to that example
+   * @return False if there is no checkpoint, true otherwise.
+   */
+  static bool ReadCheckpoint(const std::string& checkpoint_path,
+                             size_t& next_example, size_t& output_size);
+
+  /**
+   * Replaces the checkpoint, writing it to a temporary file first so an
+   * interruption never leaves a partial checkpoint.
+   * @throw invalid_argument exception if the file can't be written
+   */
+  static void WriteCheckpoint(const std::string& checkpoint_path,
+                              size_t next_example, size_t output_size);
+};
+
+} // namespace connect_four
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace connect_four {
+
+/**
+ * A fixed set of worker threads that run submitted tasks in the order they
+ * were submitted. Destroying the pool finishes the queued tasks first.
+ */
+class ThreadPool {
+ public:
+  /**
+   * Starts the workers.
+   * @param number_threads The number of workers, or 0 for one per hardware
+   * thread
+   */
+  explicit ThreadPool(size_t number_threads = 0);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * Queues a task for the next free worker.
+   * @param task A callable taking no arguments
+   * @return A future holding the task's result, or the exception it threw.
+   */
+  template <typename Task>
+  std::future<typename std::result_of<Task()>::type> Submit(Task task);
+
+  // Getters
+  size_t GetNumberThreads() const;
+
+ private:
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable task_available_;
+  bool is_stopping_;
+
+  /**
+   * Runs queued tasks until the pool is stopping and the queue is empty.
+   */
+  void RunWorker();
+};
+
+template <typename Task>
+std::future<typename std::result_of<Task()>::type> ThreadPool::Submit(
+    Task task) {
+  typedef typename std::result_of<Task()>::type Result;
+
+  // std::function needs a copyable callable, so share the packaged task
+  auto packaged = std::make_shared<std::packaged_task<Result()>>(task);
+  std::future<Result> result = packaged->get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push([packaged]() { (*packaged)(); });
+  }
+  task_available_.notify_one();
+  return result;
+}
+
+} // namespace connect_four
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <core/gameboard.h>
+
+namespace connect_four {
+
+/**
+ * A handcrafted evaluator that scores positions from bitboards instead of
+ * the neural network. It counts open threes, threats by row parity and
+ * center control, and takes tens of nanoseconds per position.
+ */
+class ThreatEvaluator {
+ public:
+  // Weights of the features, from the perspective of the player they favor.
+  // The first player wants threats on odd rows (counting from 1 at the
+  // bottom) and the second player on even rows, since zugzwang at the end
+  // of the game lets them claim those squares.
+  const float kOpenThreeWeight = 0.1f;
+  const float kGoodThreatWeight = 0.5f;
+  const float kBadThreatWeight = 0.2f;
+  const float kCenterWeight = 0.05f;
+
+  ThreatEvaluator() = default;
+
+  /**
+   * Gives an evaluation from -1 to 1 from the specified player's perspective,
+   * matching the range of Computer::FloatEvaluateBoard.
+   * @param board A constant board reference
+   * @param is_x_perspective Whether the score is from X's perspective
+   * @return A float value from -1 to 1 representing the evaluation.
+   */
+  float EvaluateBoard(const GameBoard& board, bool is_x_perspective) const;
+
+  /**
+   * Counts the set bits of a bitboard.
+   */
+  static int CountBits(uint64_t bits);
+
+ private:
+  // Masks in GameBoard's bitboard layout of 7 bits per column
+  // Cells in rows 1, 3 and 5 counting from the bottom
+  const uint64_t kOddRowsMask = 0x15ULL * 0x40810204081ULL;
+  // Cells in the center column
+  const uint64_t kCenterMask = 0x3FULL << 21;
+};
+
+} // namespace connect_four
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <core/persistent_adam.h>
+
+#include "tiny_dnn/tiny_dnn.h"
+
+namespace connect_four {
+
+// A struct storing where training is, so it can continue from there
+struct training_state {
+  // The zero-indexed epoch being trained
+  size_t epoch;
+  // The number of examples of the epoch already trained on
+  size_t position;
+  // The minibatch size, which has to stay the same for the position to
+  // line up with the same minibatches
+  size_t batch_size;
+  // The sampler's seed and whether it mirrors examples, which decide the
+  // order of every epoch's examples
+  unsigned int seed;
+  bool is_mirrored;
+  // The best test accuracy of any finished epoch, as a percentage
+  float best_accuracy;
+
+  training_state() : epoch(0), position(0), batch_size(0), seed(0),
+      is_mirrored(false), best_accuracy(0) {};
+};
+
+/**
+ * Saves and restores training runs: the network, the optimizer and the
+ * training state. The network is written to one of two model files in
+ * turn, and the state file, naming the current model file, is replaced
+ * only once that model is complete, so an interruption at any point leaves
+ * the previous checkpoint intact.
+ */
+class TrainingCheckpoint {
+ public:
+  /**
+   * @param checkpoint_path The path of the state file, with the model files
+   * next to it
+   */
+  explicit TrainingCheckpoint(const std::string& checkpoint_path);
+
+  /**
+   * Writes a checkpoint, replacing the previous one.
+   * @throw invalid_argument exception if a file can't be written
+   */
+  void Save(tiny_dnn::network<tiny_dnn::sequential>& network,
+            PersistentAdam& optimizer, const training_state& state);
+
+  /**
+   * Restores the last checkpoint written to the path.
+   * @return False if there is no checkpoint, true otherwise.
+   * @throw invalid_argument exception if the checkpoint is damaged
+   */
+  bool Load(tiny_dnn::network<tiny_dnn::sequential>& network,
+            PersistentAdam& optimizer, training_state& state);
+
+ private:
+  // Written at the start of state files to recognize them
+  static constexpr uint32_t kMagic = 0x4B433443;
+  static constexpr uint32_t kVersion = 2;
+
+  std::string checkpoint_path_;
+  // Counts the checkpoints written, and picks the model file to use next
+  uint64_t generation_;
+
+  /**
+   * @return The path of the model file used by a generation.
+   */
+  std::string GetModelPath(uint64_t generation) const;
+};
+
+} // namespace connect_four
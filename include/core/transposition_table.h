@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace connect_four {
+
+// A struct storing what a search learned about a position: bounds on its
+// value from the perspective of the player to move, the depth they were
+// searched to and the best column found
+struct table_entry {
+  uint64_t key;
+  float lower_bound;
+  float upper_bound;
+  uint8_t depth;
+  uint8_t column;
+  // The table's generation when the entry was stored, set by the table
+  uint8_t generation;
+
+  table_entry() : key(0), lower_bound(0), upper_bound(0), depth(0),
+      column(0), generation(0) {};
+};
+
+/**
+ * A fixed-size hash table of searched positions, indexed by GameBoard keys.
+ * Colliding entries are always replaced by the newest one. Clearing starts a
+ * new generation instead of touching every entry, and entries from earlier
+ * generations are never found.
+ */
+class TranspositionTable {
+ public:
+  /**
+   * Creates an empty table.
+   * @param size_log2 The table holds 2^size_log2 entries
+   */
+  explicit TranspositionTable(size_t size_log2 = 20);
+
+  /**
+   * Looks up a position.
+   * @param key The key of the position
+   * @param entry Filled with the stored entry if one is found
+   * @return True if the position is in the table, false otherwise.
+   */
+  bool Probe(uint64_t key, table_entry& entry) const;
+
+  /**
+   * Stores an entry, replacing whatever is in its slot.
+   */
+  void Store(const table_entry& entry);
+
+  /**
+   * Removes every entry from the table. Only every 256th clear writes to
+   * the entries, when the generation wraps around.
+   */
+  void Clear();
+
+  // Getters
+  size_t GetCapacity() const;
+
+ private:
+  std::vector<table_entry> entries_;
+  // Stamped on stored entries, and checked when probing
+  uint8_t generation_;
+  // Number of bits of the hashed key used as the index
+  size_t size_log2_;
+
+  /**
+   * Finds the slot for a key by hashing it, since the low bits of GameBoard
+   * keys are poorly distributed.
+   */
+  size_t CalculateIndex(uint64_t key) const;
+};
+
+// A struct storing bounds on the exact score of a solved position, from the
+// perspective of the player to move
+struct solved_bounds {
+  int lower_bound;
+  int upper_bound;
+
+  solved_bounds() : lower_bound(0), upper_bound(0) {};
+  solved_bounds(int lower, int upper) : lower_bound(lower),
+      upper_bound(upper) {};
+};
+
+/**
+ * A fixed-size hash table of solved positions that many threads can probe
+ * and store into at once. Each entry packs a 49-bit key and both bounds into
+ * a single atomic word, so entries are never torn and no locks are needed.
+ * Colliding entries are always replaced by the newest one.
+ */
+class SharedTranspositionTable {
+ public:
+  // Bounds are stored offset by this, in 7 bits each
+  static constexpr int kBoundOffset = 64;
+
+  /**
+   * Creates an empty table.
+   * @param size_log2 The table holds 2^size_log2 entries of 8 bytes
+   */
+  explicit SharedTranspositionTable(size_t size_log2 = 24);
+
+  /**
+   * Looks up a position.
+   * @param key The key of the position, at most 49 bits
+   * @param bounds Filled with the stored bounds if they are found
+   * @return True if the position is in the table, false otherwise.
+   */
+  bool Probe(uint64_t key, solved_bounds& bounds) const;
+
+  /**
+   * Stores the bounds of a position, replacing whatever is in its slot.
+   * @param bounds Bounds between -kBoundOffset and kBoundOffset
+   */
+  void Store(uint64_t key, const solved_bounds& bounds);
+
+  /**
+   * Removes every entry from the table. Not safe to call during searches.
+   */
+  void Clear();
+
+  // Getters
+  size_t GetCapacity() const;
+
+ private:
+  // Keys take the low 49 bits of an entry and the bounds the next 14
+  static constexpr uint64_t kKeyMask = (uint64_t(1) << 49) - 1;
+
+  std::unique_ptr<std::atomic<uint64_t>[]> entries_;
+  size_t size_log2_;
+
+  /**
+   * Finds the slot for a key with the same hash as TranspositionTable.
+   */
+  size_t CalculateIndex(uint64_t key) const;
+};
+
+} // namespace connect_four
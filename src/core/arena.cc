@@ -0,0 +1,276 @@
+#include <core/arena.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
+#include <core/thread_pool.h>
+
+namespace connect_four {
+
+namespace {
+
+// The Elo difference at which the stronger player scores a given fraction
+// of the points
+double ConvertScoreToElo(double score) {
+  if (score <= 0) {
+    return -std::numeric_limits<double>::infinity();
+  }
+  if (score >= 1) {
+    return std::numeric_limits<double>::infinity();
+  }
+  // Negating log10(1) would print an even score as -0
+  return 400 * std::log10(score / (1 - score));
+}
+
+double ConvertEloToScore(double elo) {
+  return 1 / (1 + std::pow(10, -elo / 400));
+}
+
+// The smallest variance of one game's points the test assumes
+const double kMinimumVariance = 0.01;
+
+// The variance of one game's points around the mean score
+double CalculateVariance(const arena_stats& stats) {
+  double score = stats.CalculateScore();
+  return (stats.wins * std::pow(1 - score, 2) +
+          stats.draws * std::pow(0.5 - score, 2) +
+          stats.losses * std::pow(score, 2)) / stats.GetNumberGames();
+}
+
+} // namespace
+
+size_t arena_stats::GetNumberGames() const {
+  return wins + draws + losses;
+}
+
+double arena_stats::CalculateScore() const {
+  if (GetNumberGames() == 0) {
+    return 0.5;
+  }
+  return (wins + 0.5 * draws) / GetNumberGames();
+}
+
+double arena_stats::CalculateEloDifference() const {
+  return ConvertScoreToElo(CalculateScore());
+}
+
+double arena_stats::CalculateEloError() const {
+  size_t games = GetNumberGames();
+  if (games == 0) {
+    return 0;
+  }
+
+  double score = CalculateScore();
+  double variance = CalculateVariance(*this);
+  if (variance == 0) {
+    return 0;
+  }
+
+  // 1.96 standard errors either side covers 95%
+  double error = 1.96 * std::sqrt(variance / games);
+  double upper = ConvertScoreToElo(std::min(score + error, 1.0));
+  double lower = ConvertScoreToElo(std::max(score - error, 0.0));
+  return (upper - lower) / 2;
+}
+
+double arena_stats::CalculateLogLikelihoodRatio(
+    const sprt_options& sprt) const {
+  size_t games = GetNumberGames();
+  if (games == 0) {
+    return 0;
+  }
+
+  // A run of identical results has no variance, so floor it to let such a
+  // one-sided match still reach a decision
+  double score = CalculateScore();
+  double variance = std::max(CalculateVariance(*this), kMinimumVariance);
+
+  double score_0 = ConvertEloToScore(sprt.elo_0);
+  double score_1 = ConvertEloToScore(sprt.elo_1);
+  return games * (score_1 - score_0) * (2 * score - score_0 - score_1) /
+         (2 * variance);
+}
+
+SprtResult arena_stats::CalculateSprtResult(const sprt_options& sprt) const {
+  double ratio = CalculateLogLikelihoodRatio(sprt);
+  if (ratio >= std::log((1 - sprt.beta) / sprt.alpha)) {
+    return SprtResult::AcceptH1;
+  }
+  if (ratio <= std::log(sprt.beta / (1 - sprt.alpha))) {
+    return SprtResult::AcceptH0;
+  }
+  return SprtResult::Continue;
+}
+
+Arena::Arena(const player_config& first, const player_config& second)
+    : first_(first), second_(second) {
+}
+
+arena_stats Arena::Run(
+    const arena_options& options,
+    const std::function<void(const arena_stats&)>& on_pair) const {
+  auto start = std::chrono::steady_clock::now();
+  if (options.openings.empty()) {
+    throw std::invalid_argument("There are no openings");
+  }
+  std::vector<GameBoard> openings;
+  for (const std::string& moves : options.openings) {
+    openings.push_back(GameBoard::FromMoves(moves));
+  }
+  std::unique_ptr<GameRecordWriter> writer;
+  if (!options.record_path.empty()) {
+    writer.reset(new GameRecordWriter(options.record_path, "arena"));
+  }
+
+  arena_stats stats;
+  std::mutex stats_mutex;
+  std::atomic<size_t> next_pair(0);
+  std::atomic<bool> is_decided(false);
+
+  auto worker = [&]() {
+    // The players may load different models, so each needs a Computer
+    Computer first_computer(first_.model_path);
+    Computer second_computer(second_.model_path);
+
+    for (size_t pair = next_pair++;
+         pair < options.number_game_pairs && !is_decided;
+         pair = next_pair++) {
+      size_t opening_index = pair % openings.size();
+      const GameBoard& opening = openings[opening_index];
+      // Records start from the empty board, so they begin with the opening
+      game_record records[2];
+      for (game_record& record : records) {
+        for (char move : options.openings[opening_index]) {
+          record.moves.push_back(static_cast<uint8_t>(move - '0'));
+        }
+      }
+      BoardState results[2] = {
+          PlayGame(first_computer, second_computer, opening, true,
+                   &records[0]),
+          PlayGame(first_computer, second_computer, opening, false,
+                   &records[1])};
+
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      if (writer) {
+        writer->Write(records[0]);
+        writer->Write(records[1]);
+      }
+      for (size_t game = 0; game < 2; game++) {
+        BoardState first_win = game == 0 ? BoardState::Xwins
+                                         : BoardState::Owins;
+        if (results[game] == first_win) {
+          stats.wins++;
+        } else if (results[game] == BoardState::Tie) {
+          stats.draws++;
+        } else {
+          stats.losses++;
+        }
+      }
+      stats.seconds = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+
+      if (options.sprt.is_enabled &&
+          stats.CalculateSprtResult(options.sprt) != SprtResult::Continue) {
+        is_decided = true;
+      }
+      if (on_pair) {
+        on_pair(stats);
+      }
+    }
+  };
+
+  ThreadPool pool(options.number_threads);
+  std::vector<std::future<void>> workers;
+  for (size_t thread = 0; thread < pool.GetNumberThreads(); thread++) {
+    workers.push_back(pool.Submit(worker));
+  }
+  for (std::future<void>& future : workers) {
+    future.get();
+  }
+  if (writer) {
+    writer->Close();
+  }
+
+  stats.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return stats;
+}
+
+BoardState Arena::PlayGame(Computer& first_computer,
+                           Computer& second_computer,
+                           const GameBoard& opening, bool is_first_x,
+                           game_record* record) const {
+  GameBoard board = opening;
+  while (board.GetGameState() == BoardState::InProgress) {
+    size_t column;
+    if (board.GetIsXTurn() == is_first_x) {
+      column = ChooseMove(first_computer, first_, board);
+    } else {
+      column = ChooseMove(second_computer, second_, board);
+    }
+    board.DropPiece(column);
+    if (record) {
+      record->moves.push_back(static_cast<uint8_t>(column));
+    }
+  }
+  if (record) {
+    record->result = board.GetGameState();
+  }
+  return board.GetGameState();
+}
+
+std::vector<std::string> Arena::GenerateOpenings(size_t plies,
+                                                 float max_score) {
+  // Judged by a fixed search, so the set never depends on a model
+  Computer computer;
+  search_options judge(4, SearchAlgorithm::PrincipalVariation,
+                       Evaluator::Threats);
+
+  std::vector<std::string> openings;
+  std::unordered_set<uint64_t> seen;
+  std::vector<std::string> frontier = {""};
+  for (size_t ply = 0; ply < plies; ply++) {
+    std::vector<std::string> next_frontier;
+    for (const std::string& moves : frontier) {
+      GameBoard board = GameBoard::FromMoves(moves);
+      for (size_t column = 0; column < GameBoard::kWidth; column++) {
+        GameBoard child = board;
+        if (!child.DropPiece(column) ||
+            child.GetGameState() != BoardState::InProgress ||
+            !seen.insert(child.GetCanonicalKey()).second) {
+          continue;
+        }
+        next_frontier.push_back(moves + static_cast<char>('0' + column));
+      }
+    }
+    frontier.swap(next_frontier);
+  }
+
+  for (const std::string& moves : frontier) {
+    search_result result = computer.Search(GameBoard::FromMoves(moves),
+                                           judge);
+    if (std::fabs(result.score) <= max_score) {
+      openings.push_back(moves);
+    }
+  }
+  return openings;
+}
+
+size_t Arena::ChooseMove(Computer& computer, const player_config& config,
+                         const GameBoard& board) {
+  search_options options(Computer::CapDepth(board, config.depth),
+                         config.algorithm, config.evaluator);
+  if (config.move_time_ms > 0) {
+    options.deadline = std::chrono::steady_clock::now() +
+                       std::chrono::milliseconds(config.move_time_ms);
+  }
+  return computer.Search(board, options).column;
+}
+
+} // namespace connect_four
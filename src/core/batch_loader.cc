@@ -0,0 +1,107 @@
+#include <core/batch_loader.h>
+
+#include <chrono>
+#include <utility>
+
+namespace connect_four {
+
+BatchLoader::BatchLoader(BatchSource source)
+    : source_(source), is_ready_(false), is_finished_(false),
+      is_stopping_(false), stall_seconds_(0), ready_load_seconds_(0),
+      load_seconds_(0) {
+  // Start the thread last, once every member it reads is initialized
+  loader_ = std::thread(&BatchLoader::RunLoader, this);
+}
+
+BatchLoader::~BatchLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  state_changed_.notify_all();
+  loader_.join();
+}
+
+bool BatchLoader::Next(training_batch& batch) {
+  auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  state_changed_.wait(lock, [this]() { return is_ready_ || is_finished_; });
+  stall_seconds_ += std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  if (!is_ready_) {
+    if (error_) {
+      std::exception_ptr error = error_;
+      error_ = nullptr;
+      std::rethrow_exception(error);
+    }
+    return false;
+  }
+
+  batch = std::move(ready_batch_);
+  load_seconds_ = ready_load_seconds_;
+  is_ready_ = false;
+  lock.unlock();
+
+  // Free the slot so the loader can hand over the batch it's preparing
+  state_changed_.notify_all();
+  return true;
+}
+
+double BatchLoader::GetStallSeconds() const {
+  return stall_seconds_;
+}
+
+void BatchLoader::ResetStallTime() {
+  stall_seconds_ = 0;
+}
+
+double BatchLoader::GetLoadSeconds() const {
+  return load_seconds_;
+}
+
+void BatchLoader::RunLoader() {
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (is_stopping_) {
+        return;
+      }
+    }
+
+    // Prepare outside the lock so the trainer can take the ready batch
+    training_batch batch;
+    bool has_batch = false;
+    std::exception_ptr error;
+    auto start = std::chrono::steady_clock::now();
+    try {
+      has_batch = source_(batch);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    double load_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!has_batch) {
+      error_ = error;
+      is_finished_ = true;
+      lock.unlock();
+      state_changed_.notify_all();
+      return;
+    }
+
+    // Wait for the trainer to take the previous batch
+    state_changed_.wait(lock, [this]() { return !is_ready_ || is_stopping_; });
+    if (is_stopping_) {
+      return;
+    }
+    ready_batch_ = std::move(batch);
+    ready_load_seconds_ = load_seconds;
+    is_ready_ = true;
+    lock.unlock();
+    state_changed_.notify_all();
+  }
+}
+
+} // namespace connect_four
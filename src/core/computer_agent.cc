@@ -2,8 +2,13 @@
 
 namespace connect_four {
 
-Computer::Computer() {
-  model_.load("net_2");
+constexpr size_t Computer::kMaxPly;
+constexpr size_t Computer::kDeadlineInterval;
+
+constexpr const char* Computer::kDefaultModelPath;
+
+Computer::Computer(const std::string& model_path) {
+  model_.load(model_path);
 }
 
 float Computer::FloatEvaluateBoard(const GameBoard &board,
@@ -19,6 +24,21 @@ float Computer::FloatEvaluateBoard(const GameBoard &board,
   return red_score;
 }
 
+float Computer::FloatEvaluateBoard(const GameBoard &board,
+                                   bool is_x_perspective,
+                                   Evaluator evaluator) {
+  if (evaluator == Evaluator::Threats) {
+    return threat_evaluator_.EvaluateBoard(board, is_x_perspective);
+  }
+
+  // The network isn't exactly symmetric, so evaluate the orientation with
+  // the canonical key
+  if (board.GetCanonicalKey() != board.GetKey()) {
+    return FloatEvaluateBoard(board.Mirror(), is_x_perspective);
+  }
+  return FloatEvaluateBoard(board, is_x_perspective);
+}
+
 tiny_dnn::vec_t Computer::VectorEvaluateBoard(const GameBoard &board) {
   return model_.predict(board.GenerateVectorFeatures());
 }
@@ -30,6 +50,7 @@ move_evaluation_pair Computer::MiniMaxSearch(const GameBoard &board,
                                              bool is_computer_x,
                                              bool maximizing_player) {
 
+  nodes_++;
   BoardState state = board.GetGameState();
 
   // Check if the game is over
@@ -49,10 +70,10 @@ move_evaluation_pair Computer::MiniMaxSearch(const GameBoard &board,
 
   // Check if depth is zero
   if (depth == 0) {
-    return {0, FloatEvaluateBoard(board, is_computer_x)};
+    return {0, FloatEvaluateBoard(board, is_computer_x, evaluator_)};
   }
 
-  std::vector<size_t> valid_moves = board.CalculateValidColumns();
+  MoveList valid_moves = board.CalculateValidColumns();
 
   if (maximizing_player) {
     float value = -100;
@@ -107,5 +128,487 @@ move_evaluation_pair Computer::MiniMaxSearch(const GameBoard &board,
   }
 }
 
-} // namespace connect_four
+search_result Computer::Search(const GameBoard &board, size_t depth) {
+  return Search(board, search_options(depth));
+}
+
+search_result Computer::Search(const GameBoard &board,
+                               const search_options &options) {
+  nodes_ = 0;
+  evaluator_ = options.evaluator;
+  stop_ = options.stop;
+  deadline_ = options.deadline;
+  is_stoppable_ = false;
+  is_stopped_ = false;
+  search_result result;
+
+  switch (options.algorithm) {
+    case SearchAlgorithm::AlphaBeta: {
+      move_evaluation_pair best = MiniMaxSearch(board, options.depth,
+                                                -kAlphaBeta, kAlphaBeta,
+                                                board.GetIsXTurn(), true);
+      result.score = best.score;
+      if (!board.CalculateValidColumns().empty() && options.depth > 0) {
+        result.column = best.column;
+        result.principal_variation.push_back(best.column);
+      }
+      result.nodes = nodes_;
+      result.depth = options.depth;
+      break;
+    }
+    case SearchAlgorithm::Mtdf:
+      result = MtdfSearch(board, options);
+      break;
+    default:
+      result = AspirationSearch(board, options);
+  }
+
+  // Direct calls to MiniMaxSearch keep using the network
+  evaluator_ = Evaluator::NeuralNetwork;
+  is_stoppable_ = false;
+  return result;
+}
+
+search_result Computer::SearchWindow(const GameBoard &board,
+                                     const search_options &options,
+                                     float alpha, float beta,
+                                     const std::vector<size_t> &previous_pv) {
+  nodes_ = 0;
+  evaluator_ = options.evaluator;
+  stop_ = options.stop;
+  deadline_ = options.deadline;
+  is_stoppable_ = true;
+  is_stopped_ = false;
+  previous_pv_ = previous_pv;
+
+  search_result result;
+  result.score = PrincipalVariationSearch(board, options.depth, 0, alpha,
+                                          beta);
+  result.principal_variation.assign(pv_table_[0],
+                                    pv_table_[0] + pv_length_[0]);
+  if (!result.principal_variation.empty()) {
+    result.column = result.principal_variation[0];
+  }
+  result.depth = options.depth;
+  result.nodes = nodes_;
+
+  evaluator_ = Evaluator::NeuralNetwork;
+  is_stoppable_ = false;
+  return result;
+}
+
+size_t Computer::CapDepth(const GameBoard &board, size_t depth) {
+  size_t remaining = kMaxPly - static_cast<size_t>(
+      ThreatEvaluator::CountBits(board.GetOccupiedBitboard()));
+  return depth == 0 ? remaining : std::min(depth, remaining);
+}
+
+search_result Computer::AspirationSearch(const GameBoard &board,
+                                         const search_options &options) {
+  search_result result;
+  previous_pv_.clear();
+
+  for (size_t iteration = 1; iteration <= options.depth; iteration++) {
+    // The first iteration always completes so there is a move to play
+    if (iteration == 2) {
+      is_stoppable_ = true;
+    }
+
+    // Search the first iteration with a full window, then narrow the window
+    // around the previous score
+    float alpha = -kAlphaBeta;
+    float beta = kAlphaBeta;
+    if (iteration > 1) {
+      alpha = result.score - kAspirationWindow;
+      beta = result.score + kAspirationWindow;
+    }
+
+    float score = PrincipalVariationSearch(board, iteration, 0,
+                                           alpha, beta);
+
+    // The true score is outside the aspiration window, so re-search
+    if (score <= alpha || score >= beta) {
+      score = PrincipalVariationSearch(board, iteration, 0,
+                                       -kAlphaBeta, kAlphaBeta);
+    }
+    if (is_stopped_) {
+      break;
+    }
+
+    // The game is already over
+    if (board.GetGameState() != BoardState::InProgress) {
+      result.score = score;
+      result.depth = iteration;
+      break;
+    }
+
+    std::vector<size_t> pv(pv_table_[0], pv_table_[0] + pv_length_[0]);
+
+    // Every move loses to an immediate threat, so any move will do
+    if (pv.empty()) {
+      pv.push_back(board.CalculateValidColumns()[0]);
+    }
+
+    result.score = score;
+    result.principal_variation = pv;
+    result.column = pv[0];
+    result.depth = iteration;
+    previous_pv_ = pv;
+
+    if (options.on_iteration) {
+      result.nodes = nodes_;
+      options.on_iteration(result);
+    }
+  }
+
+  result.nodes = nodes_;
+  return result;
+}
+
+float Computer::PrincipalVariationSearch(const GameBoard &board, size_t depth,
+                                         size_t ply, float alpha,
+                                         float beta) {
+  nodes_++;
+  pv_length_[ply] = 0;
+  if (IsStopped()) {
+    return 0;
+  }
+
+  if (board.GetGameState() != BoardState::InProgress) {
+    return EvaluateGameOver(board);
+  }
+
+  if (depth == 0) {
+    return FloatEvaluateBoard(board, board.GetIsXTurn(), evaluator_);
+  }
+
+  // Resolve forced lines before recursing
+  size_t winning_column;
+  MoveList valid_moves;
+  if (ResolveThreats(board, depth, winning_column, valid_moves)) {
+    pv_table_[ply][0] = winning_column;
+    pv_length_[ply] = 1;
+    return kWinLossValue;
+  }
+  if (valid_moves.empty()) {
+    return -kWinLossValue;
+  }
+
+  // Try the previous iteration's move at this ply first
+  if (ply < previous_pv_.size()) {
+    size_t* pv_move = std::find(valid_moves.begin(), valid_moves.end(),
+                                previous_pv_[ply]);
+    if (pv_move != valid_moves.end()) {
+      std::rotate(valid_moves.begin(), pv_move, pv_move + 1);
+    }
+  }
+
+  float value = -kAlphaBeta;
+
+  for (size_t index = 0; index < valid_moves.size(); index++) {
+    GameBoard copy = board;
+    copy.DropPiece(valid_moves[index]);
+
+    float score;
+    if (index == 0) {
+      score = -PrincipalVariationSearch(copy, depth - 1, ply + 1,
+                                        -beta, -alpha);
+    } else {
+      // Prove the move is no better than the best so far with a null window,
+      // and only pay for a full window search if that fails
+      score = -PrincipalVariationSearch(copy, depth - 1, ply + 1,
+                                        -alpha - kNullWindow, -alpha);
+      if (score > alpha && score < beta) {
+        score = -PrincipalVariationSearch(copy, depth - 1, ply + 1,
+                                          -beta, -alpha);
+      }
+    }
+
+    if (score > value) {
+      value = score;
+
+      if (score > alpha) {
+        alpha = score;
+        // This move followed by the child's line is the new best line
+        pv_table_[ply][0] = valid_moves[index];
+        std::copy(pv_table_[ply + 1], pv_table_[ply + 1] + pv_length_[ply + 1],
+                  pv_table_[ply] + 1);
+        pv_length_[ply] = pv_length_[ply + 1] + 1;
+      }
+
+      // Alpha beta pruning
+      if (alpha >= beta) {
+        break;
+      }
+    }
+  }
+  return value;
+}
+
+search_result Computer::MtdfSearch(const GameBoard &board,
+                                   const search_options &options) {
+  search_result result;
+  if (options.table) {
+    active_table_ = options.table;
+  } else {
+    if (!table_) {
+      table_.reset(new TranspositionTable());
+    }
+    active_table_ = table_.get();
+    table_->Clear();
+  }
+
+  for (size_t iteration = 1; iteration <= options.depth; iteration++) {
+    // The first iteration always completes so there is a move to play
+    if (iteration == 2) {
+      is_stoppable_ = true;
+    }
+
+    // The previous depth's value is the first guess
+    float value = result.score;
+    float lower_bound = -kAlphaBeta;
+    float upper_bound = kAlphaBeta;
+    size_t column = 0;
+    bool has_column = false;
+
+    while (lower_bound < upper_bound) {
+      // Test whether the value is at least beta
+      float beta = value;
+      if (value == lower_bound) {
+        beta = value + kMtdfWindow;
+      }
+
+      size_t pass_column = 0;
+      value = AlphaBetaWithMemory(board, iteration, beta - kMtdfWindow, beta,
+                                  pass_column);
+      if (value < beta) {
+        upper_bound = value;
+      } else {
+        // The move proving the new lower bound is the best so far
+        lower_bound = value;
+        column = pass_column;
+        has_column = true;
+      }
+    }
+    if (is_stopped_) {
+      break;
+    }
+
+    result.score = value;
+    result.depth = iteration;
+
+    // The game is already over
+    if (board.GetGameState() != BoardState::InProgress) {
+      break;
+    }
+
+    if (!has_column) {
+      column = board.CalculateValidColumns()[0];
+    }
+    result.column = column;
+    result.principal_variation = ExtractPrincipalVariation(board, iteration);
+    if (result.principal_variation.empty()) {
+      result.principal_variation.push_back(column);
+    } else {
+      result.principal_variation[0] = column;
+    }
+
+    if (options.on_iteration) {
+      result.nodes = nodes_;
+      options.on_iteration(result);
+    }
+  }
+
+  result.nodes = nodes_;
+  return result;
+}
+
+float Computer::AlphaBetaWithMemory(const GameBoard &board, size_t depth,
+                                    float alpha, float beta, size_t &column) {
+  nodes_++;
+  if (IsStopped()) {
+    return 0;
+  }
+
+  if (board.GetGameState() != BoardState::InProgress) {
+    return EvaluateGameOver(board);
+  }
+
+  if (depth == 0) {
+    return FloatEvaluateBoard(board, board.GetIsXTurn(), evaluator_);
+  }
+
+  // Resolve forced lines before recursing
+  MoveList valid_moves;
+  if (ResolveThreats(board, depth, column, valid_moves)) {
+    return kWinLossValue;
+  }
+  if (valid_moves.empty()) {
+    column = board.CalculateValidColumns()[0];
+    return -kWinLossValue;
+  }
+
+  // A position and its mirror image share an entry, with the best column
+  // stored as seen from the position with the smaller key
+  table_entry entry;
+  entry.key = board.GetCanonicalKey();
+  entry.lower_bound = -kAlphaBeta;
+  entry.upper_bound = kAlphaBeta;
+  bool is_mirrored = entry.key != board.GetKey();
+
+  table_entry stored;
+  if (active_table_->Probe(entry.key, stored)) {
+    size_t hash_column = is_mirrored ? GameBoard::kWidth - 1 - stored.column
+                                     : stored.column;
+
+    // Bounds from a deep enough search can cut off or narrow this one
+    if (stored.depth >= depth) {
+      if (stored.lower_bound >= beta) {
+        column = hash_column;
+        return stored.lower_bound;
+      }
+      if (stored.upper_bound <= alpha) {
+        column = hash_column;
+        return stored.upper_bound;
+      }
+      alpha = std::max(alpha, stored.lower_bound);
+      beta = std::min(beta, stored.upper_bound);
+
+      // Keep the bound this search won't improve on
+      if (stored.depth == depth) {
+        entry.lower_bound = stored.lower_bound;
+        entry.upper_bound = stored.upper_bound;
+      }
+    }
+
+    // Search the stored best move first
+    size_t* hash_move = std::find(valid_moves.begin(), valid_moves.end(),
+                                  hash_column);
+    if (hash_move != valid_moves.end()) {
+      std::rotate(valid_moves.begin(), hash_move, hash_move + 1);
+    }
+  }
 
+  float value = -kAlphaBeta;
+  float window_alpha = alpha;
+  size_t child_column = 0;
+  column = valid_moves[0];
+
+  for (size_t col : valid_moves) {
+    GameBoard copy = board;
+    copy.DropPiece(col);
+
+    float score = -AlphaBetaWithMemory(copy, depth - 1, -beta, -window_alpha,
+                                       child_column);
+    if (score > value) {
+      value = score;
+      column = col;
+      window_alpha = std::max(window_alpha, value);
+
+      // Alpha beta pruning
+      if (value >= beta) {
+        break;
+      }
+    }
+  }
+
+  // A fail low is an upper bound, a fail high a lower bound, and anything in
+  // between is exact
+  if (value <= alpha) {
+    entry.upper_bound = value;
+  } else if (value >= beta) {
+    entry.lower_bound = value;
+  } else {
+    entry.lower_bound = value;
+    entry.upper_bound = value;
+  }
+
+  // Drop a kept bound that the new one contradicts
+  if (entry.lower_bound > entry.upper_bound) {
+    if (value <= alpha) {
+      entry.lower_bound = -kAlphaBeta;
+    } else {
+      entry.upper_bound = kAlphaBeta;
+    }
+  }
+  // A given up search returns made up values, which mustn't outlive it in a
+  // table that is kept
+  if (is_stopped_) {
+    return value;
+  }
+
+  entry.depth = static_cast<uint8_t>(depth);
+  entry.column = static_cast<uint8_t>(
+      is_mirrored ? GameBoard::kWidth - 1 - column : column);
+  active_table_->Store(entry);
+
+  return value;
+}
+
+std::vector<size_t> Computer::ExtractPrincipalVariation(const GameBoard &board,
+                                                        size_t depth) const {
+  std::vector<size_t> pv;
+  GameBoard copy = board;
+  table_entry entry;
+
+  while (pv.size() < depth &&
+         copy.GetGameState() == BoardState::InProgress &&
+         active_table_->Probe(copy.GetCanonicalKey(), entry)) {
+    size_t column = entry.key != copy.GetKey()
+                        ? GameBoard::kWidth - 1 - entry.column
+                        : entry.column;
+    pv.push_back(column);
+    copy.DropPiece(column);
+  }
+  return pv;
+}
+
+bool Computer::ResolveThreats(const GameBoard &board, size_t depth,
+                              size_t &winning_column,
+                              MoveList &moves) const {
+  // Winning right away beats anything the search could find
+  MoveList winning_columns = board.ConvertToColumns(
+      board.CalculateWinningMoves(board.GetIsXTurn()));
+  if (!winning_columns.empty()) {
+    winning_column = winning_columns[0];
+    return true;
+  }
+
+  // Moves that let the opponent win next turn are only worth skipping when
+  // the search would have seen the loss, so scores match a full search
+  if (depth > 1) {
+    moves = board.CalculateNonLosingColumns();
+  } else {
+    moves = board.CalculateValidColumns();
+  }
+  return false;
+}
+
+float Computer::EvaluateGameOver(const GameBoard &board) const {
+  BoardState state = board.GetGameState();
+  if (state == BoardState::Tie) {
+    return 0;
+  }
+
+  // The game ends as soon as someone wins, so check if the winner is the
+  // player to move
+  if ((state == BoardState::Xwins) == board.GetIsXTurn()) {
+    return kWinLossValue;
+  }
+  return -kWinLossValue;
+}
+
+bool Computer::IsStopped() {
+  if (is_stopped_ || !is_stoppable_) {
+    return is_stopped_;
+  }
+  if (stop_ != nullptr && stop_->load(std::memory_order_relaxed)) {
+    is_stopped_ = true;
+  } else if (nodes_ % kDeadlineInterval == 0 &&
+             deadline_ != std::chrono::steady_clock::time_point::max()) {
+    is_stopped_ = std::chrono::steady_clock::now() >= deadline_;
+  }
+  return is_stopped_;
+}
+
+} // namespace connect_four
@@ -0,0 +1,141 @@
+#include <core/data_parallel_trainer.h>
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace connect_four {
+
+namespace {
+
+// Keeps the gradients tiny_dnn passes to the optimizer instead of applying
+// them, so a replica's weights stay as they were copied
+class GradientRecorder : public tiny_dnn::optimizer {
+ public:
+  void update(const tiny_dnn::vec_t& dW, tiny_dnn::vec_t& W,
+              bool) override {
+    gradients_[&W] = dW;
+  }
+
+  const tiny_dnn::vec_t& GetGradient(const tiny_dnn::vec_t* weights) const {
+    return gradients_.at(weights);
+  }
+
+ private:
+  std::unordered_map<const tiny_dnn::vec_t*, tiny_dnn::vec_t> gradients_;
+};
+
+} // namespace
+
+DataParallelTrainer::DataParallelTrainer(
+    tiny_dnn::network<tiny_dnn::sequential>& network,
+    const std::function<tiny_dnn::network<tiny_dnn::sequential>()>&
+        create_network,
+    size_t number_threads)
+    : network_(network), pool_(number_threads) {
+  network_.init_weight();
+  for (size_t worker = 0; worker < pool_.GetNumberThreads(); worker++) {
+    replicas_.push_back(create_network());
+    // Training a replica would otherwise initialize it over the copied
+    // weights the first time
+    replicas_.back().init_weight();
+  }
+}
+
+void DataParallelTrainer::Train(tiny_dnn::optimizer& optimizer,
+                                const std::vector<tiny_dnn::vec_t>& features,
+                                const std::vector<tiny_dnn::label_t>& labels,
+                                size_t batch_size) {
+  if (features.size() != labels.size()) {
+    throw std::invalid_argument("Every example needs a label");
+  }
+  batch_size = std::max<size_t>(batch_size, 1);
+
+  std::vector<tiny_dnn::vec_t*> weights = GetWeights(network_);
+  std::vector<std::vector<tiny_dnn::vec_t*>> replica_weights;
+  for (tiny_dnn::network<tiny_dnn::sequential>& replica : replicas_) {
+    replica_weights.push_back(GetWeights(replica));
+    if (replica_weights.back().size() != weights.size()) {
+      throw std::invalid_argument("Replicas need the network's shape");
+    }
+    for (size_t index = 0; index < weights.size(); index++) {
+      if (replica_weights.back()[index]->size() != weights[index]->size()) {
+        throw std::invalid_argument("Replicas need the network's shape");
+      }
+    }
+  }
+
+  // Reused from minibatch to minibatch
+  std::vector<GradientRecorder> recorders(replicas_.size());
+  std::vector<std::vector<tiny_dnn::vec_t>> slice_features(replicas_.size());
+  std::vector<std::vector<tiny_dnn::label_t>> slice_labels(replicas_.size());
+  std::vector<tiny_dnn::vec_t> gradients(weights.size());
+
+  for (size_t first = 0; first < features.size(); first += batch_size) {
+    size_t last = std::min(first + batch_size, features.size());
+    size_t number_examples = last - first;
+    // Slices differ in size by at most one example
+    size_t number_slices = std::min(replicas_.size(), number_examples);
+
+    std::vector<std::future<void>> workers;
+    for (size_t slice = 0; slice < number_slices; slice++) {
+      size_t begin = first + number_examples * slice / number_slices;
+      size_t end = first + number_examples * (slice + 1) / number_slices;
+      workers.push_back(pool_.Submit([this, slice, begin, end, &features,
+                                      &labels, &weights, &replica_weights,
+                                      &recorders, &slice_features,
+                                      &slice_labels]() {
+        for (size_t index = 0; index < weights.size(); index++) {
+          *replica_weights[slice][index] = *weights[index];
+        }
+        slice_features[slice].assign(features.begin() + begin,
+                                     features.begin() + end);
+        slice_labels[slice].assign(labels.begin() + begin,
+                                   labels.begin() + end);
+        // One minibatch of the whole slice on this thread
+        replicas_[slice].train<tiny_dnn::cross_entropy>(
+            recorders[slice], slice_features[slice], slice_labels[slice],
+            end - begin, 1, tiny_dnn::nop, tiny_dnn::nop, false, 1);
+      }));
+    }
+    for (std::future<void>& worker : workers) {
+      worker.get();
+    }
+
+    // Each slice's gradient is its mean, so weighting by the slices' sizes
+    // gives the mean over the minibatch
+    for (size_t index = 0; index < weights.size(); index++) {
+      tiny_dnn::vec_t& gradient = gradients[index];
+      gradient.assign(weights[index]->size(), 0);
+      for (size_t slice = 0; slice < number_slices; slice++) {
+        size_t begin = number_examples * slice / number_slices;
+        size_t end = number_examples * (slice + 1) / number_slices;
+        float share = static_cast<float>(end - begin) / number_examples;
+        const tiny_dnn::vec_t& slice_gradient =
+            recorders[slice].GetGradient(replica_weights[slice][index]);
+        for (size_t cell = 0; cell < gradient.size(); cell++) {
+          gradient[cell] += share * slice_gradient[cell];
+        }
+      }
+      optimizer.update(gradient, *weights[index], false);
+    }
+  }
+}
+
+size_t DataParallelTrainer::GetNumberThreads() const {
+  return replicas_.size();
+}
+
+std::vector<tiny_dnn::vec_t*> DataParallelTrainer::GetWeights(
+    tiny_dnn::network<tiny_dnn::sequential>& network) {
+  std::vector<tiny_dnn::vec_t*> weights;
+  for (size_t layer = 0; layer < network.depth(); layer++) {
+    for (tiny_dnn::vec_t* layer_weights : network[layer]->weights()) {
+      weights.push_back(layer_weights);
+    }
+  }
+  return weights;
+}
+
+} // namespace connect_four
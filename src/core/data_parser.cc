@@ -1,259 +1,347 @@
 #include <core/data_parser.h>
 
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <core/packed_dataset.h>
+
 namespace connect_four {
 
-void DataParser::YieldTrainingDataNumericCSV(const std::string& csv_path,
-                                             size_t start,
-                                             size_t number_examples) {
-  string line;
-  std::ifstream csv;
-  csv.open(csv_path);
+constexpr uint32_t DataStream::kIndexMagic;
+constexpr uint32_t DataStream::kIndexVersion;
+constexpr std::streamoff DataStream::kHashBlockSize;
 
-  // Skip to get to the starting line
-  for (size_t i = 0; i < start; i++) {
-    getline(csv, line);
+DataStream::DataStream(const std::string& csv_path, DataFormat format)
+    : csv_path_(csv_path), format_(format), next_example_(1), data_start_(0),
+      index_interval_(0), number_examples_(0) {
+  // Binary mode keeps byte offsets exact, line endings are stripped instead
+  csv_.open(csv_path, std::ios::binary);
+  if (!csv_.is_open()) {
+    throw std::invalid_argument("File stream is not good");
   }
 
-  if (!csv.good()) {
-    throw std::invalid_argument("File stream is not good");
+  // Numeric CSVs start with a header
+  if (format_ == DataFormat::Numeric) {
+    string header;
+    getline(csv_, header);
   }
+  data_start_ = csv_.tellg();
+}
 
-  // Process a number of examples
-  for (size_t i = 0; i < number_examples; i++) {
-    if (csv.eof()) {
-      break;
-    }
+void DataStream::BuildIndex(size_t interval) {
+  size_t current_example = next_example_;
+  index_.clear();
+  index_interval_ = interval;
+  number_examples_ = 0;
 
-    getline(csv, line);
-    std::vector<string> splitted = Split(line, ',');
+  csv_.clear();
+  csv_.seekg(data_start_);
 
-    // Skip empty lines
-    if (splitted.size() == 0) {
-      continue;
+  // Record the offset before every interval-th line
+  string line;
+  for (size_t row = 0; csv_.good(); row++) {
+    if (row % interval == 0) {
+      index_.push_back(csv_.tellg());
     }
-
-    // Features and label
-    tiny_dnn::vec_t features;
-    tiny_dnn::label_t label;
-
-    for (size_t index = 0; index < splitted.size(); index++) {
-      // Last column is label, all else are features
-      if (index != splitted.size() - 1) {
-        features.push_back(stof(splitted[index]));
-      } else {
-        // Since labels are stored as -1, 1, or 0, add 1 to
-        // scale to 0 to 2 range for categorization
-        label = stof(splitted[index]) + 1;
-      }
+    if (getline(csv_, line)) {
+      number_examples_++;
     }
+  }
 
-    // Check shapes
-    if (features.size() != kWidth * kHeight) {
-      continue;
-    }
+  // Return to where the cursor was
+  csv_.clear();
+  csv_.seekg(data_start_);
+  next_example_ = 1;
+  SeekToExample(current_example);
+}
 
-    // Save to training
-    train_labels.push_back(label);
-    train_features.push_back(features);
+void DataStream::SaveIndex(const std::string& index_path) const {
+  if (index_.empty()) {
+    throw std::invalid_argument("No index was built");
   }
-}
 
-void DataParser::YieldTestDataNumericCSV(const std::string& csv_path,
-                                         size_t start,
-                                         size_t number_examples) {
-  string line;
-  std::ifstream csv;
-  csv.open(csv_path);
+  std::ofstream index_file(index_path, std::ios::binary);
+  if (!index_file.is_open()) {
+    throw std::invalid_argument("File stream is not good");
+  }
 
-  // Skip to get to the starting line
-  for (size_t i = 0; i < start; i++) {
-    getline(csv, line);
+  // Header, then one offset per indexed example
+  uint64_t interval = index_interval_;
+  uint64_t number_examples = number_examples_;
+  int64_t file_size = CalculateFileSize();
+  int64_t data_start = data_start_;
+  int64_t modified_time = CalculateModifiedTime();
+  uint64_t content_hash = CalculateContentHash();
+  uint64_t number_offsets = index_.size();
+  index_file.write(reinterpret_cast<const char*>(&kIndexMagic),
+                   sizeof(kIndexMagic));
+  index_file.write(reinterpret_cast<const char*>(&kIndexVersion),
+                   sizeof(kIndexVersion));
+  index_file.write(reinterpret_cast<const char*>(&interval), sizeof(interval));
+  index_file.write(reinterpret_cast<const char*>(&number_examples),
+                   sizeof(number_examples));
+  index_file.write(reinterpret_cast<const char*>(&file_size),
+                   sizeof(file_size));
+  index_file.write(reinterpret_cast<const char*>(&data_start),
+                   sizeof(data_start));
+  index_file.write(reinterpret_cast<const char*>(&modified_time),
+                   sizeof(modified_time));
+  index_file.write(reinterpret_cast<const char*>(&content_hash),
+                   sizeof(content_hash));
+  index_file.write(reinterpret_cast<const char*>(&number_offsets),
+                   sizeof(number_offsets));
+  for (std::streamoff offset : index_) {
+    int64_t value = offset;
+    index_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
   }
 
-  if (!csv.good()) {
+  if (!index_file.good()) {
     throw std::invalid_argument("File stream is not good");
   }
+}
 
-  // Process a number of examples
-  for (size_t i = 0; i < number_examples; i++) {
-    if (csv.eof()) {
-      break;
-    }
-
-    getline(csv, line);
-    std::vector<string> splitted = Split(line, ',');
+bool DataStream::LoadIndex(const std::string& index_path) {
+  std::ifstream index_file(index_path, std::ios::binary);
+  if (!index_file.is_open()) {
+    return false;
+  }
 
-    // Skip empty lines
-    if (splitted.size() == 0) {
-      continue;
-    }
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t interval = 0;
+  uint64_t number_examples = 0;
+  int64_t file_size = 0;
+  int64_t data_start = 0;
+  int64_t modified_time = 0;
+  uint64_t content_hash = 0;
+  uint64_t number_offsets = 0;
+  index_file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  index_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  index_file.read(reinterpret_cast<char*>(&interval), sizeof(interval));
+  index_file.read(reinterpret_cast<char*>(&number_examples),
+                  sizeof(number_examples));
+  index_file.read(reinterpret_cast<char*>(&file_size), sizeof(file_size));
+  index_file.read(reinterpret_cast<char*>(&data_start), sizeof(data_start));
+  index_file.read(reinterpret_cast<char*>(&modified_time),
+                  sizeof(modified_time));
+  index_file.read(reinterpret_cast<char*>(&content_hash),
+                  sizeof(content_hash));
+  index_file.read(reinterpret_cast<char*>(&number_offsets),
+                  sizeof(number_offsets));
+
+  // An index for a different or edited CSV would seek to the wrong lines.
+  // A CSV rewritten to the same size changes its time, its ends or both.
+  if (!index_file.good() || magic != kIndexMagic ||
+      version != kIndexVersion || interval == 0 || number_offsets == 0 ||
+      file_size != CalculateFileSize() || data_start != data_start_ ||
+      modified_time != CalculateModifiedTime() ||
+      content_hash != CalculateContentHash()) {
+    return false;
+  }
 
-    // Features and label
-    tiny_dnn::vec_t features;
-    tiny_dnn::label_t label;
-
-    for (size_t index = 0; index < splitted.size(); index++) {
-      // Last column is label, all else are features
-      if (index != splitted.size() - 1) {
-        features.push_back(stof(splitted[index]));
-      } else {
-        // Since labels are stored as -1, 1, or 0, add 1 to
-        // scale to 0 to 2 range for categorization
-        label = stof(splitted[index]) + 1;
-      }
-    }
+  std::vector<std::streamoff> index(number_offsets);
+  for (size_t i = 0; i < number_offsets; i++) {
+    int64_t value = 0;
+    index_file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    index[i] = value;
+  }
+  if (!index_file.good()) {
+    return false;
+  }
 
-    // Check shapes
-    if (features.size() != kWidth * kHeight) {
-      continue;
-    }
+  index_.swap(index);
+  index_interval_ = interval;
+  number_examples_ = number_examples;
+  return true;
+}
 
-    // Save to testing
-    test_labels.push_back(label);
-    test_features.push_back(features);
+void DataStream::LoadOrBuildIndex(size_t interval) {
+  std::string index_path = GetIndexPath(csv_path_);
+  if (LoadIndex(index_path) && index_interval_ == interval) {
+    return;
   }
+
+  BuildIndex(interval);
+  SaveIndex(index_path);
 }
 
-void DataParser::YieldTrainingDataStringCSV(const std::string& csv_path,
-                                            size_t start,
-                                            size_t number_examples) {
-  string line;
-  std::ifstream csv;
-  csv.open(csv_path);
+std::string DataStream::GetIndexPath(const std::string& csv_path) {
+  return csv_path + ".idx";
+}
+
+void DataStream::SeekToExample(size_t example) {
+  // Examples are one-indexed
+  if (example == 0) {
+    example = 1;
+  }
 
-  // Skip to get to the starting line
-  for (size_t i = 1; i < start; i++) {
-    getline(csv, line);
+  // Start from the closest indexed example at or before this one
+  size_t base_example = 1;
+  std::streamoff base_offset = data_start_;
+  if (!index_.empty()) {
+    size_t block = std::min((example - 1) / index_interval_,
+                            index_.size() - 1);
+    base_example = block * index_interval_ + 1;
+    base_offset = index_[block];
   }
 
-  if (!csv.good()) {
+  // Reading forward from the cursor is cheaper if it is closer
+  if (next_example_ > example || next_example_ < base_example) {
+    csv_.clear();
+    csv_.seekg(base_offset);
+    next_example_ = base_example;
+  }
+
+  string line;
+  while (next_example_ < example && getline(csv_, line)) {
+    next_example_++;
+  }
+
+  if (!csv_.good()) {
     throw std::invalid_argument("File stream is not good");
   }
+}
 
-  // Process a number of examples
-  for (size_t i = 0; i < number_examples; i++) {
-    if (csv.eof()) {
-      break;
-    }
+bool DataStream::ReadLine(string& line) {
+  if (!getline(csv_, line)) {
+    return false;
+  }
 
-    getline(csv, line);
-    std::vector<string> splitted = Split(line, ',');
+  // Strip Windows line endings
+  if (!line.empty() && line[line.size() - 1] == '\r') {
+    line.erase(line.size() - 1);
+  }
+  next_example_++;
+  return true;
+}
 
-    // Skip empty lines
-    if (splitted.size() == 0) {
-      continue;
-    }
+DataFormat DataStream::GetFormat() const {
+  return format_;
+}
 
-    // Features and label
-    tiny_dnn::vec_t features;
-    tiny_dnn::label_t label;
-
-    // The order of the pieces in by column, so store here first and then
-    // convert to vec_t
-    std::vector<std::vector<int>> integer_features;
-    integer_features.resize(kHeight, std::vector<int>(kWidth, 0));
-
-    for (size_t index = 0; index < splitted.size(); index++) {
-      // Last column is label, all else are features
-      if (index != splitted.size() - 1) {
-        if (splitted[index] == "b") {
-          integer_features[kHeight - 1 - index % kHeight][index / kHeight] = 0;
-        } else if (splitted[index] == "x") {
-          integer_features[kHeight - 1 - index % kHeight][index / kHeight] = 1;
-        } else if (splitted[index] == "o") {
-          integer_features[kHeight - 1 - index % kHeight][index / kHeight] = -1;
-        }
-      } else {
-        // Label is win loss or draw
-        if (splitted[index] == "win") {
-          label = kXWinsCategory;
-        } else if (splitted[index] == "draw") {
-          label = kTieCategory;
-        } else if (splitted[index] == "loss") {
-          label = kOWinsCategory;
-        }
-      }
-    }
+size_t DataStream::GetNextExample() const {
+  return next_example_;
+}
 
-    for (size_t index = 0; index < kWidth * kHeight; index++) {
-      features.push_back(integer_features[index / kWidth][index % kWidth]);
-    }
+size_t DataStream::GetNumberExamples() const {
+  return number_examples_;
+}
 
-    // Save to training
-    train_labels.push_back(label);
-    train_features.push_back(features);
+std::streamoff DataStream::CalculateFileSize() const {
+  std::ifstream csv(csv_path_, std::ios::binary | std::ios::ate);
+  return csv.tellg();
+}
+
+int64_t DataStream::CalculateModifiedTime() const {
+  struct stat status;
+  if (stat(csv_path_.c_str(), &status) != 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(status.st_mtime);
+}
+
+uint64_t DataStream::CalculateContentHash() const {
+  std::ifstream csv(csv_path_, std::ios::binary);
+  std::streamoff file_size = CalculateFileSize();
+  std::streamoff first_size = std::min(file_size, kHashBlockSize);
+  std::streamoff last_start = std::max(file_size - kHashBlockSize,
+                                       first_size);
+
+  std::string bytes(static_cast<size_t>(first_size), '\0');
+  csv.read(&bytes[0], first_size);
+  std::string last(static_cast<size_t>(file_size - last_start), '\0');
+  csv.seekg(last_start);
+  csv.read(&last[0], file_size - last_start);
+  bytes += last;
+
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (char byte : bytes) {
+    hash ^= static_cast<unsigned char>(byte);
+    hash *= 0x100000001B3ULL;
   }
+  return hash;
+}
+
+void DataParser::YieldTrainingDataNumericCSV(const std::string& csv_path,
+                                             size_t start,
+                                             size_t number_examples) {
+  size_t first = train_features.size();
+  DataStream stream(csv_path, DataFormat::Numeric);
+  stream.SeekToExample(start);
+  YieldExamples(stream, number_examples, train_features, train_labels);
+  AppendMirroredExamples(first);
+}
+
+void DataParser::YieldTestDataNumericCSV(const std::string& csv_path,
+                                         size_t start,
+                                         size_t number_examples) {
+  DataStream stream(csv_path, DataFormat::Numeric);
+  stream.SeekToExample(start);
+  YieldExamples(stream, number_examples, test_features, test_labels);
+}
+
+void DataParser::YieldTrainingDataStringCSV(const std::string& csv_path,
+                                            size_t start,
+                                            size_t number_examples) {
+  size_t first = train_features.size();
+  DataStream stream(csv_path, DataFormat::String);
+  stream.SeekToExample(start);
+  YieldExamples(stream, number_examples, train_features, train_labels);
+  AppendMirroredExamples(first);
 }
 
 void DataParser::YieldTestDataStringCSV(const std::string& csv_path,
                                         size_t start,
                                         size_t number_examples) {
-  string line;
-  std::ifstream csv;
-  csv.open(csv_path);
-
-  // Skip to get to the starting line
-  for (size_t i = 1; i < start; i++) {
-    getline(csv, line);
-  }
+  DataStream stream(csv_path, DataFormat::String);
+  stream.SeekToExample(start);
+  YieldExamples(stream, number_examples, test_features, test_labels);
+}
 
-  if (!csv.good()) {
-    throw std::invalid_argument("File stream is not good");
-  }
+void DataParser::YieldTrainingData(DataStream& stream,
+                                   size_t number_examples) {
+  size_t first = train_features.size();
+  YieldExamples(stream, number_examples, train_features, train_labels);
+  AppendMirroredExamples(first);
+}
 
-  // Process a number of examples
-  for (size_t i = 0; i < number_examples; i++) {
-    if (csv.eof()) {
-      break;
-    }
+void DataParser::YieldTestData(DataStream& stream, size_t number_examples) {
+  YieldExamples(stream, number_examples, test_features, test_labels);
+}
 
-    getline(csv, line);
-    std::vector<string> splitted = Split(line, ',');
+void DataParser::YieldTrainingData(DataStream& stream, size_t start,
+                                   size_t number_examples) {
+  size_t first = train_features.size();
+  stream.SeekToExample(start);
+  YieldExamples(stream, number_examples, train_features, train_labels);
+  AppendMirroredExamples(first);
+}
 
-    // Skip empty lines
-    if (splitted.size() == 0) {
-      continue;
-    }
+void DataParser::YieldTestData(DataStream& stream, size_t start,
+                               size_t number_examples) {
+  stream.SeekToExample(start);
+  YieldExamples(stream, number_examples, test_features, test_labels);
+}
 
-    // Features and label
-    tiny_dnn::vec_t features;
-    tiny_dnn::label_t label;
-
-    // The order of the pieces in by column, so store here first and then
-    // convert to vec_t
-    std::vector<std::vector<int>> integer_features;
-    integer_features.resize(kHeight, std::vector<int>(kWidth, 0));
-
-    for (size_t index = 0; index < splitted.size(); index++) {
-      // Last column is label, all else are features
-      if (index != splitted.size() - 1) {
-        if (splitted[index] == "b") {
-          integer_features[kHeight - 1 - index % kHeight][index / kHeight] = 0;
-        } else if (splitted[index] == "x") {
-          integer_features[kHeight - 1 - index % kHeight][index / kHeight] = 1;
-        } else if (splitted[index] == "o") {
-          integer_features[kHeight - 1 - index % kHeight][index / kHeight] = -1;
-        }
-      } else {
-        // Label is win loss or draw
-        if (splitted[index] == "win") {
-          label = kXWinsCategory;
-        } else if (splitted[index] == "draw") {
-          label = kTieCategory;
-        } else if (splitted[index] == "loss") {
-          label = kOWinsCategory;
-        }
-      }
-    }
+void DataParser::YieldTrainingData(const PackedDataset& dataset,
+                                   size_t start, size_t number_examples) {
+  size_t first = train_features.size();
+  dataset.YieldExamples(start, number_examples, train_features, train_labels);
+  AppendMirroredExamples(first);
+}
 
-    for (size_t index = 0; index < kWidth * kHeight; index++) {
-      features.push_back(integer_features[index / kWidth][index % kWidth]);
-    }
+void DataParser::YieldTestData(const PackedDataset& dataset, size_t start,
+                               size_t number_examples) {
+  dataset.YieldExamples(start, number_examples, test_features, test_labels);
+}
 
-    // Save to training
-    test_labels.push_back(label);
-    test_features.push_back(features);
-  }
+void DataParser::SetMirrorAugmentation(bool is_mirroring) {
+  this->is_mirroring = is_mirroring;
 }
 
 void DataParser::Clear() {
@@ -263,6 +351,23 @@ void DataParser::Clear() {
   test_labels.clear();
 }
 
+void DataParser::TakeTrainingData(std::vector<tiny_dnn::vec_t>& features,
+                                  std::vector<tiny_dnn::label_t>& labels) {
+  features = std::move(train_features);
+  labels = std::move(train_labels);
+  train_features.clear();
+  train_labels.clear();
+}
+
+bool DataParser::ParseLine(const string& line, DataFormat format,
+                           tiny_dnn::vec_t& features,
+                           tiny_dnn::label_t& label) const {
+  if (format == DataFormat::Numeric) {
+    return ParseNumericLine(line, features, label);
+  }
+  return ParseStringLine(line, features, label);
+}
+
 const std::vector<tiny_dnn::vec_t>& DataParser::GetTrainFeatures() const {
   return train_features;
 }
@@ -279,6 +384,126 @@ const std::vector<tiny_dnn::label_t>& DataParser::GetTestLabels() const {
   return test_labels;
 }
 
+void DataParser::AppendMirroredExamples(size_t first) {
+  if (!is_mirroring) {
+    return;
+  }
+
+  size_t last = train_features.size();
+  train_features.reserve(last + last - first);
+  train_labels.reserve(last + last - first);
+  for (size_t index = first; index < last; index++) {
+    // Features are row by row, so reverse each row
+    tiny_dnn::vec_t mirrored(kWidth * kHeight);
+    for (size_t row = 0; row < kHeight; row++) {
+      for (size_t col = 0; col < kWidth; col++) {
+        mirrored[row * kWidth + col] =
+            train_features[index][row * kWidth + kWidth - 1 - col];
+      }
+    }
+    train_features.push_back(mirrored);
+    train_labels.push_back(train_labels[index]);
+  }
+}
+
+void DataParser::YieldExamples(DataStream& stream, size_t number_examples,
+                               std::vector<tiny_dnn::vec_t>& features,
+                               std::vector<tiny_dnn::label_t>& labels) const {
+  string line;
+
+  // Process a number of examples
+  for (size_t i = 0; i < number_examples; i++) {
+    if (!stream.ReadLine(line)) {
+      break;
+    }
+
+    tiny_dnn::vec_t example_features;
+    tiny_dnn::label_t label = 0;
+    if (ParseLine(line, stream.GetFormat(), example_features, label)) {
+      labels.push_back(label);
+      features.push_back(example_features);
+    }
+  }
+}
+
+bool DataParser::ParseNumericLine(const string& line,
+                                  tiny_dnn::vec_t& features,
+                                  tiny_dnn::label_t& label) const {
+  std::vector<string> splitted = Split(line, ',');
+
+  // Skip empty lines
+  if (splitted.size() == 0) {
+    return false;
+  }
+
+  // Solved datasets have the solve depth after the label, which is skipped
+  size_t label_index = kWidth * kHeight;
+  if (splitted.size() != label_index + 1 &&
+      splitted.size() != label_index + 2) {
+    return false;
+  }
+
+  for (size_t index = 0; index <= label_index; index++) {
+    // The label follows the features
+    if (index != label_index) {
+      features.push_back(stof(splitted[index]));
+    } else {
+      // Since labels are stored as -1, 1, or 0, add 1 to
+      // scale to 0 to 2 range for categorization
+      label = stof(splitted[index]) + 1;
+    }
+  }
+
+  // Check shapes
+  return features.size() == kWidth * kHeight;
+}
+
+bool DataParser::ParseStringLine(const string& line,
+                                 tiny_dnn::vec_t& features,
+                                 tiny_dnn::label_t& label) const {
+  std::vector<string> splitted = Split(line, ',');
+
+  // Skip empty lines
+  if (splitted.size() == 0) {
+    return false;
+  }
+
+  // The order of the pieces in by column, so store here first and then
+  // convert to vec_t
+  std::vector<std::vector<int>> integer_features;
+  integer_features.resize(kHeight, std::vector<int>(kWidth, 0));
+
+  for (size_t index = 0; index < splitted.size(); index++) {
+    // Last column is label, all else are features
+    if (index != splitted.size() - 1) {
+      if (index >= kWidth * kHeight) {
+        continue;
+      }
+      if (splitted[index] == "b") {
+        integer_features[kHeight - 1 - index % kHeight][index / kHeight] = 0;
+      } else if (splitted[index] == "x") {
+        integer_features[kHeight - 1 - index % kHeight][index / kHeight] = 1;
+      } else if (splitted[index] == "o") {
+        integer_features[kHeight - 1 - index % kHeight][index / kHeight] = -1;
+      }
+    } else {
+      // Label is win loss or draw
+      if (splitted[index] == "win") {
+        label = kXWinsCategory;
+      } else if (splitted[index] == "draw") {
+        label = kTieCategory;
+      } else if (splitted[index] == "loss") {
+        label = kOWinsCategory;
+      }
+    }
+  }
+
+  for (size_t index = 0; index < kWidth * kHeight; index++) {
+    features.push_back(integer_features[index / kWidth][index % kWidth]);
+  }
+  return true;
+}
+
 std::vector<string> DataParser::Split(const string& line, char delim) const {
   std::stringstream string_stream(line);
   std::vector<string> elems;
@@ -0,0 +1,275 @@
+#include <core/deduplicator.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <core/packed_dataset.h>
+
+namespace connect_four {
+
+constexpr size_t Deduplicator::kRecordSize;
+constexpr size_t AggregatedDataset::kRecordSize;
+constexpr uint32_t AggregatedDataset::kMagic;
+constexpr uint32_t AggregatedDataset::kVersion;
+constexpr size_t AggregatedDataset::kHeaderSize;
+
+namespace {
+
+// Mixes both masks into well distributed bits
+uint64_t HashPosition(uint64_t x_mask, uint64_t o_mask) {
+  uint64_t hash = x_mask * 0x9E3779B97F4A7C15ULL ^ o_mask;
+  hash ^= hash >> 31;
+  hash *= 0xBF58476D1CE4E5B9ULL;
+  return hash ^ (hash >> 29);
+}
+
+struct PositionHash {
+  size_t operator()(const std::pair<uint64_t, uint64_t>& position) const {
+    return static_cast<size_t>(HashPosition(position.first, position.second));
+  }
+};
+
+} // namespace
+
+Deduplicator::Deduplicator(const std::string& partition_prefix,
+                           size_t number_partitions)
+    : partition_prefix_(partition_prefix), number_examples_read_(0) {
+  if (number_partitions == 0) {
+    number_partitions = 1;
+  }
+
+  for (size_t partition = 0; partition < number_partitions; partition++) {
+    partitions_.emplace_back(new std::ofstream(GetPartitionPath(partition),
+                                               std::ios::binary));
+    if (!partitions_.back()->is_open()) {
+      RemovePartitions();
+      throw std::invalid_argument("File stream is not good");
+    }
+  }
+}
+
+Deduplicator::~Deduplicator() {
+  RemovePartitions();
+}
+
+void Deduplicator::AddDataset(DataStream& stream) {
+  // Parse in chunks so the whole CSV is never expanded in memory
+  const size_t kChunkSize = 10000;
+  DataParser parser;
+  char record[kRecordSize];
+  while (true) {
+    parser.Clear();
+    size_t next_example = stream.GetNextExample();
+    parser.YieldTrainingData(stream, kChunkSize);
+    if (stream.GetNextExample() == next_example) {
+      break;
+    }
+
+    const std::vector<tiny_dnn::vec_t>& features = parser.GetTrainFeatures();
+    const std::vector<tiny_dnn::label_t>& labels = parser.GetTrainLabels();
+    for (size_t i = 0; i < features.size(); i++) {
+      packed_example example = PackedDataset::Pack(features[i].data(),
+                                                   labels[i]);
+      size_t partition = HashPosition(example.x_mask, example.o_mask) %
+                         partitions_.size();
+
+      std::memcpy(record, &example.x_mask, sizeof(example.x_mask));
+      std::memcpy(record + 8, &example.o_mask, sizeof(example.o_mask));
+      record[16] = static_cast<char>(example.label);
+      partitions_[partition]->write(record, kRecordSize);
+    }
+
+    // A full disk would otherwise drop records without a word
+    for (std::unique_ptr<std::ofstream>& partition : partitions_) {
+      if (!partition->good()) {
+        throw std::invalid_argument("File stream is not good");
+      }
+    }
+    number_examples_read_ += features.size();
+  }
+}
+
+size_t Deduplicator::Finish(const std::string& output_path) {
+  for (std::unique_ptr<std::ofstream>& partition : partitions_) {
+    partition->close();
+    if (partition->fail()) {
+      throw std::invalid_argument("File stream is not good");
+    }
+  }
+
+  // The number of unique positions is filled in once they are all written
+  std::ofstream output;
+  AggregatedDataset::WriteHeader(output, output_path, 0);
+
+  // Partitions hold disjoint positions, so each is merged on its own and
+  // only one is in memory at a time
+  uint64_t number_unique = 0;
+  for (size_t partition = 0; partition < partitions_.size(); partition++) {
+    std::vector<aggregated_example> merged = MergePartition(partition);
+    for (const aggregated_example& example : merged) {
+      AggregatedDataset::WriteRecord(output, example);
+    }
+    number_unique += merged.size();
+    std::remove(GetPartitionPath(partition).c_str());
+  }
+  partitions_.clear();
+
+  output.seekp(8);
+  output.write(reinterpret_cast<const char*>(&number_unique),
+               sizeof(number_unique));
+  // Closing flushes the last records, which can fail too
+  output.close();
+  if (output.fail()) {
+    throw std::invalid_argument("File stream is not good");
+  }
+  return number_unique;
+}
+
+size_t Deduplicator::GetNumberExamplesRead() const {
+  return number_examples_read_;
+}
+
+std::string Deduplicator::GetPartitionPath(size_t partition) const {
+  return partition_prefix_ + std::to_string(partition);
+}
+
+std::vector<aggregated_example> Deduplicator::MergePartition(
+    size_t partition) const {
+  std::ifstream partition_file(GetPartitionPath(partition), std::ios::binary);
+  if (!partition_file.is_open()) {
+    throw std::invalid_argument("File stream is not good");
+  }
+
+  std::unordered_map<std::pair<uint64_t, uint64_t>, aggregated_example,
+                     PositionHash> positions;
+  char record[kRecordSize];
+  while (partition_file.read(record, kRecordSize)) {
+    uint64_t x_mask;
+    uint64_t o_mask;
+    std::memcpy(&x_mask, record, sizeof(x_mask));
+    std::memcpy(&o_mask, record + 8, sizeof(o_mask));
+    uint8_t label = static_cast<uint8_t>(record[16]);
+
+    aggregated_example& example = positions[std::make_pair(x_mask, o_mask)];
+    example.x_mask = x_mask;
+    example.o_mask = o_mask;
+    if (label < 3) {
+      example.counts[label]++;
+    }
+  }
+
+  // Sort so the output doesn't depend on the hash table's order
+  std::vector<aggregated_example> merged;
+  merged.reserve(positions.size());
+  for (const auto& position : positions) {
+    merged.push_back(position.second);
+  }
+  std::sort(merged.begin(), merged.end(),
+            [](const aggregated_example& first,
+               const aggregated_example& second) {
+    return first.x_mask != second.x_mask ? first.x_mask < second.x_mask
+                                         : first.o_mask < second.o_mask;
+  });
+  return merged;
+}
+
+void Deduplicator::RemovePartitions() {
+  for (size_t partition = 0; partition < partitions_.size(); partition++) {
+    partitions_[partition]->close();
+    std::remove(GetPartitionPath(partition).c_str());
+  }
+  partitions_.clear();
+}
+
+AggregatedDataset::AggregatedDataset(const std::string& aggregated_path)
+    : file_(aggregated_path), number_examples_(0) {
+  // Check the header before trusting the records
+  if (file_.GetSize() < kHeaderSize) {
+    throw std::invalid_argument("File is not an aggregated dataset");
+  }
+
+  uint32_t magic;
+  uint32_t version;
+  uint64_t number_examples;
+  std::memcpy(&magic, file_.GetData(), sizeof(magic));
+  std::memcpy(&version, file_.GetData() + 4, sizeof(version));
+  std::memcpy(&number_examples, file_.GetData() + 8, sizeof(number_examples));
+  if (magic != kMagic || version != kVersion ||
+      (file_.GetSize() - kHeaderSize) / kRecordSize < number_examples) {
+    throw std::invalid_argument("File is not an aggregated dataset");
+  }
+  number_examples_ = number_examples;
+}
+
+void AggregatedDataset::WriteHeader(std::ofstream& aggregated_file,
+                                    const std::string& aggregated_path,
+                                    uint64_t number_examples) {
+  aggregated_file.open(aggregated_path, std::ios::binary);
+  if (!aggregated_file.is_open()) {
+    throw std::invalid_argument("File stream is not good");
+  }
+
+  aggregated_file.write(reinterpret_cast<const char*>(&kMagic),
+                        sizeof(kMagic));
+  aggregated_file.write(reinterpret_cast<const char*>(&kVersion),
+                        sizeof(kVersion));
+  aggregated_file.write(reinterpret_cast<const char*>(&number_examples),
+                        sizeof(number_examples));
+}
+
+void AggregatedDataset::WriteRecord(std::ofstream& aggregated_file,
+                                    const aggregated_example& example) {
+  char record[kRecordSize];
+  std::memcpy(record, &example.x_mask, sizeof(example.x_mask));
+  std::memcpy(record + 8, &example.o_mask, sizeof(example.o_mask));
+  std::memcpy(record + 16, example.counts, sizeof(example.counts));
+  aggregated_file.write(record, kRecordSize);
+}
+
+void AggregatedDataset::YieldExamples(
+    size_t start, size_t number_examples,
+    std::vector<tiny_dnn::vec_t>& features,
+    std::vector<tiny_dnn::vec_t>& targets) const {
+  // Examples are one-indexed
+  size_t first = start == 0 ? 0 : start - 1;
+  if (first >= number_examples_) {
+    return;
+  }
+  size_t last = std::min(first + number_examples, number_examples_);
+
+  for (size_t index = first; index < last; index++) {
+    aggregated_example example = GetExample(index);
+    features.push_back(PackedDataset::Unpack(example.x_mask, example.o_mask));
+
+    float total = static_cast<float>(example.counts[0] + example.counts[1] +
+                                     example.counts[2]);
+    tiny_dnn::vec_t target(3, 0);
+    for (size_t category = 0; category < 3 && total > 0; category++) {
+      target[category] = example.counts[category] / total;
+    }
+    targets.push_back(target);
+  }
+}
+
+aggregated_example AggregatedDataset::GetExample(size_t index) const {
+  if (index >= number_examples_) {
+    throw std::out_of_range("Example out of range");
+  }
+
+  // Records aren't aligned, so copy the fields out
+  const char* record = file_.GetData() + kHeaderSize + index * kRecordSize;
+  aggregated_example example;
+  std::memcpy(&example.x_mask, record, sizeof(example.x_mask));
+  std::memcpy(&example.o_mask, record + 8, sizeof(example.o_mask));
+  std::memcpy(example.counts, record + 16, sizeof(example.counts));
+  return example;
+}
+
+size_t AggregatedDataset::GetNumberExamples() const {
+  return number_examples_;
+}
+
+} // namespace connect_four
@@ -0,0 +1,319 @@
+#include <core/engine.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+
+namespace connect_four {
+
+Engine::Engine(std::ostream& output)
+    : output_(output), evaluator_(Evaluator::NeuralNetwork), stop_(false),
+      is_searching_(false) {
+  computers_.emplace_back(new Computer());
+}
+
+Engine::~Engine() {
+  stop_ = true;
+  Wait();
+}
+
+bool Engine::HandleCommand(const std::string& line) {
+  std::istringstream words(line);
+  std::string command;
+  if (!(words >> command)) {
+    return true;
+  }
+
+  if (command == "quit") {
+    stop_ = true;
+    Wait();
+    return false;
+  }
+
+  if (command == "isready") {
+    PrintLine("readyok");
+  } else if (command == "position") {
+    std::string moves;
+    words >> moves;
+    try {
+      board_ = GameBoard::FromMoves(moves);
+    } catch (const std::invalid_argument& error) {
+      PrintLine("info string " + std::string(error.what()));
+    }
+  } else if (command == "setoption") {
+    std::string name;
+    std::string value;
+    words >> name >> value;
+    if (name == "evaluator" && value == "network") {
+      evaluator_ = Evaluator::NeuralNetwork;
+    } else if (name == "evaluator" && value == "threats") {
+      evaluator_ = Evaluator::Threats;
+    } else {
+      PrintLine("info string Unknown option " + name + " " + value);
+    }
+  } else if (command == "go") {
+    try {
+      Go(ParseLimits(words));
+    } catch (const std::invalid_argument& error) {
+      PrintLine("info string " + std::string(error.what()));
+    }
+  } else if (command == "stop") {
+    stop_ = true;
+    Wait();
+  } else {
+    PrintLine("info string Unknown command " + command);
+  }
+  return true;
+}
+
+void Engine::Wait() {
+  if (search_thread_.joinable()) {
+    // Cut the time limit short if the search was stopped
+    {
+      std::lock_guard<std::mutex> lock(timer_mutex_);
+    }
+    search_finished_.notify_all();
+    search_thread_.join();
+  }
+}
+
+go_limits Engine::ParseLimits(std::istringstream& arguments) {
+  go_limits limits;
+  std::string name;
+  while (arguments >> name) {
+    size_t value;
+    if (!(arguments >> value)) {
+      throw std::invalid_argument("Missing value for " + name);
+    }
+
+    if (name == "depth") {
+      limits.depth = value;
+    } else if (name == "movetime") {
+      limits.move_time_ms = value;
+    } else if (name == "threads") {
+      limits.number_threads = std::max<size_t>(1, value);
+    } else {
+      throw std::invalid_argument("Unknown limit " + name);
+    }
+  }
+  return limits;
+}
+
+void Engine::PrintLine(const std::string& line) {
+  std::lock_guard<std::mutex> lock(output_mutex_);
+  output_ << line << std::endl;
+}
+
+void Engine::Go(const go_limits& limits) {
+  // Only one search runs at a time
+  stop_ = true;
+  Wait();
+  stop_ = false;
+
+  // Load the extra computers here, so a failure is reported on this thread
+  while (computers_.size() < limits.number_threads) {
+    computers_.emplace_back(new Computer());
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(timer_mutex_);
+    is_searching_ = true;
+  }
+  search_thread_ = std::thread(&Engine::RunSearch, this, board_, limits,
+                               evaluator_);
+}
+
+void Engine::RunSearch(const GameBoard& board, const go_limits& limits,
+                       Evaluator evaluator) {
+  auto start = std::chrono::steady_clock::now();
+
+  // Stops the search once its time is up
+  std::thread timer;
+  if (limits.move_time_ms > 0) {
+    timer = std::thread([this, &limits]() {
+      std::unique_lock<std::mutex> lock(timer_mutex_);
+      bool is_finished = search_finished_.wait_for(
+          lock, std::chrono::milliseconds(limits.move_time_ms),
+          [this]() { return !is_searching_ || stop_; });
+      if (!is_finished) {
+        stop_ = true;
+      }
+    });
+  }
+
+  size_t depth = Computer::CapDepth(board, limits.depth);
+
+  auto on_iteration = [this, &start](const search_result& result) {
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    PrintLine(FormatInfo(result, seconds));
+  };
+
+  search_result result;
+  if (board.GetGameState() == BoardState::InProgress) {
+    if (limits.number_threads > 1) {
+      result = SplitSearch(board, depth, limits.number_threads, evaluator,
+                           on_iteration);
+    } else {
+      search_options options(depth, SearchAlgorithm::PrincipalVariation,
+                             evaluator);
+      options.stop = &stop_;
+      options.on_iteration = on_iteration;
+      result = computers_[0]->Search(board, options);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(timer_mutex_);
+    is_searching_ = false;
+  }
+  search_finished_.notify_all();
+  if (timer.joinable()) {
+    timer.join();
+  }
+
+  if (result.principal_variation.empty()) {
+    PrintLine("bestmove none");
+  } else {
+    PrintLine("bestmove " + std::to_string(result.column));
+  }
+}
+
+search_result Engine::SplitSearch(
+    const GameBoard& board, size_t depth, size_t number_threads,
+    Evaluator evaluator,
+    const std::function<void(const search_result&)>& on_iteration) {
+  search_result result = computers_[0]->Search(
+      board, search_options(1, SearchAlgorithm::PrincipalVariation,
+                            evaluator));
+  on_iteration(result);
+
+  const float kAlphaBeta = computers_[0]->kAlphaBeta;
+  const float kNullWindow = computers_[0]->kNullWindow;
+  MoveList moves = board.CalculateValidColumns();
+  // Each root move's line from the last depth it was searched exactly to
+  std::vector<std::vector<size_t>> child_pvs(moves.size());
+  size_t nodes = result.nodes;
+  for (size_t iteration = 2; iteration <= depth && !stop_; iteration++) {
+    // The last best move is searched first, so the bound the other moves
+    // are tested against is likely to be set early and to be tight
+    std::vector<size_t> order(moves.size());
+    for (size_t index = 0; index < moves.size(); index++) {
+      order[index] = index;
+    }
+    size_t last_best = static_cast<size_t>(
+        std::find(moves.begin(), moves.end(), result.column) - moves.begin());
+    if (last_best < moves.size()) {
+      std::rotate(order.begin(), order.begin() + last_best,
+                  order.begin() + last_best + 1);
+    }
+
+    std::vector<search_result> children(moves.size());
+    // Whether a child's score is exact rather than a bound. Chars, since
+    // threads write neighbouring elements at once.
+    std::vector<char> is_exact(moves.size(), false);
+    std::atomic<size_t> next_move(0);
+    // The best exact score of any root move so far, shared by every thread
+    std::atomic<float> root_alpha(-kAlphaBeta);
+
+    auto worker = [&](Computer& computer) {
+      search_options options(iteration - 1,
+                             SearchAlgorithm::PrincipalVariation, evaluator);
+      options.stop = &stop_;
+      for (size_t next = next_move++; next < moves.size();
+           next = next_move++) {
+        size_t index = order[next];
+        GameBoard child = board;
+        child.DropPiece(moves[index]);
+
+        // Prove the move is no better than the best so far with a null
+        // window, and only pay for a full search if that fails
+        float alpha = root_alpha.load();
+        search_result searched;
+        size_t child_nodes = 0;
+        if (alpha > -kAlphaBeta) {
+          searched = computer.SearchWindow(child, options,
+                                           -alpha - kNullWindow, -alpha,
+                                           child_pvs[index]);
+          child_nodes += searched.nodes;
+        }
+        if (alpha == -kAlphaBeta || -searched.score > alpha) {
+          searched = computer.SearchWindow(child, options, -kAlphaBeta,
+                                           -alpha, child_pvs[index]);
+          child_nodes += searched.nodes;
+          is_exact[index] = -searched.score > alpha;
+        }
+        searched.nodes = child_nodes;
+
+        if (is_exact[index]) {
+          child_pvs[index] = searched.principal_variation;
+          float score = -searched.score;
+          // A failed exchange reloads best, so this retries until the
+          // bound is at least the score
+          float best = root_alpha.load();
+          while (score > best &&
+                 !root_alpha.compare_exchange_weak(best, score)) {
+          }
+        }
+        children[index] = searched;
+      }
+    };
+
+    std::vector<std::thread> helpers;
+    for (size_t thread = 1; thread < number_threads; thread++) {
+      helpers.emplace_back(worker, std::ref(*computers_[thread]));
+    }
+    worker(*computers_[0]);
+    for (std::thread& helper : helpers) {
+      helper.join();
+    }
+
+    for (const search_result& child : children) {
+      nodes += child.nodes;
+    }
+    // Children cut short by a stop searched less deeply, so drop the depth
+    if (stop_) {
+      break;
+    }
+
+    // Moves are in center to edge order, so ties go to the center. Moves
+    // that failed low only have bounds, which can tie the best score.
+    search_result best;
+    best.score = -kAlphaBeta;
+    for (size_t index = 0; index < moves.size(); index++) {
+      float score = -children[index].score;
+      if (is_exact[index] && score > best.score) {
+        best.score = score;
+        best.column = moves[index];
+        best.principal_variation = {moves[index]};
+        best.principal_variation.insert(
+            best.principal_variation.end(),
+            children[index].principal_variation.begin(),
+            children[index].principal_variation.end());
+      }
+    }
+    best.depth = iteration;
+    best.nodes = nodes;
+    result = best;
+    on_iteration(result);
+  }
+
+  result.nodes = nodes;
+  return result;
+}
+
+std::string Engine::FormatInfo(const search_result& result,
+                               double seconds) {
+  std::ostringstream line;
+  line << "info depth " << result.depth << " score " << result.score
+       << " nodes " << result.nodes << " nps "
+       << static_cast<size_t>(seconds > 0 ? result.nodes / seconds : 0)
+       << " time " << static_cast<size_t>(seconds * 1000) << " pv";
+  for (size_t column : result.principal_variation) {
+    line << " " << column;
+  }
+  return line.str();
+}
+
+} // namespace connect_four
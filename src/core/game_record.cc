@@ -0,0 +1,217 @@
+#include <core/game_record.h>
+
+#include <stdexcept>
+
+namespace connect_four {
+
+constexpr uint32_t GameRecordWriter::kMagic;
+constexpr uint32_t GameRecordWriter::kVersion;
+constexpr size_t GameRecordWriter::kMoveBits;
+constexpr size_t GameRecordWriter::kResultBits;
+constexpr size_t GameRecordWriter::kNumberGamesOffset;
+
+namespace {
+
+// The game header holds the number of moves below the result
+const size_t kCountBits = 8 - GameRecordWriter::kResultBits;
+const size_t kMaxMoves = GameBoard::kWidth * GameBoard::kHeight;
+
+size_t CalculateMoveBytes(size_t number_moves) {
+  return (number_moves * GameRecordWriter::kMoveBits + 7) / 8;
+}
+
+} // namespace
+
+std::string game_record::GetMoveString() const {
+  std::string move_string;
+  for (uint8_t move : moves) {
+    move_string += static_cast<char>('0' + move);
+  }
+  return move_string;
+}
+
+GameRecordWriter::GameRecordWriter(const std::string& path,
+                                   const std::string& metadata)
+    : number_games_(0), is_closed_(false) {
+  file_.open(path, std::ios::binary);
+  if (!file_.is_open()) {
+    throw std::invalid_argument("File stream is not good");
+  }
+
+  // The number of games is filled in on Close
+  uint32_t metadata_size = static_cast<uint32_t>(metadata.size());
+  file_.write(reinterpret_cast<const char*>(&kMagic), sizeof(kMagic));
+  file_.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+  file_.write(reinterpret_cast<const char*>(&number_games_),
+              sizeof(number_games_));
+  file_.write(reinterpret_cast<const char*>(&metadata_size),
+              sizeof(metadata_size));
+  file_.write(metadata.data(), metadata.size());
+}
+
+GameRecordWriter::~GameRecordWriter() {
+  if (!is_closed_) {
+    try {
+      Close();
+    } catch (const std::invalid_argument&) {
+      // Destructors can't report errors, call Close to see them
+    }
+  }
+}
+
+void GameRecordWriter::Write(const game_record& record) {
+  std::string bytes = Encode(record);
+  file_.write(bytes.data(), bytes.size());
+  number_games_++;
+}
+
+size_t GameRecordWriter::Close() {
+  is_closed_ = true;
+  file_.seekp(kNumberGamesOffset);
+  file_.write(reinterpret_cast<const char*>(&number_games_),
+              sizeof(number_games_));
+  file_.close();
+  if (file_.fail()) {
+    throw std::invalid_argument("File stream is not good");
+  }
+  return number_games_;
+}
+
+std::string GameRecordWriter::Encode(const game_record& record) {
+  if (record.moves.size() > kMaxMoves) {
+    throw std::invalid_argument("Game has more moves than cells");
+  }
+
+  std::string bytes;
+  bytes.reserve(1 + CalculateMoveBytes(record.moves.size()));
+  bytes += static_cast<char>(record.moves.size() |
+                             static_cast<size_t>(record.result)
+                                 << kCountBits);
+
+  // Moves are packed from the lowest bit of each byte up
+  uint32_t buffer = 0;
+  size_t buffered_bits = 0;
+  for (uint8_t move : record.moves) {
+    if (move >= GameBoard::kWidth) {
+      throw std::invalid_argument("Move is not a column");
+    }
+    buffer |= static_cast<uint32_t>(move) << buffered_bits;
+    buffered_bits += kMoveBits;
+    if (buffered_bits >= 8) {
+      bytes += static_cast<char>(buffer & 0xFF);
+      buffer >>= 8;
+      buffered_bits -= 8;
+    }
+  }
+  if (buffered_bits > 0) {
+    bytes += static_cast<char>(buffer);
+  }
+  return bytes;
+}
+
+size_t GameRecordWriter::GetNumberGames() const {
+  return number_games_;
+}
+
+GameRecordReader::GameRecordReader(const std::string& path)
+    : number_games_(0) {
+  file_.open(path, std::ios::binary);
+  if (!file_.is_open()) {
+    throw std::invalid_argument("File stream is not good");
+  }
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t metadata_size = 0;
+  file_.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  file_.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file_.read(reinterpret_cast<char*>(&number_games_), sizeof(number_games_));
+  file_.read(reinterpret_cast<char*>(&metadata_size), sizeof(metadata_size));
+  if (!file_ || magic != GameRecordWriter::kMagic ||
+      version != GameRecordWriter::kVersion) {
+    throw std::invalid_argument("File is not a game record file");
+  }
+
+  metadata_.resize(metadata_size);
+  if (!file_.read(&metadata_[0], metadata_size)) {
+    throw std::invalid_argument("File is not a game record file");
+  }
+}
+
+bool GameRecordReader::Next(game_record& record) {
+  char header;
+  if (!file_.get(header)) {
+    return false;
+  }
+
+  uint8_t header_bits = static_cast<uint8_t>(header);
+  size_t number_moves = header_bits & ((1 << kCountBits) - 1);
+  if (number_moves > kMaxMoves) {
+    throw std::invalid_argument("Game has more moves than cells");
+  }
+  record.result = static_cast<BoardState>(header_bits >> kCountBits);
+
+  char bytes[(kMaxMoves * GameRecordWriter::kMoveBits + 7) / 8];
+  size_t number_bytes = CalculateMoveBytes(number_moves);
+  if (!file_.read(bytes, number_bytes)) {
+    throw std::invalid_argument("Game is cut off");
+  }
+
+  record.moves.clear();
+  uint32_t buffer = 0;
+  size_t buffered_bits = 0;
+  size_t next_byte = 0;
+  for (size_t move = 0; move < number_moves; move++) {
+    if (buffered_bits < GameRecordWriter::kMoveBits) {
+      uint8_t byte = static_cast<uint8_t>(bytes[next_byte++]);
+      buffer |= static_cast<uint32_t>(byte) << buffered_bits;
+      buffered_bits += 8;
+    }
+    uint8_t column = buffer & ((1 << GameRecordWriter::kMoveBits) - 1);
+    if (column >= GameBoard::kWidth) {
+      throw std::invalid_argument("Move is not a column");
+    }
+    record.moves.push_back(column);
+    buffer >>= GameRecordWriter::kMoveBits;
+    buffered_bits -= GameRecordWriter::kMoveBits;
+  }
+  return true;
+}
+
+const std::string& GameRecordReader::GetMetadata() const {
+  return metadata_;
+}
+
+size_t GameRecordReader::GetNumberGames() const {
+  return number_games_;
+}
+
+GameReplay::GameReplay(const game_record& record)
+    : record_(record), ply_(0) {
+}
+
+bool GameReplay::Next() {
+  if (ply_ == record_.moves.size()) {
+    if (board_.GetGameState() != record_.result) {
+      throw std::invalid_argument("Moves don't lead to the recorded result");
+    }
+    return false;
+  }
+
+  if (record_.moves[ply_] >= GameBoard::kWidth ||
+      !board_.DropPiece(record_.moves[ply_])) {
+    throw std::invalid_argument("Move can't be played");
+  }
+  ply_++;
+  return true;
+}
+
+const GameBoard& GameReplay::GetBoard() const {
+  return board_;
+}
+
+size_t GameReplay::GetPly() const {
+  return ply_;
+}
+
+} // namespace connect_four
@@ -1,20 +1,86 @@
 #include <core/gameboard.h>
 
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
 namespace connect_four {
 
-GameBoard::GameBoard() : is_x_turn_(true), pieces_(vector<vector<int>>()),
-      gamestate_(BoardState::InProgress) {
-  // Resize the vector
-  pieces_.resize(kHeight, vector<int>(kWidth, 0));
+// Boards are copied at every node of the search
+static_assert(std::is_trivially_copyable<GameBoard>::value,
+              "GameBoard should be trivially copyable");
+
+constexpr size_t MoveList::kCapacity;
+
+constexpr size_t GameBoard::kWidth;
+constexpr size_t GameBoard::kHeight;
+constexpr int GameBoard::kEmpty;
+constexpr int GameBoard::kXPiece;
+constexpr int GameBoard::kOPiece;
+constexpr uint64_t GameBoard::kBottomMask;
+constexpr uint64_t GameBoard::kBoardMask;
+constexpr size_t GameBoard::kColumnOrder[];
+
+void MoveList::push_back(size_t column) {
+  columns_[size_++] = column;
+}
+
+size_t MoveList::size() const {
+  return size_;
+}
+
+bool MoveList::empty() const {
+  return size_ == 0;
+}
+
+size_t MoveList::operator[](size_t index) const {
+  return columns_[index];
+}
+
+size_t* MoveList::begin() {
+  return columns_;
+}
+
+size_t* MoveList::end() {
+  return columns_ + size_;
+}
+
+const size_t* MoveList::begin() const {
+  return columns_;
+}
+
+const size_t* MoveList::end() const {
+  return columns_ + size_;
+}
+
+GameBoard::GameBoard() : is_x_turn_(true), gamestate_(BoardState::InProgress),
+      x_bitboard_(0), occupied_bitboard_(0) {
 }
 
 GameBoard::GameBoard(const vector<vector<int>>& pieces, bool is_x_turn) :
-      pieces_(pieces), is_x_turn_(is_x_turn), gamestate_(BoardState::InProgress) {
+      is_x_turn_(is_x_turn), gamestate_(BoardState::InProgress),
+      x_bitboard_(0), occupied_bitboard_(0) {
   // Check board validity
   if (pieces.size() != kHeight || pieces[0].size() != kWidth) {
     throw std::invalid_argument("Board is of wrong shape");
   }
 
+  // Fill in the bitboards
+  for (size_t row = 0; row < kHeight; row++) {
+    if (pieces[row].size() != kWidth) {
+      throw std::invalid_argument("Board is of wrong shape");
+    }
+
+    for (size_t col = 0; col < kWidth; col++) {
+      if (pieces[row][col] == kXPiece) {
+        x_bitboard_ |= CalculateCellMask(row, col);
+      }
+      if (pieces[row][col] != kEmpty) {
+        occupied_bitboard_ |= CalculateCellMask(row, col);
+      }
+    }
+  }
+
   // Update and check gamestate
   if (!ArePiecesValid(kXPiece, kOPiece)) {
     throw std::invalid_argument("Board is invalid");
@@ -23,40 +89,61 @@ GameBoard::GameBoard(const vector<vector<int>>& pieces, bool is_x_turn) :
   UpdateGameState();
 }
 
-void GameBoard::Reset() {
-  for (vector<int>& row : pieces_) {
-    std::fill(row.begin(), row.end(), 0);
+GameBoard GameBoard::FromMoves(const std::string& moves) {
+  GameBoard board;
+  for (char move : moves) {
+    if (move < '0' || move >= static_cast<char>('0' + kWidth) ||
+        !board.DropPiece(move - '0')) {
+      throw std::invalid_argument("Invalid move in " + moves);
+    }
   }
+  return board;
+}
+
+void GameBoard::Reset() {
   gamestate_ = BoardState::InProgress;
   is_x_turn_ = true;
+  x_bitboard_ = 0;
+  occupied_bitboard_ = 0;
 }
 
 int GameBoard::GetPieceAtLocation(size_t row, size_t column) const {
-  return pieces_[row][column];
+  uint64_t cell = CalculateCellMask(row, column);
+  if ((occupied_bitboard_ & cell) == 0) {
+    return kEmpty;
+  }
+  if ((x_bitboard_ & cell) != 0) {
+    return kXPiece;
+  }
+  return kOPiece;
 }
 
 bool GameBoard::GetIsXTurn() const {
   return is_x_turn_;
 }
 
+uint64_t GameBoard::GetXBitboard() const {
+  return x_bitboard_;
+}
+
+uint64_t GameBoard::GetOBitboard() const {
+  return occupied_bitboard_ ^ x_bitboard_;
+}
+
+uint64_t GameBoard::GetOccupiedBitboard() const {
+  return occupied_bitboard_;
+}
+
 BoardState GameBoard::GetGameState() const {
   return gamestate_;
 }
 
-vector<size_t> GameBoard::CalculateValidColumns() const {
-  vector<size_t> valids;
-
+MoveList GameBoard::CalculateValidColumns() const {
   // Check if the game is over, then check all columns
   if (gamestate_ != BoardState::InProgress) {
-    return valids;
+    return MoveList();
   }
-
-  for (size_t col : kColumnOrder) {
-    if (FindColumnBottom(col) != -1) {
-      valids.push_back(col);
-    }
-  }
-  return valids;
+  return ConvertToColumns(CalculatePlayableCells());
 }
 
 bool GameBoard::DropPiece(size_t column) {
@@ -65,19 +152,16 @@ bool GameBoard::DropPiece(size_t column) {
     throw std::out_of_range("Column out of range");
   }
 
-  // Get the current player's piece
-  int piece = kXPiece;
-  if (!is_x_turn_) {
-    piece = kOPiece;
-  }
-
   int bottom = FindColumnBottom(column);
   if (gamestate_ != BoardState::InProgress || bottom == -1) {
     return false;
   }
 
   // Place the piece, update turn and gamestate
-  pieces_[bottom][column] = piece;
+  occupied_bitboard_ |= CalculateCellMask(bottom, column);
+  if (is_x_turn_) {
+    x_bitboard_ |= CalculateCellMask(bottom, column);
+  }
   is_x_turn_ = !is_x_turn_;
   UpdateGameState();
 
@@ -94,20 +178,117 @@ std::vector<float> GameBoard::GenerateVectorFeatures() const {
   return features;
 }
 
-bool GameBoard::IsColumnValid(size_t col) const {
-  // An invalid column has a space followed by a piece
-  for (size_t row = 0; row < kHeight - 1; row++) {
-    if (GetPieceAtLocation(row + 1, col) == kEmpty &&
-        GetPieceAtLocation(row, col) != kEmpty) {
-      return false;
+uint64_t GameBoard::CalculateThreats(bool is_x) const {
+  uint64_t pieces = is_x ? x_bitboard_ : occupied_bitboard_ ^ x_bitboard_;
+  uint64_t threats = 0;
+
+  // Shifting by these amounts moves one cell vertically, horizontally and
+  // along both diagonals
+  const size_t kShifts[4] = {1, kHeight + 1, kHeight, kHeight + 2};
+
+  for (size_t shift : kShifts) {
+    if (shift == 1) {
+      // Only three pieces below an empty cell make a vertical threat
+      threats |= (pieces << 1) & (pieces << 2) & (pieces << 3);
+      continue;
     }
+
+    // Two pieces on one side of the cell, with the third on either side
+    uint64_t pair = (pieces << shift) & (pieces << 2 * shift);
+    threats |= pair & (pieces << 3 * shift);
+    threats |= pair & (pieces >> shift);
+
+    pair = (pieces >> shift) & (pieces >> 2 * shift);
+    threats |= pair & (pieces << shift);
+    threats |= pair & (pieces >> 3 * shift);
   }
-  return true;
+
+  // Drop cells that are taken or off the board
+  return threats & (kBoardMask ^ occupied_bitboard_);
+}
+
+uint64_t GameBoard::CalculatePlayableCells() const {
+  // Adding the bottom bit carries into the first empty cell of each column
+  return (occupied_bitboard_ + kBottomMask) & kBoardMask;
+}
+
+uint64_t GameBoard::CalculateWinningMoves(bool is_x) const {
+  return CalculateThreats(is_x) & CalculatePlayableCells();
+}
+
+uint64_t GameBoard::CalculateNonLosingMoves() const {
+  if (gamestate_ != BoardState::InProgress) {
+    return 0;
+  }
+
+  uint64_t playable = CalculatePlayableCells();
+  uint64_t opponent_threats = CalculateThreats(!is_x_turn_);
+  uint64_t forced = playable & opponent_threats;
+
+  if (forced != 0) {
+    // Two threats can't both be blocked
+    if ((forced & (forced - 1)) != 0) {
+      return 0;
+    }
+    playable = forced;
+  }
+
+  // Don't play right below a threat, the opponent would win on top of it
+  return playable & ~(opponent_threats >> 1);
+}
+
+MoveList GameBoard::CalculateNonLosingColumns() const {
+  return ConvertToColumns(CalculateNonLosingMoves());
+}
+
+MoveList GameBoard::ConvertToColumns(uint64_t cells) const {
+  MoveList columns;
+  for (size_t col : kColumnOrder) {
+    uint64_t column_mask = uint64_t(0x3F) << (col * (kHeight + 1));
+    if ((cells & column_mask) != 0) {
+      columns.push_back(col);
+    }
+  }
+  return columns;
+}
+
+uint64_t GameBoard::GetKey() const {
+  // Adding the bottom mask to the occupied cells leaves a single bit just
+  // above the top piece of each column, so X's pieces below it can be
+  // added without collisions
+  return x_bitboard_ + occupied_bitboard_ + kBottomMask;
+}
+
+GameBoard GameBoard::Mirror() const {
+  // The game state and turn don't change under reflection
+  GameBoard mirrored = *this;
+  mirrored.x_bitboard_ = MirrorBitboard(x_bitboard_);
+  mirrored.occupied_bitboard_ = MirrorBitboard(occupied_bitboard_);
+  return mirrored;
+}
+
+uint64_t GameBoard::GetCanonicalKey() const {
+  // Keys are built column by column, so the mirror's key is the key with
+  // its columns reversed
+  uint64_t key = GetKey();
+  return std::min(key, MirrorBitboard(key));
+}
+
+uint64_t GameBoard::CalculateCellMask(size_t row, size_t column) const {
+  // Rows are indexed from the top, bitboards from the bottom
+  return uint64_t(1) << (column * (kHeight + 1) + (kHeight - 1 - row));
+}
+
+bool GameBoard::IsColumnValid(size_t col) const {
+  // An invalid column has a space followed by a piece, so its bits aren't
+  // one run starting from the bottom
+  uint64_t column_bits = (occupied_bitboard_ >> (col * (kHeight + 1))) & 0x3F;
+  return (column_bits & (column_bits + 1)) == 0;
 }
 
 int GameBoard::FindColumnBottom(size_t col) const {
   for (int row = kHeight; row > 0; row--) {
-    if (GetPieceAtLocation(row - 1, col) == kEmpty) {
+    if ((occupied_bitboard_ & CalculateCellMask(row - 1, col)) == 0) {
       return row - 1;
     }
   }
@@ -115,31 +296,18 @@ int GameBoard::FindColumnBottom(size_t col) const {
 }
 
 void GameBoard::UpdateGameState() {
-  int x_piece = kXPiece;
-  int o_piece = kOPiece;
-
-  if (HasHorizontalWins(x_piece) || HasVerticalWins(x_piece) ||
-      HasUpRightDiagonalWins(x_piece) || HasDownRightDiagonalWins(x_piece)) {
+  if (HasFourInARow(x_bitboard_)) {
     gamestate_ = BoardState::Xwins;
     return;
   }
 
-  if (HasHorizontalWins(o_piece) || HasVerticalWins(o_piece) ||
-      HasUpRightDiagonalWins(o_piece) || HasDownRightDiagonalWins(o_piece)) {
+  if (HasFourInARow(occupied_bitboard_ ^ x_bitboard_)) {
     gamestate_ = BoardState::Owins;
     return;
   }
 
   // If each column is filled, the game is a tie
-  bool all_filled = true;
-  for (size_t col = 0; col < kWidth; col++) {
-    if (FindColumnBottom(col) != -1) {
-      all_filled = false;
-      break;
-    }
-  }
-
-  if (all_filled) {
+  if (occupied_bitboard_ == kBoardMask) {
     gamestate_ = BoardState::Tie;
     return;
   }
@@ -167,71 +335,39 @@ bool GameBoard::ArePiecesValid(int x_piece, int o_piece) const {
   return true;
 }
 
-// Helper methods to check wins
-bool GameBoard::HasVerticalWins(int piece) const {
-  // Subtract 4 since 4 pieces must be connected
-  for (size_t row = 0; row <= kHeight - 4; row++) {
-    for (size_t col = 0; col < kWidth; col++) {
-      if (GetPieceAtLocation(row, col) == piece &&
-          GetPieceAtLocation(row + 1, col) == piece &&
-          GetPieceAtLocation(row + 2, col) == piece &&
-          GetPieceAtLocation(row + 3, col) == piece) {
-        return true;
-      }
-    }
-  }
-  return false;
-}
+bool GameBoard::HasFourInARow(uint64_t pieces) const {
+  // Shifting by these amounts moves one cell vertically, horizontally and
+  // along both diagonals
+  const size_t kShifts[4] = {1, kHeight + 1, kHeight, kHeight + 2};
 
-bool GameBoard::HasHorizontalWins(int piece) const {
-  // Subtract 4 since 4 pieces must be connected
-  for (size_t row = 0; row < kHeight; row++) {
-    for (size_t col = 0; col <= kWidth - 4; col++) {
-      if (GetPieceAtLocation(row, col) == piece &&
-          GetPieceAtLocation(row, col + 1) == piece &&
-          GetPieceAtLocation(row, col + 2) == piece &&
-          GetPieceAtLocation(row, col + 3) == piece) {
-        return true;
-      }
+  for (size_t shift : kShifts) {
+    // Cells starting two in a row, then two of those pairs in a row
+    uint64_t pairs = pieces & (pieces >> shift);
+    if ((pairs & (pairs >> 2 * shift)) != 0) {
+      return true;
     }
   }
   return false;
 }
 
-bool GameBoard::HasDownRightDiagonalWins(int piece) const {
-  // Subtract 4 since 4 pieces must be connected
-  for (size_t row = 0; row <= kHeight - 4; row++) {
-    for (size_t col = 0; col <= kWidth - 4; col++) {
-      if (GetPieceAtLocation(row, col) == piece &&
-          GetPieceAtLocation(row + 1, col + 1) == piece &&
-          GetPieceAtLocation(row + 2, col + 2) == piece &&
-          GetPieceAtLocation(row + 3, col + 3) == piece) {
-        return true;
-      }
-    }
-  }
-  return false;
-}
-
-bool GameBoard::HasUpRightDiagonalWins(int piece) const {
-  // Subtract 4 since 4 pieces must be connected
-  for (size_t row = 0; row <= kHeight - 4; row++) {
-    for (size_t col = 0; col <= kWidth - 4; col++) {
-      if (GetPieceAtLocation(row + 3, col) == piece &&
-          GetPieceAtLocation(row + 2, col + 1) == piece &&
-          GetPieceAtLocation(row + 1, col + 2) == piece &&
-          GetPieceAtLocation(row, col + 3) == piece) {
-        return true;
-      }
-    }
+uint64_t GameBoard::MirrorBitboard(uint64_t bitboard) {
+  const uint64_t kColumnMask = 0x7F;
+  uint64_t mirrored = 0;
+  for (size_t col = 0; col < kWidth; col++) {
+    uint64_t column_bits = (bitboard >> (col * (kHeight + 1))) & kColumnMask;
+    mirrored |= column_bits << ((kWidth - 1 - col) * (kHeight + 1));
   }
-  return false;
+  return mirrored;
 }
 
 size_t GameBoard::CalculateNumberPieces(int piece) const {
   size_t sum = 0;
-  for(const vector<int>& row: pieces_) {
-    sum += count(row.begin(), row.end(), piece);
+  for (size_t row = 0; row < kHeight; row++) {
+    for (size_t col = 0; col < kWidth; col++) {
+      if (GetPieceAtLocation(row, col) == piece) {
+        sum++;
+      }
+    }
   }
   return sum;
 }
@@ -0,0 +1,148 @@
+#include <core/load_generator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include <core/gameboard.h>
+#include <core/server.h>
+#include <core/socket.h>
+#include <core/thread_pool.h>
+
+namespace connect_four {
+
+double load_stats::CalculateRequestsPerSecond() const {
+  if (seconds <= 0) {
+    return 0;
+  }
+  return requests / seconds;
+}
+
+LoadGenerator::LoadGenerator(const load_options& options)
+    : options_(options) {
+}
+
+load_stats LoadGenerator::Run() const {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<load_stats> session_stats(options_.number_sessions);
+  std::vector<std::vector<double>> session_latencies(
+      options_.number_sessions);
+
+  // Every session needs its own thread, since each spends most of its time
+  // waiting on the server
+  {
+    ThreadPool pool(std::max<size_t>(options_.number_sessions, 1));
+    std::vector<std::future<void>> sessions;
+    for (size_t session = 0; session < options_.number_sessions;
+         session++) {
+      load_stats* stats = &session_stats[session];
+      std::vector<double>* latencies = &session_latencies[session];
+      sessions.push_back(pool.Submit([this, stats, latencies]() {
+        RunSession(*stats, *latencies);
+      }));
+    }
+    for (std::future<void>& session : sessions) {
+      session.get();
+    }
+  }
+
+  load_stats stats;
+  size_t number_latencies = 0;
+  for (const std::vector<double>& latencies : session_latencies) {
+    number_latencies += latencies.size();
+  }
+  LatencyRecorder recorder(number_latencies);
+  for (size_t session = 0; session < options_.number_sessions; session++) {
+    stats.games += session_stats[session].games;
+    stats.requests += session_stats[session].requests;
+    stats.rejected_requests += session_stats[session].rejected_requests;
+    stats.refused_connections +=
+        session_stats[session].refused_connections;
+    for (double latency : session_latencies[session]) {
+      recorder.Record(latency);
+      stats.latency_max_ms = std::max(stats.latency_max_ms, latency);
+    }
+  }
+  stats.latency_p50_ms = recorder.CalculatePercentile(50);
+  stats.latency_p90_ms = recorder.CalculatePercentile(90);
+  stats.latency_p99_ms = recorder.CalculatePercentile(99);
+  stats.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return stats;
+}
+
+void LoadGenerator::RunSession(load_stats& stats,
+                               std::vector<double>& latencies) const {
+  Socket socket = Connect(stats);
+  std::string go = "go";
+  if (options_.depth > 0) {
+    go += " depth " + std::to_string(options_.depth);
+  }
+  if (options_.move_time_ms > 0) {
+    go += " movetime " + std::to_string(options_.move_time_ms);
+  }
+
+  for (size_t game = 0; game < options_.games_per_session; game++) {
+    GameBoard board;
+    std::string moves;
+    while (board.GetGameState() == BoardState::InProgress) {
+      auto sent = std::chrono::steady_clock::now();
+      if (!socket.WriteLine("position " + moves) || !socket.WriteLine(go)) {
+        throw std::invalid_argument("Server closed the session");
+      }
+
+      // Skip info lines until the answer
+      std::string line;
+      do {
+        if (!socket.ReadLine(line)) {
+          throw std::invalid_argument("Server closed the session");
+        }
+      } while (line != "busy" && line.compare(0, 9, "bestmove ") != 0);
+
+      if (line == "busy") {
+        stats.rejected_requests++;
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(options_.retry_delay_ms));
+        continue;
+      }
+      latencies.push_back(std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - sent).count());
+      stats.requests++;
+
+      std::string move = line.substr(9);
+      if (move.size() != 1 || move[0] < '0' ||
+          move[0] >= static_cast<char>('0' + GameBoard::kWidth) ||
+          !board.DropPiece(move[0] - '0')) {
+        throw std::invalid_argument("Server replied with " + line);
+      }
+      moves += move;
+    }
+    stats.games++;
+  }
+  socket.WriteLine("quit");
+}
+
+Socket LoadGenerator::Connect(load_stats& stats) const {
+  while (true) {
+    // A server with too many sessions writes busy and closes the connection
+    // without reading anything, while one that takes the session answers
+    // isready, so the two can't be confused with a search being turned away
+    Socket socket = Socket::Connect(options_.address);
+    if (socket.WriteLine("isready")) {
+      std::string line;
+      while (socket.ReadLine(line) && line != "busy") {
+        if (line == "readyok") {
+          return socket;
+        }
+      }
+    }
+
+    stats.refused_connections++;
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(options_.retry_delay_ms));
+  }
+}
+
+} // namespace connect_four
@@ -0,0 +1,105 @@
+#include <core/mapped_file.h>
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace connect_four {
+
+MappedFile::MappedFile(const std::string& path) : data_(nullptr), size_(0) {
+#ifdef _WIN32
+  mapping_handle_ = nullptr;
+  file_handle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+  if (file_handle_ == INVALID_HANDLE_VALUE) {
+    file_handle_ = nullptr;
+    throw std::invalid_argument("File stream is not good");
+  }
+
+  LARGE_INTEGER file_size;
+  GetFileSizeEx(file_handle_, &file_size);
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  if (size_ == 0) {
+    return;
+  }
+
+  mapping_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY,
+                                       0, 0, nullptr);
+  if (mapping_handle_ != nullptr) {
+    data_ = static_cast<const char*>(
+        MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+  }
+#else
+  int file = open(path.c_str(), O_RDONLY);
+  if (file == -1) {
+    throw std::invalid_argument("File stream is not good");
+  }
+
+  struct stat file_stats;
+  if (fstat(file, &file_stats) != 0) {
+    close(file);
+    throw std::invalid_argument("File stream is not good");
+  }
+  size_ = file_stats.st_size;
+  if (size_ == 0) {
+    close(file);
+    return;
+  }
+
+  void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+  if (mapping != MAP_FAILED) {
+    data_ = static_cast<const char*>(mapping);
+  }
+  // The mapping stays valid after the file is closed
+  close(file);
+#endif
+
+  if (data_ == nullptr) {
+    Unmap();
+    throw std::invalid_argument("File could not be mapped");
+  }
+}
+
+MappedFile::~MappedFile() {
+  Unmap();
+}
+
+const char* MappedFile::GetData() const {
+  return data_;
+}
+
+size_t MappedFile::GetSize() const {
+  return size_;
+}
+
+void MappedFile::Unmap() {
+#ifdef _WIN32
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_handle_ != nullptr) {
+    CloseHandle(mapping_handle_);
+  }
+  if (file_handle_ != nullptr) {
+    CloseHandle(file_handle_);
+  }
+  mapping_handle_ = nullptr;
+  file_handle_ = nullptr;
+#else
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+}
+
+} // namespace connect_four
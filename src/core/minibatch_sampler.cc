@@ -0,0 +1,86 @@
+#include <core/minibatch_sampler.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace connect_four {
+
+MinibatchSampler::MinibatchSampler(unsigned int seed)
+    : cursor_(0), seed_(seed), mirror_seed_(0), is_mirroring_(false) {
+}
+
+void MinibatchSampler::AddExamples(const example_buffer& buffer, size_t first,
+                                   size_t number_examples) {
+  size_t last = std::min(first + number_examples, buffer.labels.size());
+  for (size_t index = first; index < last; index++) {
+    examples_.push_back(PackedDataset::Pack(
+        buffer.features.data() + index * ParallelParser::kNumberFeatures,
+        buffer.labels[index]));
+  }
+}
+
+void MinibatchSampler::SetMirrorAugmentation(bool is_mirroring) {
+  is_mirroring_ = is_mirroring;
+}
+
+void MinibatchSampler::StartEpoch(size_t epoch) {
+  std::seed_seq seeds{seed_, static_cast<unsigned int>(epoch)};
+  std::mt19937 random(seeds);
+
+  order_.resize(examples_.size());
+  std::iota(order_.begin(), order_.end(), 0);
+  std::shuffle(order_.begin(), order_.end(), random);
+  mirror_seed_ = (static_cast<uint64_t>(random()) << 32) | random();
+  cursor_ = 0;
+}
+
+void MinibatchSampler::Seek(size_t position) {
+  cursor_ = std::min(position, order_.size());
+}
+
+bool MinibatchSampler::Next(size_t number_examples, training_batch& batch) {
+  batch.features.clear();
+  batch.labels.clear();
+  if (cursor_ >= order_.size()) {
+    return false;
+  }
+
+  size_t last = std::min(cursor_ + number_examples, order_.size());
+  for (; cursor_ < last; cursor_++) {
+    const packed_example& example = examples_[order_[cursor_]];
+    tiny_dnn::vec_t features = PackedDataset::Unpack(example.x_mask,
+                                                     example.o_mask);
+
+    // Reverse each row of the board
+    if (is_mirroring_ && IsMirrored(cursor_)) {
+      const size_t kWidth = 7;
+      for (size_t row = 0; row < features.size() / kWidth; row++) {
+        std::reverse(features.begin() + row * kWidth,
+                     features.begin() + (row + 1) * kWidth);
+      }
+    }
+
+    batch.features.push_back(std::move(features));
+    batch.labels.push_back(example.label);
+  }
+  return true;
+}
+
+size_t MinibatchSampler::GetNumberExamples() const {
+  return examples_.size();
+}
+
+size_t MinibatchSampler::GetPosition() const {
+  return cursor_;
+}
+
+bool MinibatchSampler::IsMirrored(size_t position) const {
+  // Mix the position into well distributed bits and use the top one
+  uint64_t hash = (mirror_seed_ + position) * 0x9E3779B97F4A7C15ULL;
+  hash ^= hash >> 31;
+  hash *= 0xBF58476D1CE4E5B9ULL;
+  return (hash >> 63) != 0;
+}
+
+} // namespace connect_four
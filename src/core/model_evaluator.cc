@@ -0,0 +1,119 @@
+#include <core/model_evaluator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+#include <core/parallel_parser.h>
+
+namespace connect_four {
+
+float evaluation_result::CalculateAccuracy() const {
+  if (number_examples == 0) {
+    return 0;
+  }
+  return 100.0f * number_correct / number_examples;
+}
+
+ModelEvaluator::ModelEvaluator(const std::string& model_path,
+                               size_t number_threads, size_t batch_size)
+    : pool_(number_threads), models_(pool_.GetNumberThreads()),
+      batch_size_(std::max<size_t>(batch_size, 1)) {
+  for (tiny_dnn::network<tiny_dnn::sequential>& model : models_) {
+    model.load(model_path);
+  }
+}
+
+evaluation_result ModelEvaluator::Evaluate(const float* features,
+                                           const tiny_dnn::label_t* labels,
+                                           size_t number_examples) {
+  return EvaluateBatches([features](size_t index) {
+    return features + index * ParallelParser::kNumberFeatures;
+  }, labels, number_examples);
+}
+
+evaluation_result ModelEvaluator::Evaluate(
+    const std::vector<tiny_dnn::vec_t>& features,
+    const std::vector<tiny_dnn::label_t>& labels) {
+  if (features.size() != labels.size()) {
+    throw std::invalid_argument("Every example needs a label");
+  }
+  for (const tiny_dnn::vec_t& example : features) {
+    if (example.size() != ParallelParser::kNumberFeatures) {
+      throw std::invalid_argument("Every example needs 42 features");
+    }
+  }
+  return EvaluateBatches([&features](size_t index) {
+    return features[index].data();
+  }, labels.data(), labels.size());
+}
+
+size_t ModelEvaluator::GetNumberThreads() const {
+  return models_.size();
+}
+
+evaluation_result ModelEvaluator::EvaluateBatches(
+    const std::function<const float*(size_t)>& get_features,
+    const tiny_dnn::label_t* labels, size_t number_examples) {
+  auto start = std::chrono::steady_clock::now();
+
+  // Each worker counts into its own result, merged at the end
+  std::atomic<size_t> next_batch(0);
+  std::vector<std::future<evaluation_result>> workers;
+  for (size_t worker = 0; worker < models_.size(); worker++) {
+    tiny_dnn::network<tiny_dnn::sequential>& model = models_[worker];
+    workers.push_back(pool_.Submit([this, &model, &get_features, labels,
+                                    number_examples, &next_batch]() {
+      evaluation_result result;
+      // One sample of one channel per example, reused from batch to batch
+      std::vector<tiny_dnn::tensor_t> batch;
+      for (size_t first = next_batch++ * batch_size_; first < number_examples;
+           first = next_batch++ * batch_size_) {
+        size_t last = std::min(first + batch_size_, number_examples);
+        batch.resize(last - first);
+        for (size_t index = first; index < last; index++) {
+          const float* example = get_features(index);
+          tiny_dnn::tensor_t& sample = batch[index - first];
+          sample.resize(1);
+          sample[0].assign(example,
+                           example + ParallelParser::kNumberFeatures);
+        }
+
+        std::vector<tiny_dnn::tensor_t> predictions = model.predict(batch);
+        for (size_t index = first; index < last; index++) {
+          const tiny_dnn::vec_t& prediction = predictions[index - first][0];
+          size_t predicted = std::max_element(prediction.begin(),
+                                              prediction.end()) -
+                             prediction.begin();
+          if (labels[index] < 3 && predicted < 3) {
+            result.confusion[labels[index]][predicted]++;
+          }
+          if (predicted == labels[index]) {
+            result.number_correct++;
+          }
+          result.number_examples++;
+        }
+      }
+      return result;
+    }));
+  }
+
+  evaluation_result totals;
+  for (std::future<evaluation_result>& worker : workers) {
+    evaluation_result result = worker.get();
+    for (size_t label = 0; label < 3; label++) {
+      for (size_t predicted = 0; predicted < 3; predicted++) {
+        totals.confusion[label][predicted] +=
+            result.confusion[label][predicted];
+      }
+    }
+    totals.number_examples += result.number_examples;
+    totals.number_correct += result.number_correct;
+  }
+  totals.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return totals;
+}
+
+} // namespace connect_four
@@ -0,0 +1,184 @@
+#include <core/packed_dataset.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace connect_four {
+
+constexpr size_t PackedDataset::kRecordSize;
+constexpr uint32_t PackedDataset::kMagic;
+constexpr uint32_t PackedDataset::kVersion;
+constexpr size_t PackedDataset::kHeaderSize;
+constexpr size_t PackedDataset::kNumberCells;
+
+PackedDataset::PackedDataset(const std::string& packed_path)
+    : file_(packed_path), number_examples_(0) {
+  // Check the header before trusting the records
+  if (file_.GetSize() < kHeaderSize) {
+    throw std::invalid_argument("File is not a packed dataset");
+  }
+
+  uint32_t magic;
+  uint32_t version;
+  uint64_t number_examples;
+  std::memcpy(&magic, file_.GetData(), sizeof(magic));
+  std::memcpy(&version, file_.GetData() + 4, sizeof(version));
+  std::memcpy(&number_examples, file_.GetData() + 8, sizeof(number_examples));
+  if (magic != kMagic || version != kVersion ||
+      (file_.GetSize() - kHeaderSize) / kRecordSize < number_examples) {
+    throw std::invalid_argument("File is not a packed dataset");
+  }
+  number_examples_ = number_examples;
+}
+
+size_t PackedDataset::Convert(DataStream& stream,
+                              const std::string& packed_path) {
+  PackedDatasetWriter writer(packed_path);
+
+  // Parse in chunks so the whole CSV is never expanded in memory
+  const size_t kChunkSize = 10000;
+  DataParser parser;
+  while (true) {
+    parser.Clear();
+    size_t next_example = stream.GetNextExample();
+    parser.YieldTrainingData(stream, kChunkSize);
+    if (stream.GetNextExample() == next_example) {
+      break;
+    }
+
+    const std::vector<tiny_dnn::vec_t>& features = parser.GetTrainFeatures();
+    const std::vector<tiny_dnn::label_t>& labels = parser.GetTrainLabels();
+    for (size_t i = 0; i < features.size(); i++) {
+      writer.Write(Pack(features[i].data(), labels[i]));
+    }
+  }
+  return writer.Close();
+}
+
+size_t PackedDataset::Convert(const example_buffer& buffer,
+                              const std::string& packed_path) {
+  PackedDatasetWriter writer(packed_path);
+  for (size_t i = 0; i < buffer.labels.size(); i++) {
+    writer.Write(Pack(buffer.features.data() + i * kNumberCells,
+                      buffer.labels[i]));
+  }
+  return writer.Close();
+}
+
+void PackedDataset::YieldExamples(
+    size_t start, size_t number_examples,
+    std::vector<tiny_dnn::vec_t>& features,
+    std::vector<tiny_dnn::label_t>& labels) const {
+  // Examples are one-indexed
+  size_t first = start == 0 ? 0 : start - 1;
+  if (first >= number_examples_) {
+    return;
+  }
+  size_t last = std::min(first + number_examples, number_examples_);
+
+  features.reserve(features.size() + last - first);
+  labels.reserve(labels.size() + last - first);
+  for (size_t index = first; index < last; index++) {
+    packed_example example = GetExample(index);
+    features.push_back(Unpack(example.x_mask, example.o_mask));
+    labels.push_back(example.label);
+  }
+}
+
+packed_example PackedDataset::GetExample(size_t index) const {
+  if (index >= number_examples_) {
+    throw std::out_of_range("Example out of range");
+  }
+
+  // Records aren't aligned, so copy the masks out
+  const char* record = file_.GetData() + kHeaderSize + index * kRecordSize;
+  packed_example example;
+  std::memcpy(&example.x_mask, record, sizeof(example.x_mask));
+  std::memcpy(&example.o_mask, record + 8, sizeof(example.o_mask));
+  example.label = static_cast<uint8_t>(record[16]);
+  return example;
+}
+
+size_t PackedDataset::GetNumberExamples() const {
+  return number_examples_;
+}
+
+packed_example PackedDataset::Pack(const float* features,
+                                   tiny_dnn::label_t label) {
+  packed_example example;
+  for (size_t cell = 0; cell < kNumberCells; cell++) {
+    if (features[cell] > 0) {
+      example.x_mask |= uint64_t(1) << cell;
+    } else if (features[cell] < 0) {
+      example.o_mask |= uint64_t(1) << cell;
+    }
+  }
+  example.label = static_cast<uint8_t>(label);
+  return example;
+}
+
+tiny_dnn::vec_t PackedDataset::Unpack(uint64_t x_mask, uint64_t o_mask) {
+  tiny_dnn::vec_t features(kNumberCells, 0);
+  for (size_t cell = 0; cell < kNumberCells; cell++) {
+    if ((x_mask >> cell) & 1) {
+      features[cell] = 1;
+    } else if ((o_mask >> cell) & 1) {
+      features[cell] = -1;
+    }
+  }
+  return features;
+}
+
+PackedDatasetWriter::PackedDatasetWriter(const std::string& packed_path)
+    : number_examples_(0), is_closed_(false) {
+  packed_file_.open(packed_path, std::ios::binary);
+  if (!packed_file_.is_open()) {
+    throw std::invalid_argument("File stream is not good");
+  }
+
+  // The number of examples is filled in on Close
+  packed_file_.write(reinterpret_cast<const char*>(&PackedDataset::kMagic),
+                     sizeof(PackedDataset::kMagic));
+  packed_file_.write(reinterpret_cast<const char*>(&PackedDataset::kVersion),
+                     sizeof(PackedDataset::kVersion));
+  packed_file_.write(reinterpret_cast<const char*>(&number_examples_),
+                     sizeof(number_examples_));
+}
+
+PackedDatasetWriter::~PackedDatasetWriter() {
+  if (!is_closed_) {
+    try {
+      Close();
+    } catch (const std::invalid_argument&) {
+      // Destructors can't report errors, call Close to see them
+    }
+  }
+}
+
+void PackedDatasetWriter::Write(const packed_example& example) {
+  char record[PackedDataset::kRecordSize];
+  std::memcpy(record, &example.x_mask, sizeof(example.x_mask));
+  std::memcpy(record + 8, &example.o_mask, sizeof(example.o_mask));
+  record[16] = static_cast<char>(example.label);
+  packed_file_.write(record, PackedDataset::kRecordSize);
+  number_examples_++;
+}
+
+size_t PackedDatasetWriter::Close() {
+  is_closed_ = true;
+  packed_file_.seekp(8);
+  packed_file_.write(reinterpret_cast<const char*>(&number_examples_),
+                     sizeof(number_examples_));
+  packed_file_.close();
+  if (packed_file_.fail()) {
+    throw std::invalid_argument("File stream is not good");
+  }
+  return number_examples_;
+}
+
+size_t PackedDatasetWriter::GetNumberExamples() const {
+  return number_examples_;
+}
+
+} // namespace connect_four
@@ -0,0 +1,260 @@
+#include <core/parallel_parser.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <core/mapped_file.h>
+
+namespace connect_four {
+
+constexpr size_t ParallelParser::kNumberFeatures;
+
+ParallelParser::ParallelParser(ThreadPool& pool) : pool_(pool) {
+}
+
+void ParallelParser::Parse(const std::string& csv_path, DataFormat format,
+                           example_buffer& buffer) const {
+  MappedFile file(csv_path);
+  buffer.features.clear();
+  buffer.labels.clear();
+  if (file.GetSize() == 0) {
+    return;
+  }
+  const char* begin = file.GetData();
+  const char* end = begin + file.GetSize();
+
+  // Numeric CSVs start with a header
+  if (format == DataFormat::Numeric) {
+    const char* header_end =
+        static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    begin = header_end == nullptr ? end : header_end + 1;
+  }
+
+  // A few chunks per worker evens out the load, and every chunk boundary is
+  // moved just past a line break
+  size_t number_chunks = pool_.GetNumberThreads() * 4;
+  std::vector<const char*> boundaries(1, begin);
+  for (size_t chunk = 1; chunk < number_chunks; chunk++) {
+    const char* split = begin + (end - begin) * chunk / number_chunks;
+    split = std::max(split, boundaries.back());
+    const char* line_end =
+        static_cast<const char*>(std::memchr(split, '\n', end - split));
+    boundaries.push_back(line_end == nullptr ? end : line_end + 1);
+  }
+  boundaries.push_back(end);
+
+  // Count lines first so every chunk knows where its slice of the buffer
+  // starts
+  std::vector<std::future<size_t>> line_counts;
+  for (size_t chunk = 0; chunk < number_chunks; chunk++) {
+    const char* chunk_begin = boundaries[chunk];
+    const char* chunk_end = boundaries[chunk + 1];
+    line_counts.push_back(pool_.Submit([chunk_begin, chunk_end]() {
+      return CountLines(chunk_begin, chunk_end);
+    }));
+  }
+  std::vector<size_t> first_slots(1, 0);
+  for (std::future<size_t>& count : line_counts) {
+    first_slots.push_back(first_slots.back() + count.get());
+  }
+
+  buffer.features.resize(first_slots.back() * kNumberFeatures);
+  buffer.labels.resize(first_slots.back());
+
+  std::vector<std::future<size_t>> parsed_counts;
+  for (size_t chunk = 0; chunk < number_chunks; chunk++) {
+    const char* chunk_begin = boundaries[chunk];
+    const char* chunk_end = boundaries[chunk + 1];
+    float* features = buffer.features.data() +
+                      first_slots[chunk] * kNumberFeatures;
+    tiny_dnn::label_t* labels = buffer.labels.data() + first_slots[chunk];
+    parsed_counts.push_back(pool_.Submit(
+        [chunk_begin, chunk_end, format, features, labels]() {
+      return ParseChunk(chunk_begin, chunk_end, format, features, labels);
+    }));
+  }
+
+  // Skipped lines leave gaps at the end of their chunk's slice, so close
+  // them up
+  size_t number_examples = 0;
+  for (size_t chunk = 0; chunk < number_chunks; chunk++) {
+    size_t parsed = parsed_counts[chunk].get();
+    if (number_examples != first_slots[chunk]) {
+      std::memmove(buffer.features.data() + number_examples * kNumberFeatures,
+                   buffer.features.data() +
+                       first_slots[chunk] * kNumberFeatures,
+                   parsed * kNumberFeatures * sizeof(float));
+      std::memmove(buffer.labels.data() + number_examples,
+                   buffer.labels.data() + first_slots[chunk],
+                   parsed * sizeof(tiny_dnn::label_t));
+    }
+    number_examples += parsed;
+  }
+  buffer.features.resize(number_examples * kNumberFeatures);
+  buffer.labels.resize(number_examples);
+}
+
+size_t ParallelParser::CountLines(const char* begin, const char* end) {
+  size_t lines = std::count(begin, end, '\n');
+  if (begin != end && *(end - 1) != '\n') {
+    lines++;
+  }
+  return lines;
+}
+
+size_t ParallelParser::ParseChunk(const char* begin, const char* end,
+                                  DataFormat format, float* features,
+                                  tiny_dnn::label_t* labels) {
+  size_t parsed = 0;
+  const char* line_begin = begin;
+  while (line_begin < end) {
+    const char* line_end = static_cast<const char*>(
+        std::memchr(line_begin, '\n', end - line_begin));
+    if (line_end == nullptr) {
+      line_end = end;
+    }
+
+    // Strip Windows line endings
+    const char* content_end = line_end;
+    if (content_end != line_begin && *(content_end - 1) == '\r') {
+      content_end--;
+    }
+
+    float* example_features = features + parsed * kNumberFeatures;
+    bool is_parsed;
+    if (format == DataFormat::Numeric) {
+      is_parsed = ParseNumericLine(line_begin, content_end, example_features,
+                                   labels[parsed]);
+    } else {
+      is_parsed = ParseStringLine(line_begin, content_end, example_features,
+                                  labels[parsed]);
+    }
+    if (is_parsed) {
+      parsed++;
+    }
+
+    line_begin = line_end + 1;
+  }
+  return parsed;
+}
+
+bool ParallelParser::ParseNumericLine(const char* begin, const char* end,
+                                      float* features,
+                                      tiny_dnn::label_t& label) {
+  size_t field = 0;
+  const char* cursor = begin;
+  while (cursor < end) {
+    float value = 0;
+    const char* number_end = ParseNumber(cursor, end, value);
+    if (number_end == cursor || field > kNumberFeatures + 1) {
+      return false;
+    }
+
+    // Solved datasets have the solve depth after the label, which is skipped
+    if (field < kNumberFeatures) {
+      features[field] = value;
+    } else if (field == kNumberFeatures) {
+      // Since labels are stored as -1, 1, or 0, add 1 to
+      // scale to 0 to 2 range for categorization
+      label = static_cast<tiny_dnn::label_t>(value + 1);
+    }
+    field++;
+
+    // Move past the comma
+    cursor = number_end;
+    if (cursor < end) {
+      if (*cursor != ',') {
+        return false;
+      }
+      cursor++;
+    }
+  }
+  return field == kNumberFeatures + 1 || field == kNumberFeatures + 2;
+}
+
+bool ParallelParser::ParseStringLine(const char* begin, const char* end,
+                                     float* features,
+                                     tiny_dnn::label_t& label) {
+  // Skip empty lines
+  if (begin == end) {
+    return false;
+  }
+
+  const size_t kWidth = 7;
+  const size_t kHeight = 6;
+  std::fill(features, features + kNumberFeatures, 0.0f);
+  label = 0;
+
+  size_t index = 0;
+  const char* field_begin = begin;
+  while (true) {
+    const char* field_end = static_cast<const char*>(
+        std::memchr(field_begin, ',', end - field_begin));
+    if (field_end == nullptr) {
+      field_end = end;
+    }
+    size_t length = field_end - field_begin;
+
+    if (field_end == end) {
+      // Last column is the label, win loss or draw
+      if (length == 3 && std::memcmp(field_begin, "win", 3) == 0) {
+        label = 2;
+      } else if (length == 4 && std::memcmp(field_begin, "draw", 4) == 0) {
+        label = 1;
+      }
+      return true;
+    }
+
+    if (index < kNumberFeatures && length == 1) {
+      // The cells are column by column from the bottom
+      float* cell =
+          features + (kHeight - 1 - index % kHeight) * kWidth + index / kHeight;
+      if (*field_begin == 'x') {
+        *cell = 1;
+      } else if (*field_begin == 'o') {
+        *cell = -1;
+      }
+    }
+
+    index++;
+    field_begin = field_end + 1;
+  }
+}
+
+const char* ParallelParser::ParseNumber(const char* begin, const char* end,
+                                        float& value) {
+  const char* cursor = begin;
+  bool is_negative = false;
+  if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+    is_negative = *cursor == '-';
+    cursor++;
+  }
+
+  const char* digits_begin = cursor;
+  float result = 0;
+  while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+    result = result * 10 + (*cursor - '0');
+    cursor++;
+  }
+
+  if (cursor < end && *cursor == '.') {
+    cursor++;
+    float place = 0.1f;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+      result += (*cursor - '0') * place;
+      place *= 0.1f;
+      cursor++;
+    }
+  }
+
+  // A sign or point alone isn't a number
+  if (cursor == digits_begin ||
+      (cursor == digits_begin + 1 && *digits_begin == '.')) {
+    return begin;
+  }
+
+  value = is_negative ? -result : result;
+  return cursor;
+}
+
+} // namespace connect_four
@@ -0,0 +1,70 @@
+#include <core/persistent_adam.h>
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace connect_four {
+
+void PersistentAdam::reset() {
+}
+
+void PersistentAdam::ClearState() {
+  tiny_dnn::adam::reset();
+  b1_t = b1;
+  b2_t = b2;
+}
+
+void PersistentAdam::SaveState(
+    std::ostream& output, tiny_dnn::network<tiny_dnn::sequential>& network) {
+  output.write(reinterpret_cast<const char*>(&alpha), sizeof(alpha));
+  output.write(reinterpret_cast<const char*>(&b1_t), sizeof(b1_t));
+  output.write(reinterpret_cast<const char*>(&b2_t), sizeof(b2_t));
+
+  // Weights without estimates yet are written as empty
+  for (size_t layer = 0; layer < network.depth(); layer++) {
+    for (tiny_dnn::vec_t* weights : network[layer]->weights()) {
+      for (auto& moments : E_) {
+        auto found = moments.find(weights);
+        uint64_t size = found == moments.end() ? 0 : found->second.size();
+        output.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        if (size != 0) {
+          output.write(reinterpret_cast<const char*>(found->second.data()),
+                       size * sizeof(tiny_dnn::float_t));
+        }
+      }
+    }
+  }
+}
+
+void PersistentAdam::LoadState(
+    std::istream& input, tiny_dnn::network<tiny_dnn::sequential>& network) {
+  ClearState();
+  input.read(reinterpret_cast<char*>(&alpha), sizeof(alpha));
+  input.read(reinterpret_cast<char*>(&b1_t), sizeof(b1_t));
+  input.read(reinterpret_cast<char*>(&b2_t), sizeof(b2_t));
+
+  for (size_t layer = 0; layer < network.depth(); layer++) {
+    for (tiny_dnn::vec_t* weights : network[layer]->weights()) {
+      for (auto& moments : E_) {
+        uint64_t size = 0;
+        input.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!input.good() || (size != 0 && size != weights->size())) {
+          throw std::invalid_argument("Optimizer state doesn't match the "
+                                      "network");
+        }
+        if (size != 0) {
+          tiny_dnn::vec_t& estimates = moments[weights];
+          estimates.resize(size);
+          input.read(reinterpret_cast<char*>(estimates.data()),
+                     size * sizeof(tiny_dnn::float_t));
+        }
+      }
+    }
+  }
+
+  if (!input.good()) {
+    throw std::invalid_argument("Optimizer state doesn't match the network");
+  }
+}
+
+} // namespace connect_four
@@ -0,0 +1,178 @@
+#include <core/position_analyzer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+#include <core/solver.h>
+
+namespace connect_four {
+
+PositionReader::PositionReader(const std::string& path,
+                               PositionFormat format)
+    : format_(format), position_number_(0) {
+  if (format == PositionFormat::Moves) {
+    moves_.open(path);
+    if (!moves_.is_open()) {
+      throw std::invalid_argument("File stream is not good");
+    }
+  } else {
+    csv_.reset(new DataStream(path, format == PositionFormat::Numeric
+                                        ? DataFormat::Numeric
+                                        : DataFormat::String));
+  }
+}
+
+bool PositionReader::Next(GameBoard& board) {
+  std::string line;
+  if (format_ == PositionFormat::Moves) {
+    if (!std::getline(moves_, line)) {
+      return false;
+    }
+    position_number_++;
+
+    // Allow Windows line endings and stray spaces around the moves
+    size_t first = line.find_first_not_of(" \t\r");
+    size_t last = line.find_last_not_of(" \t\r");
+    line = first == std::string::npos ? ""
+                                      : line.substr(first, last - first + 1);
+    board = GameBoard::FromMoves(line);
+    return true;
+  }
+
+  if (!csv_->ReadLine(line)) {
+    return false;
+  }
+  position_number_++;
+
+  tiny_dnn::vec_t features;
+  tiny_dnn::label_t label;
+  if (!parser_.ParseLine(line, csv_->GetFormat(), features, label)) {
+    throw std::invalid_argument("Line is not an example");
+  }
+  board = DatasetSolver::CreateBoard(features.data());
+  return true;
+}
+
+size_t PositionReader::GetPositionNumber() const {
+  return position_number_;
+}
+
+double analysis_stats::CalculatePositionsPerSecond() const {
+  if (seconds <= 0) {
+    return 0;
+  }
+  return positions / seconds;
+}
+
+PositionAnalyzer::PositionAnalyzer(const analysis_options& options)
+    : options_(options), pool_(options.number_threads) {
+  options_.batch_size = std::max<size_t>(options_.batch_size, 1);
+  for (size_t worker = 0; worker < pool_.GetNumberThreads(); worker++) {
+    computers_.emplace_back(new Computer());
+  }
+}
+
+analysis_stats PositionAnalyzer::Run(PositionReader& reader,
+                                     std::ostream& output) {
+  auto start = std::chrono::steady_clock::now();
+  analysis_stats stats;
+  output << "position,best_move,score,depth,nodes,pv\n";
+
+  std::vector<GameBoard> boards;
+  std::vector<size_t> numbers;
+  std::vector<search_result> results;
+  while (true) {
+    boards.clear();
+    numbers.clear();
+    GameBoard board;
+    bool has_more = true;
+    while (boards.size() < options_.batch_size) {
+      try {
+        has_more = reader.Next(board);
+      } catch (const std::invalid_argument&) {
+        stats.positions_skipped++;
+        continue;
+      }
+      if (!has_more) {
+        break;
+      }
+      boards.push_back(board);
+      numbers.push_back(reader.GetPositionNumber());
+    }
+    if (boards.empty()) {
+      break;
+    }
+
+    // Workers take the next position until the batch is done, so slow
+    // positions don't hold up a whole worker's share
+    results.assign(boards.size(), search_result());
+    std::atomic<size_t> next_board(0);
+    std::vector<std::future<void>> workers;
+    for (std::unique_ptr<Computer>& computer : computers_) {
+      Computer* worker_computer = computer.get();
+      workers.push_back(pool_.Submit([this, worker_computer, &boards,
+                                      &results, &next_board]() {
+        for (size_t index = next_board++; index < boards.size();
+             index = next_board++) {
+          results[index] = Analyze(*worker_computer, boards[index]);
+        }
+      }));
+    }
+    for (std::future<void>& worker : workers) {
+      worker.get();
+    }
+
+    for (size_t index = 0; index < boards.size(); index++) {
+      const search_result& result = results[index];
+      output << numbers[index] << ",";
+      if (result.principal_variation.empty()) {
+        output << "none";
+      } else {
+        output << result.column;
+      }
+      // Negamax can leave a negative zero, which reads oddly
+      float score = result.score == 0 ? 0 : result.score;
+      output << "," << score << "," << result.depth << "," << result.nodes
+             << ",";
+      for (size_t column : result.principal_variation) {
+        output << column;
+      }
+      output << "\n";
+      stats.nodes += result.nodes;
+    }
+    stats.positions += boards.size();
+
+    // Each batch reaches the output before the next is read
+    output.flush();
+    if (!output.good()) {
+      throw std::invalid_argument("File stream is not good");
+    }
+    if (!has_more) {
+      break;
+    }
+  }
+
+  stats.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return stats;
+}
+
+size_t PositionAnalyzer::GetNumberThreads() const {
+  return pool_.GetNumberThreads();
+}
+
+search_result PositionAnalyzer::Analyze(Computer& computer,
+                                        const GameBoard& board) const {
+  search_options search(Computer::CapDepth(board, options_.depth),
+                        SearchAlgorithm::PrincipalVariation,
+                        options_.evaluator);
+  if (options_.move_time_ms > 0) {
+    search.deadline = std::chrono::steady_clock::now() +
+                      std::chrono::milliseconds(options_.move_time_ms);
+  }
+  return computer.Search(board, search);
+}
+
+} // namespace connect_four
@@ -0,0 +1,77 @@
+#include <core/run_log.h>
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace connect_four {
+
+RunLog::RunLog(const std::string& log_path, bool is_appending)
+    : log_(log_path, is_appending ? std::ios::app : std::ios::out),
+      start_(std::chrono::steady_clock::now()) {
+  if (!log_.is_open()) {
+    throw std::invalid_argument("File stream is not good");
+  }
+}
+
+void RunLog::LogStep(const step_record& record) {
+  double examples_per_second = record.train_seconds > 0
+      ? record.examples / record.train_seconds : 0;
+
+  // Flush every line so the log can be followed while training runs
+  log_ << "{\"type\":\"step\",\"epoch\":" << record.epoch
+       << ",\"step\":" << record.step
+       << ",\"examples\":" << record.examples
+       << ",\"examples_per_sec\":" << examples_per_second
+       << ",\"load_seconds\":" << record.load_seconds
+       << ",\"stall_seconds\":" << record.stall_seconds
+       << ",\"train_seconds\":" << record.train_seconds
+       << ",\"loss\":" << record.loss
+       << ",\"elapsed_seconds\":" << CalculateElapsedSeconds()
+       << "}" << std::endl;
+}
+
+void RunLog::LogEpoch(const epoch_record& record) {
+  log_ << "{\"type\":\"epoch\",\"epoch\":" << record.epoch
+       << ",\"examples\":" << record.examples
+       << ",\"test_accuracy\":" << record.test_accuracy
+       << ",\"epoch_seconds\":" << record.epoch_seconds
+       << ",\"peak_rss_bytes\":" << GetPeakMemoryBytes()
+       << ",\"elapsed_seconds\":" << CalculateElapsedSeconds()
+       << "}" << std::endl;
+}
+
+uint64_t RunLog::GetPeakMemoryBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                            sizeof(counters))) {
+    return 0;
+  }
+  return counters.PeakWorkingSetSize;
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  // macOS reports bytes, Linux reports kilobytes
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double RunLog::CalculateElapsedSeconds() const {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start_).count();
+}
+
+} // namespace connect_four
@@ -0,0 +1,58 @@
+#include <core/search_bench.h>
+
+#include <chrono>
+
+namespace connect_four {
+
+constexpr size_t SearchBench::kDefaultDepth;
+
+double bench_result::CalculateNodesPerSecond() const {
+  if (seconds <= 0) {
+    return 0;
+  }
+  return nodes / seconds;
+}
+
+SearchBench::SearchBench(size_t depth, SearchAlgorithm algorithm)
+    : options_(depth, algorithm, Evaluator::Threats) {
+}
+
+bench_result SearchBench::Run(Computer& computer) const {
+  bench_result result;
+  auto start = std::chrono::steady_clock::now();
+  for (const std::string& moves : GetPositions()) {
+    search_result search = computer.Search(GameBoard::FromMoves(moves),
+                                           options_);
+    result.nodes += search.nodes;
+    result.positions++;
+  }
+  result.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+const std::vector<std::string>& SearchBench::GetPositions() {
+  // Never edit this list, or signatures stop being comparable with older
+  // runs. None of the games are over.
+  static const std::vector<std::string> kPositions = {
+      "32214243",
+      "4254413235",
+      "35131353054",
+      "01432233434",
+      "53054464323",
+      "322031465451",
+      "442541345124",
+      "300534342222",
+      "1142354454443",
+      "1321543453153",
+      "42451302463233",
+      "63533502413323",
+      "22103332542203",
+      "15453452515341",
+      "4210235054332224",
+      "206323121146414445",
+  };
+  return kPositions;
+}
+
+} // namespace connect_four
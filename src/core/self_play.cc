@@ -0,0 +1,127 @@
+#include <core/self_play.h>
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+#include <core/packed_dataset.h>
+#include <core/thread_pool.h>
+
+namespace connect_four {
+
+SelfPlay::SelfPlay(const self_play_options& options) : options_(options) {
+}
+
+self_play_stats SelfPlay::Run(const std::string& output_prefix) const {
+  auto start = std::chrono::steady_clock::now();
+  ThreadPool pool(options_.number_threads);
+
+  // Workers take games from a shared counter until none are left, each
+  // writing to its own shard
+  std::atomic<size_t> next_game(0);
+  std::vector<std::future<self_play_stats>> workers;
+  for (size_t shard = 0; shard < pool.GetNumberThreads(); shard++) {
+    std::string shard_path = GetShardPath(output_prefix, shard);
+    workers.push_back(pool.Submit([this, shard_path, &next_game]() {
+      Computer computer;
+      PackedDatasetWriter writer(shard_path);
+      self_play_stats stats;
+      std::vector<GameBoard> positions;
+
+      for (size_t game = next_game++; game < options_.number_games;
+           game = next_game++) {
+        std::mt19937 random(options_.seed + static_cast<unsigned int>(game));
+        positions.clear();
+        BoardState result = PlayGame(computer, random, positions);
+
+        // Labels use DataParser's categories
+        uint8_t label = 1;
+        if (result == BoardState::Xwins) {
+          label = 2;
+          stats.x_wins++;
+        } else if (result == BoardState::Owins) {
+          label = 0;
+          stats.o_wins++;
+        } else {
+          stats.draws++;
+        }
+
+        for (const GameBoard& position : positions) {
+          std::vector<float> features = position.GenerateVectorFeatures();
+          writer.Write(PackedDataset::Pack(features.data(), label));
+        }
+        stats.games++;
+        stats.positions += positions.size();
+      }
+
+      writer.Close();
+      return stats;
+    }));
+  }
+
+  self_play_stats totals;
+  for (std::future<self_play_stats>& worker : workers) {
+    self_play_stats stats = worker.get();
+    totals.games += stats.games;
+    totals.positions += stats.positions;
+    totals.x_wins += stats.x_wins;
+    totals.draws += stats.draws;
+    totals.o_wins += stats.o_wins;
+  }
+  totals.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return totals;
+}
+
+BoardState SelfPlay::PlayGame(Computer& computer, std::mt19937& random,
+                              std::vector<GameBoard>& positions) const {
+  GameBoard board;
+  while (board.GetGameState() == BoardState::InProgress) {
+    board.DropPiece(ChooseMove(computer, board, random));
+    positions.push_back(board);
+  }
+  return board.GetGameState();
+}
+
+size_t SelfPlay::ChooseMove(Computer& computer, const GameBoard& board,
+                            std::mt19937& random) const {
+  std::uniform_real_distribution<float> noise(-options_.root_noise,
+                                              options_.root_noise);
+  size_t best_column = 0;
+  float best_score = -std::numeric_limits<float>::infinity();
+
+  for (size_t col : board.CalculateValidColumns()) {
+    GameBoard copy = board;
+    copy.DropPiece(col);
+
+    // Scores are from the perspective of the player choosing the move
+    float score;
+    if (copy.GetGameState() == BoardState::Tie) {
+      score = 0;
+    } else if (copy.GetGameState() != BoardState::InProgress) {
+      score = computer.kWinLossValue;
+    } else if (options_.depth > 1) {
+      search_options search(options_.depth - 1,
+                            SearchAlgorithm::PrincipalVariation,
+                            options_.evaluator);
+      score = -computer.Search(copy, search).score;
+    } else {
+      score = -computer.FloatEvaluateBoard(copy, copy.GetIsXTurn(),
+                                           options_.evaluator);
+    }
+
+    score += noise(random);
+    if (score > best_score) {
+      best_score = score;
+      best_column = col;
+    }
+  }
+  return best_column;
+}
+
+std::string SelfPlay::GetShardPath(const std::string& output_prefix,
+                                   size_t shard) {
+  return output_prefix + "_" + std::to_string(shard) + ".bin";
+}
+
+} // namespace connect_four
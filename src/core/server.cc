@@ -0,0 +1,360 @@
+#include <core/server.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+#include <core/engine.h>
+
+namespace connect_four {
+
+namespace {
+
+const std::string kUnixPrefix = "unix:";
+
+} // namespace
+
+LatencyRecorder::LatencyRecorder(size_t capacity)
+    : capacity_(std::max<size_t>(capacity, 1)), number_recorded_(0) {
+  latencies_.reserve(capacity_);
+}
+
+void LatencyRecorder::Record(double milliseconds) {
+  // Once full, the oldest latency is overwritten
+  if (latencies_.size() < capacity_) {
+    latencies_.push_back(milliseconds);
+  } else {
+    latencies_[number_recorded_ % capacity_] = milliseconds;
+  }
+  number_recorded_++;
+}
+
+double LatencyRecorder::CalculatePercentile(double percentile) const {
+  if (latencies_.empty()) {
+    return 0;
+  }
+
+  // The nearest rank, counted from 1
+  size_t rank = static_cast<size_t>(
+      std::ceil(percentile / 100 * latencies_.size()));
+  rank = std::min(std::max<size_t>(rank, 1), latencies_.size());
+  std::vector<double> sorted = latencies_;
+  std::nth_element(sorted.begin(), sorted.begin() + rank - 1, sorted.end());
+  return sorted[rank - 1];
+}
+
+size_t LatencyRecorder::GetNumberRecorded() const {
+  return number_recorded_;
+}
+
+std::string server_stats::Format() const {
+  std::ostringstream line;
+  line << "stats sessions " << sessions << " queue " << queue_depth
+       << " active " << active_searches << " completed "
+       << completed_searches << " rejected " << rejected_searches
+       << " tables " << tables << " evicted " << evicted_tables << " p50 "
+       << latency_p50_ms << " p90 " << latency_p90_ms << " p99 "
+       << latency_p99_ms;
+  return line.str();
+}
+
+Server::Server(const server_options& options)
+    : options_(options), pool_(options.number_threads), queue_depth_(0),
+      active_searches_(0), completed_searches_(0), rejected_searches_(0),
+      tables_(0), evicted_tables_(0), number_searches_(0),
+      is_running_(false) {
+  for (size_t thread = 0; thread < pool_.GetNumberThreads(); thread++) {
+    workers_.emplace_back(new search_worker(options_.table_size_log2));
+    free_workers_.push_back(workers_.back().get());
+  }
+}
+
+Server::~Server() {
+  Stop();
+}
+
+void Server::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (is_running_) {
+    return;
+  }
+  listener_ = Socket::Listen(options_.address);
+  is_running_ = true;
+  accept_thread_ = std::thread(&Server::RunAccept, this);
+}
+
+void Server::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_running_) {
+      return;
+    }
+    is_running_ = false;
+  }
+  std::string address = listener_.GetAddress();
+  listener_.Shutdown();
+  accept_thread_.join();
+
+  // Closing the connections ends each session once its search replies
+  std::list<std::shared_ptr<server_session>> sessions;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessions = sessions_;
+    for (std::shared_ptr<server_session>& session : sessions) {
+      session->socket.Shutdown();
+    }
+  }
+  for (std::shared_ptr<server_session>& session : sessions) {
+    session->thread.join();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  sessions_.clear();
+  listener_ = Socket();
+  if (address.compare(0, kUnixPrefix.size(), kUnixPrefix) == 0) {
+    std::remove(address.substr(kUnixPrefix.size()).c_str());
+  }
+}
+
+server_stats Server::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  server_stats stats;
+  for (const std::shared_ptr<server_session>& session : sessions_) {
+    if (!session->is_finished) {
+      stats.sessions++;
+    }
+  }
+  stats.queue_depth = queue_depth_;
+  stats.active_searches = active_searches_;
+  stats.completed_searches = completed_searches_;
+  stats.rejected_searches = rejected_searches_;
+  stats.tables = tables_;
+  stats.evicted_tables = evicted_tables_;
+  stats.latency_p50_ms = latencies_.CalculatePercentile(50);
+  stats.latency_p90_ms = latencies_.CalculatePercentile(90);
+  stats.latency_p99_ms = latencies_.CalculatePercentile(99);
+  return stats;
+}
+
+std::string Server::GetAddress() const {
+  return listener_.GetAddress();
+}
+
+void Server::RunAccept() {
+  while (true) {
+    Socket connection = listener_.Accept();
+    if (!connection.IsOpen()) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReapSessions();
+    if (sessions_.size() >= options_.max_sessions) {
+      connection.WriteLine("busy");
+      continue;
+    }
+
+    std::shared_ptr<server_session> session(new server_session());
+    session->socket = std::move(connection);
+    session->evaluator = options_.evaluator;
+    sessions_.push_back(session);
+    session->thread = std::thread(&Server::RunSession, this, session);
+  }
+}
+
+void Server::RunSession(std::shared_ptr<server_session> session) {
+  std::string line;
+  while (session->socket.ReadLine(line)) {
+    std::istringstream words(line);
+    std::string command;
+    if (!(words >> command)) {
+      continue;
+    }
+
+    if (command == "quit") {
+      break;
+    }
+
+    if (command == "isready") {
+      session->socket.WriteLine("readyok");
+    } else if (command == "position") {
+      std::string moves;
+      words >> moves;
+      try {
+        session->board = GameBoard::FromMoves(moves);
+      } catch (const std::invalid_argument& error) {
+        session->socket.WriteLine("info string " + std::string(error.what()));
+      }
+    } else if (command == "setoption") {
+      std::string name;
+      std::string value;
+      words >> name >> value;
+      Evaluator evaluator;
+      if (name == "evaluator" && value == "network") {
+        evaluator = Evaluator::NeuralNetwork;
+      } else if (name == "evaluator" && value == "threats") {
+        evaluator = Evaluator::Threats;
+      } else {
+        session->socket.WriteLine("info string Unknown option " + name + " " +
+                                  value);
+        continue;
+      }
+
+      // Bounds from one evaluator are wrong for another
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (evaluator != session->evaluator) {
+        ReleaseTable(*session);
+      }
+      session->evaluator = evaluator;
+    } else if (command == "go") {
+      std::string arguments;
+      std::getline(words, arguments);
+      Go(*session, arguments);
+    } else if (command == "stats") {
+      session->socket.WriteLine(GetStats().Format());
+    } else {
+      session->socket.WriteLine("info string Unknown command " + command);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReleaseTable(*session);
+    session->is_finished = true;
+  }
+  // Tell the client, since the socket is only closed once the session is
+  // joined
+  session->socket.Shutdown();
+}
+
+void Server::Go(server_session& session, const std::string& arguments) {
+  auto arrival = std::chrono::steady_clock::now();
+  go_limits limits;
+  try {
+    std::istringstream words(arguments);
+    limits = Engine::ParseLimits(words);
+  } catch (const std::invalid_argument& error) {
+    session.socket.WriteLine("info string " + std::string(error.what()));
+    return;
+  }
+  if (session.board.GetGameState() != BoardState::InProgress) {
+    session.socket.WriteLine("bestmove none");
+    return;
+  }
+
+  // Each search runs on one thread of the pool, so a threads limit is
+  // ignored, and every search has a deadline so none holds a thread for
+  // long
+  size_t budget_ms = limits.move_time_ms == 0
+                         ? options_.default_move_time_ms
+                         : std::min(limits.move_time_ms,
+                                    options_.max_move_time_ms);
+  search_options options(Computer::CapDepth(session.board, limits.depth),
+                         SearchAlgorithm::Mtdf, session.evaluator);
+  options.deadline = arrival + std::chrono::milliseconds(budget_ms);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_depth_ + active_searches_ >=
+        pool_.GetNumberThreads() + options_.max_queue_depth) {
+      rejected_searches_++;
+      session.socket.WriteLine("busy");
+      return;
+    }
+    queue_depth_++;
+  }
+
+  server_session* searched_session = &session;
+  search_result result = pool_.Submit([this, searched_session, options]() {
+    return Search(*searched_session, options);
+  }).get();
+
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - arrival).count();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed_searches_++;
+    latencies_.Record(seconds * 1000);
+  }
+  session.socket.WriteLine(Engine::FormatInfo(result, seconds));
+  session.socket.WriteLine("bestmove " + std::to_string(result.column));
+}
+
+search_result Server::Search(server_session& session,
+                             search_options options) {
+  search_worker* worker;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_depth_--;
+    active_searches_++;
+    worker = free_workers_.back();
+    free_workers_.pop_back();
+
+    session.is_searching = true;
+    session.last_used = ++number_searches_;
+    if (AcquireTable(session)) {
+      options.table = session.table.get();
+    }
+  }
+
+  // The fallback table starts empty, which clearing it does cheaply
+  if (!options.table) {
+    worker->fallback_table.Clear();
+    options.table = &worker->fallback_table;
+  }
+  search_result result = worker->computer.Search(session.board, options);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  active_searches_--;
+  free_workers_.push_back(worker);
+  session.is_searching = false;
+  return result;
+}
+
+bool Server::AcquireTable(server_session& session) {
+  if (session.table) {
+    return true;
+  }
+
+  if (tables_ >= options_.max_tables) {
+    server_session* oldest = nullptr;
+    for (std::shared_ptr<server_session>& other : sessions_) {
+      if (other->table && !other->is_searching &&
+          (!oldest || other->last_used < oldest->last_used)) {
+        oldest = other.get();
+      }
+    }
+    if (!oldest) {
+      return false;
+    }
+    ReleaseTable(*oldest);
+    evicted_tables_++;
+  }
+
+  session.table.reset(new TranspositionTable(options_.table_size_log2));
+  tables_++;
+  return true;
+}
+
+void Server::ReleaseTable(server_session& session) {
+  if (session.table) {
+    session.table.reset();
+    tables_--;
+  }
+}
+
+void Server::ReapSessions() {
+  for (auto session = sessions_.begin(); session != sessions_.end();) {
+    if ((*session)->is_finished) {
+      (*session)->thread.join();
+      session = sessions_.erase(session);
+    } else {
+      session++;
+    }
+  }
+}
+
+} // namespace connect_four
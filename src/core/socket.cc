@@ -0,0 +1,236 @@
+#include <core/socket.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace connect_four {
+
+namespace {
+
+const std::string kUnixPrefix = "unix:";
+const std::string kTcpPrefix = "tcp:";
+
+// Connections waiting to be accepted before new ones are refused
+const int kBacklog = 128;
+
+// A socket address of either kind, with its length
+struct socket_address {
+  sockaddr_storage storage;
+  socklen_t length;
+  int family;
+
+  socket_address() : length(0), family(AF_UNSPEC) {
+    std::memset(&storage, 0, sizeof(storage));
+  };
+};
+
+socket_address ParseAddress(const std::string& address) {
+  socket_address parsed;
+  if (address.compare(0, kUnixPrefix.size(), kUnixPrefix) == 0) {
+    std::string path = address.substr(kUnixPrefix.size());
+    sockaddr_un* unix_address = reinterpret_cast<sockaddr_un*>(
+        &parsed.storage);
+    if (path.empty() || path.size() >= sizeof(unix_address->sun_path)) {
+      throw std::invalid_argument("Invalid address " + address);
+    }
+    unix_address->sun_family = AF_UNIX;
+    std::memcpy(unix_address->sun_path, path.c_str(), path.size() + 1);
+    parsed.length = sizeof(sockaddr_un);
+    parsed.family = AF_UNIX;
+  } else if (address.compare(0, kTcpPrefix.size(), kTcpPrefix) == 0) {
+    size_t port;
+    try {
+      port = std::stoul(address.substr(kTcpPrefix.size()));
+    } catch (const std::exception&) {
+      throw std::invalid_argument("Invalid address " + address);
+    }
+    if (port > 65535) {
+      throw std::invalid_argument("Invalid address " + address);
+    }
+    sockaddr_in* tcp_address = reinterpret_cast<sockaddr_in*>(
+        &parsed.storage);
+    tcp_address->sin_family = AF_INET;
+    tcp_address->sin_port = htons(static_cast<uint16_t>(port));
+    tcp_address->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    parsed.length = sizeof(sockaddr_in);
+    parsed.family = AF_INET;
+  } else {
+    throw std::invalid_argument("Invalid address " + address);
+  }
+  return parsed;
+}
+
+// Sends each line as soon as it is written. Otherwise the second line of a
+// reply waits for the first to be acknowledged, which adds tens of
+// milliseconds. Does nothing to Unix sockets.
+void SendImmediately(int descriptor) {
+  int is_enabled = 1;
+  setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &is_enabled,
+             sizeof(is_enabled));
+}
+
+} // namespace
+
+Socket::Socket() : descriptor_(-1) {
+}
+
+Socket::Socket(int descriptor) : descriptor_(descriptor) {
+}
+
+Socket::~Socket() {
+  Close();
+}
+
+Socket::Socket(Socket&& other)
+    : descriptor_(other.descriptor_), buffer_(std::move(other.buffer_)) {
+  other.descriptor_ = -1;
+}
+
+Socket& Socket::operator=(Socket&& other) {
+  if (this != &other) {
+    Close();
+    descriptor_ = other.descriptor_;
+    buffer_ = std::move(other.buffer_);
+    other.descriptor_ = -1;
+  }
+  return *this;
+}
+
+Socket Socket::Listen(const std::string& address) {
+  socket_address parsed = ParseAddress(address);
+  Socket listener(socket(parsed.family, SOCK_STREAM, 0));
+  if (!listener.IsOpen()) {
+    throw std::invalid_argument("Can't listen on " + address);
+  }
+
+  if (parsed.family == AF_UNIX) {
+    // A file left by a server that didn't shut down blocks the path
+    unlink(reinterpret_cast<sockaddr_un*>(&parsed.storage)->sun_path);
+  } else {
+    int is_reusable = 1;
+    setsockopt(listener.descriptor_, SOL_SOCKET, SO_REUSEADDR, &is_reusable,
+               sizeof(is_reusable));
+  }
+
+  if (bind(listener.descriptor_,
+           reinterpret_cast<sockaddr*>(&parsed.storage),
+           parsed.length) != 0 ||
+      listen(listener.descriptor_, kBacklog) != 0) {
+    throw std::invalid_argument("Can't listen on " + address);
+  }
+  return listener;
+}
+
+Socket Socket::Connect(const std::string& address) {
+  socket_address parsed = ParseAddress(address);
+  Socket connection(socket(parsed.family, SOCK_STREAM, 0));
+  if (!connection.IsOpen() ||
+      connect(connection.descriptor_,
+              reinterpret_cast<sockaddr*>(&parsed.storage),
+              parsed.length) != 0) {
+    throw std::invalid_argument("Can't connect to " + address);
+  }
+  if (parsed.family == AF_INET) {
+    SendImmediately(connection.descriptor_);
+  }
+  return connection;
+}
+
+Socket Socket::Accept() {
+  while (true) {
+    int descriptor = accept(descriptor_, nullptr, nullptr);
+    if (descriptor >= 0) {
+      SendImmediately(descriptor);
+      return Socket(descriptor);
+    }
+    // A connection given up on before it was accepted is skipped, while a
+    // shut down listener fails for good
+    if (errno != EINTR && errno != ECONNABORTED) {
+      return Socket();
+    }
+  }
+}
+
+bool Socket::ReadLine(std::string& line) {
+  while (true) {
+    size_t end = buffer_.find('\n');
+    if (end != std::string::npos) {
+      line = buffer_.substr(0, end);
+      buffer_.erase(0, end + 1);
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+      return true;
+    }
+
+    char chunk[4096];
+    ssize_t bytes_read = recv(descriptor_, chunk, sizeof(chunk), 0);
+    if (bytes_read < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes_read <= 0) {
+      return false;
+    }
+    buffer_.append(chunk, static_cast<size_t>(bytes_read));
+  }
+}
+
+bool Socket::WriteLine(const std::string& line) {
+  std::string data = line + "\n";
+  size_t written = 0;
+  while (written < data.size()) {
+    // A closed connection is reported here instead of raising SIGPIPE
+    ssize_t bytes_written = send(descriptor_, data.data() + written,
+                                 data.size() - written, MSG_NOSIGNAL);
+    if (bytes_written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes_written <= 0) {
+      return false;
+    }
+    written += static_cast<size_t>(bytes_written);
+  }
+  return true;
+}
+
+void Socket::Shutdown() {
+  if (IsOpen()) {
+    shutdown(descriptor_, SHUT_RDWR);
+  }
+}
+
+std::string Socket::GetAddress() const {
+  socket_address bound;
+  bound.length = sizeof(bound.storage);
+  if (getsockname(descriptor_, reinterpret_cast<sockaddr*>(&bound.storage),
+                  &bound.length) != 0) {
+    return "";
+  }
+  if (bound.storage.ss_family == AF_UNIX) {
+    return kUnixPrefix +
+           reinterpret_cast<sockaddr_un*>(&bound.storage)->sun_path;
+  }
+  return kTcpPrefix + std::to_string(ntohs(
+      reinterpret_cast<sockaddr_in*>(&bound.storage)->sin_port));
+}
+
+bool Socket::IsOpen() const {
+  return descriptor_ >= 0;
+}
+
+void Socket::Close() {
+  if (IsOpen()) {
+    close(descriptor_);
+    descriptor_ = -1;
+  }
+}
+
+} // namespace connect_four
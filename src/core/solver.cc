@@ -0,0 +1,313 @@
+#include <core/solver.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include <core/thread_pool.h>
+#include <core/threat_evaluator.h>
+
+namespace connect_four {
+
+constexpr int Solver::kNumberCells;
+
+Solver::Solver(SharedTranspositionTable& table) : table_(table), nodes_(0) {
+}
+
+solve_result Solver::Solve(const GameBoard& board) {
+  nodes_ = 0;
+  int number_moves = ThreatEvaluator::CountBits(board.GetOccupiedBitboard());
+  bool is_x_turn = board.GetIsXTurn();
+
+  solve_result result;
+  if (board.GetGameState() == BoardState::Tie) {
+    result.score = 0;
+  } else if (board.GetGameState() != BoardState::InProgress) {
+    // The previous player's last piece won
+    result.score = -(kNumberCells + 2 - number_moves) / 2;
+  } else if (board.CalculateWinningMoves(is_x_turn) != 0) {
+    result.score = (kNumberCells + 1 - number_moves) / 2;
+  } else {
+    // Narrow the window around the score with null-window searches, trying
+    // values nearer zero first since they're cheaper to refute
+    int min = -(kNumberCells - number_moves) / 2;
+    int max = (kNumberCells + 1 - number_moves) / 2;
+    while (min < max) {
+      int middle = min + (max - min) / 2;
+      if (middle <= 0 && min / 2 < middle) {
+        middle = min / 2;
+      } else if (middle >= 0 && max / 2 > middle) {
+        middle = max / 2;
+      }
+
+      int score = Negamax(board, middle, middle + 1);
+      if (score <= middle) {
+        max = score;
+      } else {
+        min = score;
+      }
+    }
+    result.score = min;
+  }
+
+  result.depth = CalculateDepth(result.score, number_moves);
+  result.nodes = nodes_;
+  if (result.score == 0) {
+    result.outcome = BoardState::Tie;
+  } else if ((result.score > 0) == is_x_turn) {
+    result.outcome = BoardState::Xwins;
+  } else {
+    result.outcome = BoardState::Owins;
+  }
+  return result;
+}
+
+size_t Solver::CalculateDepth(int score, int number_moves) {
+  if (score == 0) {
+    return static_cast<size_t>(kNumberCells - number_moves);
+  }
+
+  // The winner's last piece is played after one of two numbers of moves,
+  // and only one of them is on the winner's turn
+  int magnitude = score > 0 ? score : -score;
+  int winner_parity = score > 0 ? number_moves % 2 : (number_moves + 1) % 2;
+  int moves_before_win = kNumberCells + 1 - 2 * magnitude;
+  if (moves_before_win % 2 != winner_parity) {
+    moves_before_win--;
+  }
+  return static_cast<size_t>(moves_before_win + 1 - number_moves);
+}
+
+int Solver::Negamax(const GameBoard& board, int alpha, int beta) {
+  nodes_++;
+  int number_moves = ThreatEvaluator::CountBits(board.GetOccupiedBitboard());
+
+  // If every move lets the opponent win, they win with their next piece
+  uint64_t moves = board.CalculateNonLosingMoves();
+  if (moves == 0) {
+    return -(kNumberCells - number_moves) / 2;
+  }
+  // Neither player can win with the last two pieces
+  if (number_moves >= kNumberCells - 2) {
+    return 0;
+  }
+
+  // The opponent can't win right away, and the player to move can't win
+  // before their next piece
+  int lower_bound = -(kNumberCells - 2 - number_moves) / 2;
+  int upper_bound = (kNumberCells - 1 - number_moves) / 2;
+
+  uint64_t key = board.GetCanonicalKey();
+  solved_bounds stored;
+  if (table_.Probe(key, stored)) {
+    lower_bound = std::max(lower_bound, stored.lower_bound);
+    upper_bound = std::min(upper_bound, stored.upper_bound);
+  }
+  if (alpha < lower_bound) {
+    alpha = lower_bound;
+    if (alpha >= beta) {
+      return alpha;
+    }
+  }
+  if (beta > upper_bound) {
+    beta = upper_bound;
+    if (alpha >= beta) {
+      return beta;
+    }
+  }
+
+  // Try the moves that create the most threats first, keeping the center
+  // to edge order among equals
+  bool is_x_turn = board.GetIsXTurn();
+  GameBoard children[GameBoard::kWidth];
+  int threats[GameBoard::kWidth];
+  size_t number_children = 0;
+  for (size_t col : board.ConvertToColumns(moves)) {
+    GameBoard child = board;
+    child.DropPiece(col);
+    int child_threats = ThreatEvaluator::CountBits(
+        child.CalculateThreats(is_x_turn));
+
+    size_t position = number_children++;
+    while (position > 0 && threats[position - 1] < child_threats) {
+      children[position] = children[position - 1];
+      threats[position] = threats[position - 1];
+      position--;
+    }
+    children[position] = child;
+    threats[position] = child_threats;
+  }
+
+  for (size_t index = 0; index < number_children; index++) {
+    int score = -Negamax(children[index], -beta, -alpha);
+    if (score >= beta) {
+      table_.Store(key, solved_bounds(score, upper_bound));
+      return score;
+    }
+    if (score > alpha) {
+      alpha = score;
+    }
+  }
+
+  table_.Store(key, solved_bounds(lower_bound, alpha));
+  return alpha;
+}
+
+DatasetSolver::DatasetSolver(const dataset_solver_options& options)
+    : options_(options), table_(options.table_size_log2) {
+  if (options_.batch_size == 0) {
+    options_.batch_size = 1;
+  }
+}
+
+dataset_solver_stats DatasetSolver::Run(DataStream& stream,
+                                        const std::string& output_path) {
+  auto start = std::chrono::steady_clock::now();
+  std::string checkpoint_path = GetCheckpointPath(output_path);
+  dataset_solver_stats stats;
+
+  size_t next_example;
+  size_t output_size;
+  std::fstream output;
+  if (ReadCheckpoint(checkpoint_path, next_example, output_size)) {
+    stream.SeekToExample(next_example);
+    stats.first_example = next_example;
+
+    // Anything past the checkpoint is from a batch that didn't finish.
+    // Solving is deterministic, so that batch is written again over the
+    // same bytes and the file never has to be truncated.
+    output.open(output_path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!output.is_open()) {
+      throw std::invalid_argument("File stream is not good");
+    }
+    output.seekp(static_cast<std::streamoff>(output_size));
+  } else {
+    output.open(output_path, std::ios::out | std::ios::trunc |
+                             std::ios::binary);
+    if (!output.is_open()) {
+      throw std::invalid_argument("File stream is not good");
+    }
+    for (size_t index = 1; index <= GameBoard::kWidth * GameBoard::kHeight;
+         index++) {
+      output << "pos_" << index << ",";
+    }
+    output << "winner,depth\n";
+  }
+
+  ThreadPool pool(options_.number_threads);
+  DataParser parser;
+  std::vector<GameBoard> boards;
+  std::vector<solve_result> results;
+
+  while (true) {
+    parser.Clear();
+    size_t batch_start = stream.GetNextExample();
+    parser.YieldTrainingData(stream, options_.batch_size);
+    if (stream.GetNextExample() == batch_start) {
+      break;
+    }
+
+    boards.clear();
+    for (const tiny_dnn::vec_t& features : parser.GetTrainFeatures()) {
+      try {
+        boards.push_back(CreateBoard(features.data()));
+      } catch (const std::invalid_argument&) {
+        stats.examples_skipped++;
+      }
+    }
+
+    // Solvers take the next unsolved board until the batch is done, so
+    // slow positions don't hold up a whole thread's share
+    results.assign(boards.size(), solve_result());
+    std::atomic<size_t> next_board(0);
+    std::vector<std::future<void>> workers;
+    for (size_t worker = 0; worker < pool.GetNumberThreads(); worker++) {
+      workers.push_back(pool.Submit([this, &boards, &results, &next_board]() {
+        Solver solver(table_);
+        for (size_t index = next_board++; index < boards.size();
+             index = next_board++) {
+          results[index] = solver.Solve(boards[index]);
+        }
+      }));
+    }
+    for (std::future<void>& worker : workers) {
+      worker.get();
+    }
+
+    for (size_t index = 0; index < boards.size(); index++) {
+      for (float feature : boards[index].GenerateVectorFeatures()) {
+        output << static_cast<int>(feature) << ",";
+      }
+      int winner = 0;
+      if (results[index].outcome == BoardState::Xwins) {
+        winner = 1;
+      } else if (results[index].outcome == BoardState::Owins) {
+        winner = -1;
+      }
+      output << winner << "," << results[index].depth << "\n";
+      stats.nodes += results[index].nodes;
+    }
+    stats.examples_solved += boards.size();
+
+    // Only checkpoint once the batch is safely on disk
+    output.flush();
+    if (!output.good()) {
+      throw std::invalid_argument("File stream is not good");
+    }
+    WriteCheckpoint(checkpoint_path, stream.GetNextExample(),
+                    static_cast<size_t>(output.tellp()));
+  }
+
+  stats.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return stats;
+}
+
+GameBoard DatasetSolver::CreateBoard(const float* features) {
+  std::vector<std::vector<int>> pieces(GameBoard::kHeight,
+                                       std::vector<int>(GameBoard::kWidth));
+  int balance = 0;
+  for (size_t row = 0; row < GameBoard::kHeight; row++) {
+    for (size_t col = 0; col < GameBoard::kWidth; col++) {
+      int piece = static_cast<int>(features[row * GameBoard::kWidth + col]);
+      pieces[row][col] = piece;
+      balance += piece;
+    }
+  }
+  return GameBoard(pieces, balance == 0);
+}
+
+std::string DatasetSolver::GetCheckpointPath(const std::string& output_path) {
+  return output_path + ".checkpoint";
+}
+
+bool DatasetSolver::ReadCheckpoint(const std::string& checkpoint_path,
+                                   size_t& next_example,
+                                   size_t& output_size) {
+  std::ifstream checkpoint(checkpoint_path);
+  return static_cast<bool>(checkpoint >> next_example >> output_size);
+}
+
+void DatasetSolver::WriteCheckpoint(const std::string& checkpoint_path,
+                                    size_t next_example, size_t output_size) {
+  std::string temporary_path = checkpoint_path + ".tmp";
+  {
+    std::ofstream checkpoint(temporary_path);
+    checkpoint << next_example << " " << output_size << std::endl;
+    if (!checkpoint.good()) {
+      throw std::invalid_argument("File stream is not good");
+    }
+  }
+#ifdef _WIN32
+  // Windows won't rename over an existing file
+  std::remove(checkpoint_path.c_str());
+#endif
+  if (std::rename(temporary_path.c_str(), checkpoint_path.c_str()) != 0) {
+    throw std::invalid_argument("File stream is not good");
+  }
+}
+
+} // namespace connect_four
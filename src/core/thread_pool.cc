@@ -0,0 +1,52 @@
+#include <core/thread_pool.h>
+
+namespace connect_four {
+
+ThreadPool::ThreadPool(size_t number_threads) : is_stopping_(false) {
+  if (number_threads == 0) {
+    number_threads = std::thread::hardware_concurrency();
+  }
+  // hardware_concurrency may not know
+  if (number_threads == 0) {
+    number_threads = 1;
+  }
+
+  for (size_t i = 0; i < number_threads; i++) {
+    workers_.emplace_back(&ThreadPool::RunWorker, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  task_available_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::GetNumberThreads() const {
+  return workers_.size();
+}
+
+void ThreadPool::RunWorker() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_available_.wait(lock, [this]() {
+        return is_stopping_ || !tasks_.empty();
+      });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+} // namespace connect_four
@@ -0,0 +1,52 @@
+#include <core/threat_evaluator.h>
+
+#include <cmath>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace connect_four {
+
+float ThreatEvaluator::EvaluateBoard(const GameBoard& board,
+                                     bool is_x_perspective) const {
+  uint64_t x_pieces = board.GetXBitboard();
+  uint64_t o_pieces = board.GetOBitboard();
+
+  // Empty cells that complete a line of four, found for all 69 lines at
+  // once with shifts rather than by walking a table of lines
+  uint64_t x_threats = board.CalculateThreats(true);
+  uint64_t o_threats = board.CalculateThreats(false);
+
+  // Threats that can be played right now are left to the search, only
+  // threats higher up in a column count towards parity
+  uint64_t playable = board.CalculatePlayableCells();
+  uint64_t x_later = x_threats & ~playable;
+  uint64_t o_later = o_threats & ~playable;
+
+  float score = kOpenThreeWeight * (CountBits(x_threats) -
+                                    CountBits(o_threats));
+  score += kGoodThreatWeight * CountBits(x_later & kOddRowsMask);
+  score += kBadThreatWeight * CountBits(x_later & ~kOddRowsMask);
+  score -= kGoodThreatWeight * CountBits(o_later & ~kOddRowsMask);
+  score -= kBadThreatWeight * CountBits(o_later & kOddRowsMask);
+  score += kCenterWeight * (CountBits(x_pieces & kCenterMask) -
+                            CountBits(o_pieces & kCenterMask));
+
+  // Squash into (-1, 1)
+  float x_score = score / (1 + std::fabs(score));
+  if (!is_x_perspective) {
+    return -x_score;
+  }
+  return x_score;
+}
+
+int ThreatEvaluator::CountBits(uint64_t bits) {
+#ifdef _MSC_VER
+  return static_cast<int>(__popcnt64(bits));
+#else
+  return __builtin_popcountll(bits);
+#endif
+}
+
+} // namespace connect_four
@@ -0,0 +1,124 @@
+#include <core/training_checkpoint.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace connect_four {
+
+constexpr uint32_t TrainingCheckpoint::kMagic;
+constexpr uint32_t TrainingCheckpoint::kVersion;
+
+TrainingCheckpoint::TrainingCheckpoint(const std::string& checkpoint_path)
+    : checkpoint_path_(checkpoint_path), generation_(0) {
+  // Continue from the generation of a checkpoint already at the path, so
+  // the first save doesn't overwrite the model file it names
+  std::ifstream input(checkpoint_path_, std::ios::binary);
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t generation = 0;
+  input.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  input.read(reinterpret_cast<char*>(&version), sizeof(version));
+  input.read(reinterpret_cast<char*>(&generation), sizeof(generation));
+  if (input.good() && magic == kMagic && version == kVersion) {
+    generation_ = generation;
+  }
+}
+
+void TrainingCheckpoint::Save(tiny_dnn::network<tiny_dnn::sequential>& network,
+                              PersistentAdam& optimizer,
+                              const training_state& state) {
+  // The model file of the current checkpoint is left alone
+  uint64_t generation = generation_ + 1;
+  network.save(GetModelPath(generation));
+
+  std::string temporary_path = checkpoint_path_ + ".tmp";
+  {
+    std::ofstream output(temporary_path, std::ios::binary);
+    if (!output.is_open()) {
+      throw std::invalid_argument("File stream is not good");
+    }
+
+    uint64_t epoch = state.epoch;
+    uint64_t position = state.position;
+    uint64_t batch_size = state.batch_size;
+    uint32_t seed = state.seed;
+    uint8_t is_mirrored = state.is_mirrored ? 1 : 0;
+    output.write(reinterpret_cast<const char*>(&kMagic), sizeof(kMagic));
+    output.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+    output.write(reinterpret_cast<const char*>(&generation),
+                 sizeof(generation));
+    output.write(reinterpret_cast<const char*>(&epoch), sizeof(epoch));
+    output.write(reinterpret_cast<const char*>(&position), sizeof(position));
+    output.write(reinterpret_cast<const char*>(&batch_size),
+                 sizeof(batch_size));
+    output.write(reinterpret_cast<const char*>(&seed), sizeof(seed));
+    output.write(reinterpret_cast<const char*>(&is_mirrored),
+                 sizeof(is_mirrored));
+    output.write(reinterpret_cast<const char*>(&state.best_accuracy),
+                 sizeof(state.best_accuracy));
+    optimizer.SaveState(output, network);
+    if (!output.good()) {
+      throw std::invalid_argument("File stream is not good");
+    }
+  }
+
+#ifdef _WIN32
+  // Windows won't rename over an existing file
+  std::remove(checkpoint_path_.c_str());
+#endif
+  if (std::rename(temporary_path.c_str(), checkpoint_path_.c_str()) != 0) {
+    throw std::invalid_argument("File stream is not good");
+  }
+  generation_ = generation;
+}
+
+bool TrainingCheckpoint::Load(tiny_dnn::network<tiny_dnn::sequential>& network,
+                              PersistentAdam& optimizer,
+                              training_state& state) {
+  std::ifstream input(checkpoint_path_, std::ios::binary);
+  if (!input.is_open()) {
+    return false;
+  }
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t generation = 0;
+  uint64_t epoch = 0;
+  uint64_t position = 0;
+  uint64_t batch_size = 0;
+  uint32_t seed = 0;
+  uint8_t is_mirrored = 0;
+  float best_accuracy = 0;
+  input.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  input.read(reinterpret_cast<char*>(&version), sizeof(version));
+  input.read(reinterpret_cast<char*>(&generation), sizeof(generation));
+  input.read(reinterpret_cast<char*>(&epoch), sizeof(epoch));
+  input.read(reinterpret_cast<char*>(&position), sizeof(position));
+  input.read(reinterpret_cast<char*>(&batch_size), sizeof(batch_size));
+  input.read(reinterpret_cast<char*>(&seed), sizeof(seed));
+  input.read(reinterpret_cast<char*>(&is_mirrored), sizeof(is_mirrored));
+  input.read(reinterpret_cast<char*>(&best_accuracy), sizeof(best_accuracy));
+  if (!input.good() || magic != kMagic || version != kVersion) {
+    throw std::invalid_argument("File is not a training checkpoint");
+  }
+
+  // The optimizer's estimates belong to the loaded network's weights
+  network.load(GetModelPath(generation));
+  optimizer.LoadState(input, network);
+
+  state.epoch = epoch;
+  state.position = position;
+  state.batch_size = batch_size;
+  state.seed = seed;
+  state.is_mirrored = is_mirrored != 0;
+  state.best_accuracy = best_accuracy;
+  generation_ = generation;
+  return true;
+}
+
+std::string TrainingCheckpoint::GetModelPath(uint64_t generation) const {
+  return checkpoint_path_ + ".model" + std::to_string(generation % 2);
+}
+
+} // namespace connect_four
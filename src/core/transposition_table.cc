@@ -0,0 +1,96 @@
+#include <core/transposition_table.h>
+
+#include <algorithm>
+
+namespace connect_four {
+
+TranspositionTable::TranspositionTable(size_t size_log2)
+    : entries_(size_t(1) << size_log2), generation_(0),
+      size_log2_(size_log2) {
+}
+
+bool TranspositionTable::Probe(uint64_t key, table_entry& entry) const {
+  const table_entry& stored = entries_[CalculateIndex(key)];
+
+  // Keys are never zero, so empty slots never match
+  if (stored.key != key || stored.generation != generation_) {
+    return false;
+  }
+  entry = stored;
+  return true;
+}
+
+void TranspositionTable::Store(const table_entry& entry) {
+  table_entry& slot = entries_[CalculateIndex(entry.key)];
+  slot = entry;
+  slot.generation = generation_;
+}
+
+void TranspositionTable::Clear() {
+  generation_++;
+  // Entries left from the last time this generation was used would be found
+  // again, so the whole table is emptied once per wraparound
+  if (generation_ == 0) {
+    std::fill(entries_.begin(), entries_.end(), table_entry());
+  }
+}
+
+size_t TranspositionTable::GetCapacity() const {
+  return entries_.size();
+}
+
+size_t TranspositionTable::CalculateIndex(uint64_t key) const {
+  // Fibonacci hashing: keep the top bits of the key times 2^64 / phi
+  return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >>
+                             (64 - size_log2_));
+}
+
+constexpr int SharedTranspositionTable::kBoundOffset;
+constexpr uint64_t SharedTranspositionTable::kKeyMask;
+
+SharedTranspositionTable::SharedTranspositionTable(size_t size_log2)
+    : entries_(new std::atomic<uint64_t>[size_t(1) << size_log2]),
+      size_log2_(size_log2) {
+  Clear();
+}
+
+bool SharedTranspositionTable::Probe(uint64_t key,
+                                     solved_bounds& bounds) const {
+  // Relaxed loads are enough since an entry is checked against its own key
+  uint64_t stored = entries_[CalculateIndex(key)].load(
+      std::memory_order_relaxed);
+
+  // Keys are never zero, so empty slots never match
+  if ((stored & kKeyMask) != key) {
+    return false;
+  }
+  bounds.lower_bound = static_cast<int>((stored >> 49) & 0x7F) - kBoundOffset;
+  bounds.upper_bound = static_cast<int>((stored >> 56) & 0x7F) - kBoundOffset;
+  return true;
+}
+
+void SharedTranspositionTable::Store(uint64_t key,
+                                     const solved_bounds& bounds) {
+  uint64_t lower = static_cast<uint64_t>(bounds.lower_bound + kBoundOffset);
+  uint64_t upper = static_cast<uint64_t>(bounds.upper_bound + kBoundOffset);
+  uint64_t entry = (key & kKeyMask) | (lower & 0x7F) << 49 |
+                   (upper & 0x7F) << 56;
+  entries_[CalculateIndex(key)].store(entry, std::memory_order_relaxed);
+}
+
+void SharedTranspositionTable::Clear() {
+  for (size_t index = 0; index < GetCapacity(); index++) {
+    entries_[index].store(0, std::memory_order_relaxed);
+  }
+}
+
+size_t SharedTranspositionTable::GetCapacity() const {
+  return size_t(1) << size_log2_;
+}
+
+size_t SharedTranspositionTable::CalculateIndex(uint64_t key) const {
+  return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >>
+                             (64 - size_log2_));
+}
+
+} // namespace connect_four
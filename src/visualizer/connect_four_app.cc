@@ -51,11 +51,7 @@ void ConnectFourApp::mouseDown(ci::app::MouseEvent event) {
     board_.DropPiece(column);
 
     // Now the computer makes a move
-    move_evaluation_pair best = model_.MiniMaxSearch(board_, depth_,
-                                                     -model_.kAlphaBeta,
-                                                     model_.kAlphaBeta,
-                                                     !is_player_x_,
-                                                     true);
+    search_result best = model_.Search(board_, depth_);
     board_.DropPiece(best.column);
 
     // Update the evaluation
@@ -122,11 +118,7 @@ void ConnectFourApp::keyDown(ci::app::KeyEvent event) {
       board_.Reset();
       is_player_x_ = false;
       // Computer should make a first move
-      move_evaluation_pair best = model_.MiniMaxSearch(board_, 1,
-                                                       -model_.kAlphaBeta,
-                                                       model_.kAlphaBeta,
-                                                       !is_player_x_,
-                                                       true);
+      search_result best = model_.Search(board_, 1);
       board_.DropPiece(best.column);
 
       // Update the evaluation
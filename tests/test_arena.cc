@@ -0,0 +1,178 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <core/arena.h>
+
+using connect_four::Arena;
+using connect_four::BoardState;
+using connect_four::Computer;
+using connect_four::GameBoard;
+using connect_four::GameRecordReader;
+using connect_four::GameReplay;
+using connect_four::SprtResult;
+using connect_four::arena_options;
+using connect_four::arena_stats;
+using connect_four::game_record;
+using connect_four::player_config;
+using connect_four::sprt_options;
+
+namespace {
+
+arena_stats CreateStats(size_t wins, size_t draws, size_t losses) {
+  arena_stats stats;
+  stats.wins = wins;
+  stats.draws = draws;
+  stats.losses = losses;
+  return stats;
+}
+
+player_config CreatePlayer(size_t depth) {
+  player_config config;
+  config.depth = depth;
+  return config;
+}
+
+} // namespace
+
+TEST_CASE("Match statistics") {
+  SECTION("No games is an even match") {
+    arena_stats stats;
+    REQUIRE(stats.CalculateScore() == Approx(0.5));
+    REQUIRE(stats.CalculateEloDifference() == Approx(0).margin(1e-9));
+    REQUIRE(stats.CalculateEloError() == 0);
+    REQUIRE(stats.CalculateLogLikelihoodRatio(sprt_options()) == 0);
+  }
+
+  SECTION("The Elo difference follows the score") {
+    arena_stats stats = CreateStats(60, 20, 20);
+    REQUIRE(stats.GetNumberGames() == 100);
+    REQUIRE(stats.CalculateScore() == Approx(0.7));
+    REQUIRE(stats.CalculateEloDifference() ==
+            Approx(-400 * std::log10(1 / 0.7 - 1)));
+    REQUIRE(CreateStats(20, 20, 60).CalculateEloDifference() ==
+            Approx(-stats.CalculateEloDifference()));
+  }
+
+  SECTION("More games narrow the error bars") {
+    double error = CreateStats(30, 40, 30).CalculateEloError();
+    REQUIRE(error > 0);
+    REQUIRE(CreateStats(300, 400, 300).CalculateEloError() < error);
+  }
+
+  SECTION("Winning every game") {
+    arena_stats stats = CreateStats(10, 0, 0);
+    REQUIRE(std::isinf(stats.CalculateEloDifference()));
+    REQUIRE(stats.CalculateEloError() == 0);
+    REQUIRE(stats.CalculateSprtResult(sprt_options()) ==
+            SprtResult::AcceptH1);
+  }
+
+  SECTION("The test decides once the evidence is strong enough") {
+    sprt_options sprt;
+    REQUIRE(CreateStats(300, 100, 100).CalculateSprtResult(sprt) ==
+            SprtResult::AcceptH1);
+    REQUIRE(CreateStats(100, 100, 300).CalculateSprtResult(sprt) ==
+            SprtResult::AcceptH0);
+    REQUIRE(CreateStats(5, 2, 4).CalculateSprtResult(sprt) ==
+            SprtResult::Continue);
+  }
+}
+
+TEST_CASE("Generate openings") {
+  SECTION("Every distinct position up to mirroring") {
+    // 49 move pairs, of which only 33 is its own mirror image
+    std::vector<std::string> openings = Arena::GenerateOpenings(2, 1);
+    REQUIRE(openings.size() == 25);
+
+    std::set<uint64_t> keys;
+    for (const std::string& moves : openings) {
+      REQUIRE(moves.size() == 2);
+      keys.insert(GameBoard::FromMoves(moves).GetCanonicalKey());
+    }
+    REQUIRE(keys.size() == openings.size());
+  }
+
+  SECTION("Unbalanced openings are left out") {
+    std::vector<std::string> balanced = Arena::GenerateOpenings(2, 0.05f);
+    REQUIRE_FALSE(balanced.empty());
+    REQUIRE(balanced.size() < 25);
+  }
+}
+
+TEST_CASE("Play a match") {
+  arena_options options;
+  options.number_game_pairs = 4;
+  options.number_threads = 2;
+  options.openings = {"33", "32"};
+
+  SECTION("Each opening is played with both colors") {
+    Arena arena(CreatePlayer(2), CreatePlayer(2));
+    size_t pairs = 0;
+    arena_stats stats = arena.Run(options, [&pairs](const arena_stats&) {
+      pairs++;
+    });
+    REQUIRE(pairs == 4);
+    REQUIRE(stats.GetNumberGames() == 8);
+    // Identical players repeat each game with the colors swapped
+    REQUIRE(stats.wins == stats.losses);
+  }
+
+  SECTION("A deeper search is stronger") {
+    options.number_game_pairs = 6;
+    options.openings = Arena::GenerateOpenings(2, 0.2f);
+    arena_stats stats = Arena(CreatePlayer(6), CreatePlayer(1)).Run(options);
+    REQUIRE(stats.wins > stats.losses);
+  }
+
+  SECTION("The test stops a decided match early") {
+    options.number_game_pairs = 1000;
+    options.sprt.is_enabled = true;
+    options.openings = Arena::GenerateOpenings(2, 0.2f);
+    arena_stats stats = Arena(CreatePlayer(6), CreatePlayer(1)).Run(options);
+    REQUIRE(stats.GetNumberGames() < 2000);
+    REQUIRE(stats.CalculateSprtResult(options.sprt) != SprtResult::Continue);
+  }
+
+  SECTION("Games are recorded in pairs") {
+    std::string path = "data/test_arena_games.bin";
+    options.record_path = path;
+    Arena(CreatePlayer(3), CreatePlayer(2)).Run(options);
+
+    GameRecordReader reader(path);
+    REQUIRE(reader.GetNumberGames() == 8);
+    game_record record;
+    for (size_t game = 0; game < 8; game++) {
+      REQUIRE(reader.Next(record));
+      std::string moves = record.GetMoveString();
+      REQUIRE((moves.compare(0, 2, "33") == 0 ||
+               moves.compare(0, 2, "32") == 0));
+      GameReplay replay(record);
+      while (replay.Next()) {
+      }
+      REQUIRE(record.result != BoardState::InProgress);
+    }
+    REQUIRE_FALSE(reader.Next(record));
+    std::remove(path.c_str());
+  }
+
+  SECTION("A game is played to its end") {
+    Arena arena(CreatePlayer(2), CreatePlayer(2));
+    Computer first;
+    Computer second;
+    BoardState result = arena.PlayGame(first, second,
+                                       GameBoard::FromMoves("33"), true);
+    REQUIRE(result != BoardState::InProgress);
+  }
+
+  SECTION("A match needs openings") {
+    options.openings.clear();
+    REQUIRE_THROWS_AS(Arena(CreatePlayer(2), CreatePlayer(2)).Run(options),
+                      std::invalid_argument);
+  }
+}
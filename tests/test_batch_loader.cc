@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <core/batch_loader.h>
+
+using connect_four::BatchLoader;
+using connect_four::training_batch;
+
+// A source of a number of batches, each holding its index as a label
+BatchLoader::BatchSource CountingSource(size_t number_batches,
+                                        size_t& batches_made) {
+  batches_made = 0;
+  return [number_batches, &batches_made](training_batch& batch) {
+    if (batches_made == number_batches) {
+      return false;
+    }
+    batch.features.push_back(tiny_dnn::vec_t(42, 0));
+    batch.labels.push_back(batches_made);
+    batches_made++;
+    return true;
+  };
+}
+
+TEST_CASE("Prefetch batches in the background") {
+  size_t batches_made = 0;
+  training_batch batch;
+
+  SECTION("Hands over every batch in order, then stops") {
+    BatchLoader loader(CountingSource(5, batches_made));
+    for (size_t index = 0; index < 5; index++) {
+      REQUIRE(loader.Next(batch));
+      REQUIRE(batch.labels.size() == 1);
+      REQUIRE(batch.labels[0] == index);
+    }
+    REQUIRE_FALSE(loader.Next(batch));
+    REQUIRE_FALSE(loader.Next(batch));
+  }
+
+  SECTION("Stops early without taking every batch") {
+    {
+      BatchLoader loader(CountingSource(100, batches_made));
+      REQUIRE(loader.Next(batch));
+    }
+    // One batch taken, one waiting and at most one being prepared
+    REQUIRE(batches_made <= 3);
+  }
+
+  SECTION("Passes errors from the source to the trainer") {
+    BatchLoader loader([](training_batch& batch) -> bool {
+      throw std::invalid_argument("File stream is not good");
+    });
+    REQUIRE_THROWS_AS(loader.Next(batch), std::invalid_argument);
+  }
+
+  SECTION("Stall time starts at zero") {
+    BatchLoader loader(CountingSource(1, batches_made));
+    loader.Next(batch);
+    REQUIRE(loader.GetStallSeconds() >= 0);
+    loader.ResetStallTime();
+    REQUIRE(loader.GetStallSeconds() == 0);
+  }
+
+  SECTION("Reports how long each batch took to prepare") {
+    BatchLoader loader([](training_batch& batch) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      batch.labels.push_back(0);
+      return true;
+    });
+    REQUIRE(loader.GetLoadSeconds() == 0);
+    REQUIRE(loader.Next(batch));
+    REQUIRE(loader.GetLoadSeconds() >= 0.015);
+  }
+}
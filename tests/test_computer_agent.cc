@@ -0,0 +1,156 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+#include <core/computer_agent.h>
+#include <core/gameboard.h>
+#include <core/transposition_table.h>
+
+using connect_four::Computer;
+using connect_four::Evaluator;
+using connect_four::GameBoard;
+using connect_four::SearchAlgorithm;
+using connect_four::TranspositionTable;
+using connect_four::search_options;
+using connect_four::search_result;
+using connect_four::table_entry;
+
+namespace {
+
+const size_t kMaxDepth = 6;
+
+// Opening positions, followed by positions the player to move wins by force
+// ("3344"), loses by force within four plies ("2512121"), and loses to
+// either of two threats whatever they play ("33442")
+const std::vector<std::string> kPositions = {
+    "", "33", "2334", "65432", "3344", "2512121", "33442"};
+
+search_result SearchWith(Computer& computer, const std::string& moves,
+                         size_t depth, SearchAlgorithm algorithm) {
+  return computer.Search(GameBoard::FromMoves(moves),
+                         search_options(depth, algorithm,
+                                        Evaluator::Threats));
+}
+
+// Checks that a search's move leads to the score the baseline gives, by
+// searching the position after it one ply less deep
+void RequireMoveReachesScore(Computer& computer, const std::string& moves,
+                             size_t depth, const search_result& result,
+                             float score) {
+  GameBoard child = GameBoard::FromMoves(moves);
+  REQUIRE(child.DropPiece(result.column));
+  search_result reply = computer.Search(
+      child, search_options(depth - 1, SearchAlgorithm::AlphaBeta,
+                            Evaluator::Threats));
+  REQUIRE(-reply.score == Approx(score).margin(0.0001));
+}
+
+} // namespace
+
+TEST_CASE("Principal variation search matches minimax") {
+  Computer computer;
+
+  for (const std::string& moves : kPositions) {
+    for (size_t depth = 1; depth <= kMaxDepth; depth++) {
+      search_result baseline = SearchWith(computer, moves, depth,
+                                          SearchAlgorithm::AlphaBeta);
+      search_result result = SearchWith(computer, moves, depth,
+                                        SearchAlgorithm::PrincipalVariation);
+      REQUIRE(result.score == Approx(baseline.score).margin(0.0001));
+      REQUIRE(result.depth == depth);
+      REQUIRE_FALSE(result.principal_variation.empty());
+      REQUIRE(result.principal_variation[0] == result.column);
+      RequireMoveReachesScore(computer, moves, depth, result, result.score);
+    }
+  }
+}
+
+TEST_CASE("Principal variation search finds forced results") {
+  Computer computer;
+
+  SECTION("A forced win") {
+    search_result result = SearchWith(computer, "3344", 3,
+                                      SearchAlgorithm::PrincipalVariation);
+    REQUIRE(result.score == computer.kWinLossValue);
+    REQUIRE((result.column == 2 || result.column == 5));
+  }
+
+  SECTION("A forced loss beyond the next move") {
+    REQUIRE(SearchWith(computer, "2512121", 2,
+                       SearchAlgorithm::PrincipalVariation).score >
+            -computer.kWinLossValue);
+    REQUIRE(SearchWith(computer, "2512121", 4,
+                       SearchAlgorithm::PrincipalVariation).score ==
+            -computer.kWinLossValue);
+  }
+
+  SECTION("Every move loses") {
+    search_result result = SearchWith(computer, "33442", 2,
+                                      SearchAlgorithm::PrincipalVariation);
+    REQUIRE(result.score == -computer.kWinLossValue);
+    // There is still a move to play
+    REQUIRE(result.principal_variation.size() >= 1);
+    REQUIRE(GameBoard::FromMoves("33442").DropPiece(result.column));
+  }
+}
+
+TEST_CASE("MTD(f) matches minimax") {
+  Computer computer;
+
+  SECTION("With the computer's own table") {
+    for (const std::string& moves : kPositions) {
+      for (size_t depth = 1; depth <= kMaxDepth; depth++) {
+        search_result baseline = SearchWith(computer, moves, depth,
+                                            SearchAlgorithm::AlphaBeta);
+        search_result result = SearchWith(computer, moves, depth,
+                                          SearchAlgorithm::Mtdf);
+        REQUIRE(result.score == Approx(baseline.score).margin(0.0001));
+        REQUIRE(result.depth == depth);
+        RequireMoveReachesScore(computer, moves, depth, result,
+                                result.score);
+      }
+    }
+  }
+
+  SECTION("With a table kept across searches") {
+    TranspositionTable table(16);
+    // A later move of the same game, then a position searched before
+    std::vector<std::string> games = {"33", "334", "33", "3344"};
+    for (const std::string& moves : games) {
+      search_options options(kMaxDepth, SearchAlgorithm::Mtdf,
+                             Evaluator::Threats);
+      options.table = &table;
+      search_result result = computer.Search(GameBoard::FromMoves(moves),
+                                             options);
+      search_result baseline = SearchWith(computer, moves, kMaxDepth,
+                                          SearchAlgorithm::AlphaBeta);
+      REQUIRE(result.score == Approx(baseline.score).margin(0.0001));
+      RequireMoveReachesScore(computer, moves, kMaxDepth, result,
+                              result.score);
+    }
+  }
+
+  SECTION("Mirror images share entries") {
+    TranspositionTable table(16);
+    search_options options(kMaxDepth, SearchAlgorithm::Mtdf,
+                           Evaluator::Threats);
+    options.table = &table;
+    GameBoard board = GameBoard::FromMoves("2334");
+    search_result original = computer.Search(board, options);
+
+    GameBoard mirror = board.Mirror();
+    table_entry entry;
+    REQUIRE(table.Probe(mirror.GetCanonicalKey(), entry));
+
+    search_result fresh = SearchWith(computer, "4332", kMaxDepth,
+                                     SearchAlgorithm::Mtdf);
+    search_result shared = computer.Search(mirror, options);
+    REQUIRE(shared.score == Approx(original.score).margin(0.0001));
+    REQUIRE(shared.score == Approx(fresh.score).margin(0.0001));
+    RequireMoveReachesScore(computer, "4332", kMaxDepth, shared,
+                            shared.score);
+    // Entries from the original search answer the mirror's probes
+    REQUIRE(shared.nodes < fresh.nodes);
+  }
+}
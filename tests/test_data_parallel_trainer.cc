@@ -0,0 +1,123 @@
+#include <catch2/catch.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include <core/data_parallel_trainer.h>
+#include <core/persistent_adam.h>
+
+using connect_four::DataParallelTrainer;
+using connect_four::PersistentAdam;
+
+namespace {
+
+tiny_dnn::network<tiny_dnn::sequential> CreateNetwork() {
+  tiny_dnn::network<tiny_dnn::sequential> net;
+  net << tiny_dnn::fully_connected_layer(42, 8) << tiny_dnn::relu()
+      << tiny_dnn::fully_connected_layer(8, 3) << tiny_dnn::softmax();
+  return net;
+}
+
+std::vector<tiny_dnn::vec_t> CopyWeights(
+    tiny_dnn::network<tiny_dnn::sequential>& net) {
+  std::vector<tiny_dnn::vec_t> weights;
+  for (size_t layer = 0; layer < net.depth(); layer++) {
+    for (tiny_dnn::vec_t* layer_weights : net[layer]->weights()) {
+      weights.push_back(*layer_weights);
+    }
+  }
+  return weights;
+}
+
+// Sets fixed weights, so networks built separately start out the same
+void SetWeights(tiny_dnn::network<tiny_dnn::sequential>& net) {
+  for (size_t layer = 0; layer < net.depth(); layer++) {
+    for (tiny_dnn::vec_t* layer_weights : net[layer]->weights()) {
+      for (size_t cell = 0; cell < layer_weights->size(); cell++) {
+        (*layer_weights)[cell] = 0.01f * ((cell * 7 + layer) % 13) - 0.06f;
+      }
+    }
+  }
+}
+
+void RequireSameWeights(const std::vector<tiny_dnn::vec_t>& weights,
+                        const std::vector<tiny_dnn::vec_t>& expected) {
+  REQUIRE(weights.size() == expected.size());
+  for (size_t index = 0; index < weights.size(); index++) {
+    REQUIRE(weights[index].size() == expected[index].size());
+    for (size_t cell = 0; cell < weights[index].size(); cell++) {
+      REQUIRE(weights[index][cell] ==
+              Approx(expected[index][cell]).margin(0.0001));
+    }
+  }
+}
+
+// Trains two chunks, the second ending in a smaller minibatch
+std::vector<tiny_dnn::vec_t> TrainWithThreads(
+    size_t number_threads, const std::vector<tiny_dnn::vec_t>& features,
+    const std::vector<tiny_dnn::label_t>& labels) {
+  tiny_dnn::network<tiny_dnn::sequential> net = CreateNetwork();
+  DataParallelTrainer trainer(net, CreateNetwork, number_threads);
+  REQUIRE(trainer.GetNumberThreads() == number_threads);
+  SetWeights(net);
+  PersistentAdam optimizer;
+  optimizer.alpha = 0.01f;
+  trainer.Train(optimizer, features, labels, 4);
+  trainer.Train(optimizer, features, labels, 4);
+  return CopyWeights(net);
+}
+
+} // namespace
+
+TEST_CASE("Data parallel training") {
+  std::vector<tiny_dnn::vec_t> features;
+  std::vector<tiny_dnn::label_t> labels;
+  for (size_t example = 0; example < 11; example++) {
+    tiny_dnn::vec_t example_features(42, 0);
+    example_features[example * 3 % 42] = 1;
+    example_features[example * 5 % 42] = -1;
+    features.push_back(example_features);
+    labels.push_back(example % 3);
+  }
+
+  SECTION("Matches training each minibatch on one thread") {
+    tiny_dnn::network<tiny_dnn::sequential> net = CreateNetwork();
+    SetWeights(net);
+    PersistentAdam optimizer;
+    optimizer.alpha = 0.01f;
+    net.train<tiny_dnn::cross_entropy>(optimizer, features, labels, 4, 1);
+    net.train<tiny_dnn::cross_entropy>(optimizer, features, labels, 4, 1);
+    std::vector<tiny_dnn::vec_t> expected = CopyWeights(net);
+
+    RequireSameWeights(TrainWithThreads(1, features, labels), expected);
+    RequireSameWeights(TrainWithThreads(3, features, labels), expected);
+  }
+
+  SECTION("More threads than examples") {
+    std::vector<tiny_dnn::vec_t> one_thread =
+        TrainWithThreads(1, features, labels);
+    RequireSameWeights(TrainWithThreads(16, features, labels), one_thread);
+  }
+
+  SECTION("Every example needs a label") {
+    tiny_dnn::network<tiny_dnn::sequential> net = CreateNetwork();
+    DataParallelTrainer trainer(net, CreateNetwork, 2);
+    PersistentAdam optimizer;
+    labels.pop_back();
+    REQUIRE_THROWS_AS(trainer.Train(optimizer, features, labels, 4),
+                      std::invalid_argument);
+  }
+
+  SECTION("Replicas need the network's shape") {
+    tiny_dnn::network<tiny_dnn::sequential> net = CreateNetwork();
+    DataParallelTrainer trainer(net, []() {
+      tiny_dnn::network<tiny_dnn::sequential> other;
+      other << tiny_dnn::fully_connected_layer(42, 3)
+            << tiny_dnn::softmax();
+      return other;
+    }, 2);
+    PersistentAdam optimizer;
+    REQUIRE_THROWS_AS(trainer.Train(optimizer, features, labels, 4),
+                      std::invalid_argument);
+  }
+}
@@ -2,7 +2,15 @@
 
 #include <core/data_parser.h>
 
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
 using connect_four::DataParser;
+using connect_four::DataStream;
+using connect_four::DataFormat;
 
 TEST_CASE("Read Example Numeric CSV") {
   DataParser test;
@@ -178,4 +186,205 @@ TEST_CASE("Read Example CSV2") {
     REQUIRE(testIn.size() == 0);
     REQUIRE(testOut.size() == 0);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Stream data from an open file") {
+  DataParser test;
+  DataParser expected;
+
+  SECTION("Consecutive reads match reading each chunk from the start") {
+    DataStream stream("data/c4_game_database.csv", DataFormat::Numeric);
+    stream.SeekToExample(1640);
+    test.YieldTrainingData(stream, 1000);
+    test.YieldTrainingData(stream, 1000);
+
+    expected.YieldTrainingDataNumericCSV("data/c4_game_database.csv", 1640,
+                                         1000);
+    expected.YieldTrainingDataNumericCSV("data/c4_game_database.csv", 2640,
+                                         1000);
+    REQUIRE(test.GetTrainFeatures() == expected.GetTrainFeatures());
+    REQUIRE(test.GetTrainLabels() == expected.GetTrainLabels());
+    REQUIRE(stream.GetNextExample() == 3640);
+  }
+
+  SECTION("Seeking with an index matches reading from the start") {
+    DataStream stream("data/connect-4.data", DataFormat::String);
+    stream.BuildIndex(100);
+    stream.SeekToExample(2517);
+    test.YieldTestData(stream, 50);
+
+    // Seeking backwards also uses the index
+    stream.SeekToExample(6);
+    test.YieldTestData(stream, 2);
+
+    expected.YieldTestDataStringCSV("data/connect-4.data", 2517, 50);
+    expected.YieldTestDataStringCSV("data/connect-4.data", 6, 2);
+    REQUIRE(test.GetTestFeatures() == expected.GetTestFeatures());
+    REQUIRE(test.GetTestLabels() == expected.GetTestLabels());
+  }
+
+  SECTION("Building an index keeps the cursor in place") {
+    DataStream stream("data/c4_short_database.csv", DataFormat::Numeric);
+    stream.SeekToExample(2);
+    stream.BuildIndex(1);
+    test.YieldTrainingData(stream, 5);
+
+    expected.YieldTrainingDataNumericCSV("data/c4_short_database.csv", 2, 1);
+    REQUIRE(test.GetTrainFeatures() == expected.GetTrainFeatures());
+    REQUIRE(test.GetTrainLabels() == expected.GetTrainLabels());
+  }
+
+  SECTION("Seeking past the end of the file throws") {
+    DataStream stream("data/c4_short_database.csv", DataFormat::Numeric);
+    REQUIRE_THROWS_AS(stream.SeekToExample(100), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Sidecar index files") {
+  DataParser test;
+  DataParser expected;
+  std::string index_path = "data/test_connect-4.data.idx";
+
+  SECTION("A loaded index seeks like a built one") {
+    DataStream built("data/connect-4.data", DataFormat::String);
+    built.BuildIndex(64);
+    built.SaveIndex(index_path);
+
+    DataStream loaded("data/connect-4.data", DataFormat::String);
+    REQUIRE(loaded.LoadIndex(index_path));
+    REQUIRE(loaded.GetNumberExamples() == built.GetNumberExamples());
+
+    test.YieldTrainingData(loaded, 3001, 10);
+    test.YieldTrainingData(loaded, 6, 2);
+    expected.YieldTrainingDataStringCSV("data/connect-4.data", 3001, 10);
+    expected.YieldTrainingDataStringCSV("data/connect-4.data", 6, 2);
+    REQUIRE(test.GetTrainFeatures() == expected.GetTrainFeatures());
+    REQUIRE(test.GetTrainLabels() == expected.GetTrainLabels());
+  }
+
+  SECTION("An index for a different CSV is rejected") {
+    DataStream built("data/connect-4.data", DataFormat::String);
+    built.BuildIndex(64);
+    built.SaveIndex(index_path);
+
+    DataStream other("data/c4_short_database.csv", DataFormat::Numeric);
+    REQUIRE_FALSE(other.LoadIndex(index_path));
+    REQUIRE(other.GetNumberExamples() == 0);
+  }
+
+  SECTION("An index for a CSV rewritten to the same size is rejected") {
+    std::string csv_path = "data/test_rewritten.data";
+    std::ifstream source("data/connect-4.data", std::ios::binary);
+    std::vector<std::string> lines;
+    std::string line;
+    for (size_t number = 0; number < 200 && std::getline(source, line);
+         number++) {
+      lines.push_back(line);
+    }
+    {
+      std::ofstream csv(csv_path, std::ios::binary);
+      for (const std::string& written : lines) {
+        csv << written << "\n";
+      }
+    }
+    DataStream built(csv_path, DataFormat::String);
+    built.BuildIndex(16);
+    built.SaveIndex(index_path);
+
+    // Swapping two lines of different lengths moves every offset between
+    // them, without changing the size
+    size_t other = 1;
+    while (lines[other].size() == lines[0].size()) {
+      other++;
+    }
+    std::swap(lines[0], lines[other]);
+    {
+      std::ofstream csv(csv_path, std::ios::binary);
+      for (const std::string& written : lines) {
+        csv << written << "\n";
+      }
+    }
+    DataStream rewritten(csv_path, DataFormat::String);
+    REQUIRE_FALSE(rewritten.LoadIndex(index_path));
+    std::remove(csv_path.c_str());
+  }
+
+  SECTION("A missing index is rejected") {
+    DataStream stream("data/c4_short_database.csv", DataFormat::Numeric);
+    REQUIRE_FALSE(stream.LoadIndex("data/missing.idx"));
+  }
+
+  SECTION("Saving without an index throws") {
+    DataStream stream("data/c4_short_database.csv", DataFormat::Numeric);
+    REQUIRE_THROWS_AS(stream.SaveIndex(index_path), std::invalid_argument);
+  }
+
+  std::remove(index_path.c_str());
+}
+
+TEST_CASE("Take training data without copying") {
+  DataParser test;
+  test.YieldTrainingDataNumericCSV("data/c4_short_database.csv", 1, 2);
+  test.YieldTestDataNumericCSV("data/c4_short_database.csv", 1, 1);
+
+  std::vector<tiny_dnn::vec_t> features;
+  std::vector<tiny_dnn::label_t> labels;
+  test.TakeTrainingData(features, labels);
+
+  REQUIRE(features.size() == 2);
+  REQUIRE(labels == std::vector<tiny_dnn::label_t>({0, 2}));
+  REQUIRE(test.GetTrainFeatures().empty());
+  REQUIRE(test.GetTrainLabels().empty());
+  REQUIRE(test.GetTestLabels().size() == 1);
+}
+
+TEST_CASE("Mirror training examples") {
+  DataParser test;
+  test.SetMirrorAugmentation(true);
+
+  SECTION("Each read appends the mirrored examples") {
+    test.YieldTrainingDataStringCSV("data/connect-4.data", 6, 2);
+    test.YieldTestDataStringCSV("data/connect-4.data", 6, 2);
+
+    std::vector<tiny_dnn::label_t> expected_labels({2, 1, 2, 1});
+    std::vector<tiny_dnn::vec_t> expected_features({{0, 0, 0, -1, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0,
+                                                     0, 0, 0, -1, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0,
+                                                     0, 0, 0, -1, 0, 0, 0,
+                                                     0, 0, 1, 1, 0, 0, -1},
+                                                    {0, 0, 0, -1, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0,
+                                                     0, 0, 0, -1, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0,
+                                                     0, 0, 0, -1, 0, 0, 0,
+                                                     0, 1, -1, 1, 0, 0, 0},
+                                                    {0, 0, 0, -1, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0,
+                                                     0, 0, 0, -1, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0,
+                                                     0, 0, 0, -1, 0, 0, 0,
+                                                     -1, 0, 0, 1, 1, 0, 0},
+                                                    {0, 0, 0, -1, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0,
+                                                     0, 0, 0, -1, 0, 0, 0,
+                                                     0, 0, 0, 1, 0, 0, 0,
+                                                     0, 0, 0, -1, 0, 0, 0,
+                                                     0, 0, 0, 1, -1, 1, 0}});
+    REQUIRE(test.GetTrainFeatures() == expected_features);
+    REQUIRE(test.GetTrainLabels() == expected_labels);
+
+    // Test examples aren't mirrored
+    REQUIRE(test.GetTestLabels().size() == 2);
+  }
+
+  SECTION("Streams and packed datasets are mirrored too") {
+    DataStream stream("data/c4_short_database.csv", DataFormat::Numeric);
+    test.YieldTrainingData(stream, 2);
+    REQUIRE(test.GetTrainLabels().size() == 4);
+
+    test.SetMirrorAugmentation(false);
+    test.YieldTrainingData(stream, 1, 2);
+    REQUIRE(test.GetTrainLabels().size() == 6);
+  }
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+#include <core/data_parser.h>
+#include <core/deduplicator.h>
+
+using connect_four::AggregatedDataset;
+using connect_four::DataFormat;
+using connect_four::DataParser;
+using connect_four::DataStream;
+using connect_four::Deduplicator;
+using connect_four::aggregated_example;
+
+TEST_CASE("Deduplicate datasets") {
+  std::string output_path = "data/test_dedup.bin";
+  std::string csv_path = "data/test_dedup.csv";
+  std::string first_row =
+      "1,1,1,-1,-1,1,0,-1,-1,-1,1,-1,-1,0,-1,1,1,-1,1,1,0,1,-1,1,-1,-1,"
+      "-1,-1,1,1,-1,-1,1,1,1,-1,1,-1,1,-1,1,-1,";
+  std::string second_row =
+      "0,0,1,1,1,1,0,0,0,1,-1,-1,-1,0,0,0,1,1,1,-1,0,0,0,-1,-1,1,1,-1,"
+      "1,-1,-1,1,-1,-1,1,1,-1,-1,-1,1,1,-1,";
+
+  // The first position three times with different results, the second once
+  std::ofstream csv(csv_path);
+  csv << "header" << std::endl;
+  csv << first_row << "-1" << std::endl;
+  csv << second_row << "1" << std::endl;
+  csv << first_row << "-1" << std::endl;
+  csv << first_row << "0" << std::endl;
+  csv.close();
+
+  SECTION("Duplicates are merged with their label counts") {
+    Deduplicator deduplicator("data/test_partition_", 4);
+    DataStream stream(csv_path, DataFormat::Numeric);
+    deduplicator.AddDataset(stream);
+    REQUIRE(deduplicator.GetNumberExamplesRead() == 4);
+    REQUIRE(deduplicator.Finish(output_path) == 2);
+
+    AggregatedDataset dataset(output_path);
+    REQUIRE(dataset.GetNumberExamples() == 2);
+
+    std::vector<tiny_dnn::vec_t> features;
+    std::vector<tiny_dnn::vec_t> targets;
+    dataset.YieldExamples(1, 2, features, targets);
+
+    DataParser expected;
+    expected.YieldTrainingDataNumericCSV(csv_path, 1, 2);
+    const std::vector<tiny_dnn::vec_t>& rows = expected.GetTrainFeatures();
+    for (size_t index = 0; index < 2; index++) {
+      if (features[index] == rows[0]) {
+        REQUIRE(targets[index][0] == Approx(2.0f / 3));
+        REQUIRE(targets[index][1] == Approx(1.0f / 3));
+        REQUIRE(targets[index][2] == Approx(0));
+      } else {
+        REQUIRE(features[index] == rows[1]);
+        REQUIRE(targets[index] == tiny_dnn::vec_t({0, 0, 1}));
+      }
+    }
+  }
+
+  SECTION("Duplicates across datasets are merged") {
+    Deduplicator deduplicator("data/test_partition_", 3);
+    DataStream first(csv_path, DataFormat::Numeric);
+    DataStream second(csv_path, DataFormat::Numeric);
+    deduplicator.AddDataset(first);
+    deduplicator.AddDataset(second);
+    REQUIRE(deduplicator.Finish(output_path) == 2);
+
+    AggregatedDataset dataset(output_path);
+    uint32_t total = 0;
+    for (size_t index = 0; index < dataset.GetNumberExamples(); index++) {
+      aggregated_example example = dataset.GetExample(index);
+      total += example.counts[0] + example.counts[1] + example.counts[2];
+      REQUIRE((example.x_mask & example.o_mask) == 0);
+    }
+    REQUIRE(total == 8);
+  }
+
+  SECTION("Partition files are removed") {
+    {
+      Deduplicator deduplicator("data/test_partition_", 2);
+    }
+    REQUIRE_FALSE(std::ifstream("data/test_partition_0").is_open());
+    REQUIRE_FALSE(std::ifstream("data/test_partition_1").is_open());
+  }
+
+  SECTION("Reading past the end throws") {
+    Deduplicator deduplicator("data/test_partition_", 2);
+    DataStream stream(csv_path, DataFormat::Numeric);
+    deduplicator.AddDataset(stream);
+    deduplicator.Finish(output_path);
+
+    AggregatedDataset dataset(output_path);
+    REQUIRE_THROWS_AS(dataset.GetExample(2), std::out_of_range);
+    REQUIRE_THROWS_AS(AggregatedDataset{csv_path}, std::invalid_argument);
+  }
+
+  std::remove(output_path.c_str());
+  std::remove(csv_path.c_str());
+}
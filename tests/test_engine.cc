@@ -0,0 +1,208 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <core/engine.h>
+
+using connect_four::Engine;
+using connect_four::go_limits;
+
+namespace {
+
+std::vector<std::string> SplitLines(const std::string& text) {
+  std::vector<std::string> lines;
+  std::istringstream stream(text);
+  std::string line;
+  while (std::getline(stream, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+// Runs the commands in order and waits for any search they started
+std::vector<std::string> RunCommands(
+    const std::vector<std::string>& commands) {
+  std::ostringstream output;
+  Engine engine(output);
+  for (const std::string& command : commands) {
+    engine.HandleCommand(command);
+  }
+  engine.Wait();
+  return SplitLines(output.str());
+}
+
+bool StartsWith(const std::string& line, const std::string& prefix) {
+  return line.compare(0, prefix.size(), prefix) == 0;
+}
+
+// Reads the value after a word in an info line
+std::string FindValue(const std::string& line, const std::string& name) {
+  std::istringstream words(line);
+  std::string word;
+  while (words >> word) {
+    if (word == name) {
+      words >> word;
+      return word;
+    }
+  }
+  return "";
+}
+
+} // namespace
+
+TEST_CASE("Engine protocol commands") {
+  SECTION("isready is answered") {
+    REQUIRE(RunCommands({"isready"}) == std::vector<std::string>{"readyok"});
+  }
+
+  SECTION("Blank lines are ignored") {
+    REQUIRE(RunCommands({"", "   "}).empty());
+  }
+
+  SECTION("Unknown commands and options are reported") {
+    std::vector<std::string> lines = RunCommands({"fly",
+                                                  "setoption evaluator x"});
+    REQUIRE(lines.size() == 2);
+    REQUIRE(StartsWith(lines[0], "info string Unknown command fly"));
+    REQUIRE(StartsWith(lines[1], "info string Unknown option"));
+  }
+
+  SECTION("quit ends the protocol") {
+    std::ostringstream output;
+    Engine engine(output);
+    REQUIRE(engine.HandleCommand("isready"));
+    REQUIRE_FALSE(engine.HandleCommand("quit"));
+  }
+
+  SECTION("An invalid position is reported and the board is kept") {
+    std::vector<std::string> lines = RunCommands({
+        "setoption evaluator threats", "position 0000000", "go depth 1"});
+    REQUIRE(StartsWith(lines[0], "info string Invalid move"));
+    // The empty board is still searched
+    REQUIRE(FindValue(lines[1], "pv") == "3");
+  }
+}
+
+TEST_CASE("Engine search") {
+  SECTION("Each depth gets an info line, then the best move") {
+    std::vector<std::string> lines = RunCommands({
+        "setoption evaluator threats", "position 3342", "go depth 4"});
+    REQUIRE(lines.size() == 5);
+    for (size_t depth = 1; depth <= 4; depth++) {
+      REQUIRE(StartsWith(lines[depth - 1], "info depth "));
+      REQUIRE(FindValue(lines[depth - 1], "depth") == std::to_string(depth));
+      REQUIRE_FALSE(FindValue(lines[depth - 1], "nodes").empty());
+    }
+    REQUIRE(StartsWith(lines[4], "bestmove "));
+    REQUIRE(lines[4] == "bestmove " + FindValue(lines[3], "pv"));
+  }
+
+  SECTION("An immediate win is played") {
+    // X has three in the bottom row
+    std::vector<std::string> lines = RunCommands({
+        "setoption evaluator threats", "position 001122", "go depth 3"});
+    REQUIRE(lines.back() == "bestmove 3");
+  }
+
+  SECTION("A finished game has no best move") {
+    std::vector<std::string> lines = RunCommands({
+        "setoption evaluator threats", "position 0101010", "go depth 3"});
+    REQUIRE(lines == std::vector<std::string>{"bestmove none"});
+  }
+
+  SECTION("The depth is capped at the end of the game") {
+    // One empty cell is left
+    std::string moves = "06513540306345322335400401116266445522112";
+    std::vector<std::string> lines = RunCommands({
+        "setoption evaluator threats", "position " + moves, "go depth 10"});
+    REQUIRE(lines.size() == 2);
+    REQUIRE(lines.back() == "bestmove 6");
+  }
+
+  SECTION("Several threads find the same score") {
+    std::vector<std::string> single = RunCommands({
+        "setoption evaluator threats", "position 334", "go depth 5"});
+    std::vector<std::string> split = RunCommands({
+        "setoption evaluator threats", "position 334",
+        "go depth 5 threads 3"});
+    REQUIRE(split.size() == single.size());
+    for (size_t index = 0; index + 1 < single.size(); index++) {
+      REQUIRE(std::stof(FindValue(split[index], "score")) ==
+              Approx(std::stof(FindValue(single[index], "score")))
+                  .margin(0.001));
+    }
+    REQUIRE(StartsWith(split.back(), "bestmove "));
+  }
+
+  SECTION("stop ends an unlimited search with a move") {
+    std::ostringstream output;
+    Engine engine(output);
+    engine.HandleCommand("setoption evaluator threats");
+    engine.HandleCommand("go");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    engine.HandleCommand("stop");
+
+    std::vector<std::string> lines = SplitLines(output.str());
+    REQUIRE_FALSE(lines.empty());
+    REQUIRE(StartsWith(lines.back(), "bestmove "));
+    REQUIRE(lines.back() != "bestmove none");
+  }
+
+  SECTION("A time limit ends the search") {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> lines = RunCommands({
+        "setoption evaluator threats", "go movetime 50 threads 2"});
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    REQUIRE(StartsWith(lines.back(), "bestmove "));
+    REQUIRE(seconds < 5);
+  }
+
+  SECTION("A new go replaces the running search") {
+    std::ostringstream output;
+    Engine engine(output);
+    engine.HandleCommand("setoption evaluator threats");
+    engine.HandleCommand("go");
+    engine.HandleCommand("go depth 2");
+    engine.Wait();
+
+    size_t best_moves = 0;
+    for (const std::string& line : SplitLines(output.str())) {
+      best_moves += StartsWith(line, "bestmove ");
+    }
+    REQUIRE(best_moves == 2);
+  }
+}
+
+TEST_CASE("Parse go limits") {
+  SECTION("No limits") {
+    std::istringstream words("");
+    go_limits limits = Engine::ParseLimits(words);
+    REQUIRE(limits.depth == 0);
+    REQUIRE(limits.move_time_ms == 0);
+    REQUIRE(limits.number_threads == 1);
+  }
+
+  SECTION("Every limit") {
+    std::istringstream words("threads 4 depth 9 movetime 250");
+    go_limits limits = Engine::ParseLimits(words);
+    REQUIRE(limits.depth == 9);
+    REQUIRE(limits.move_time_ms == 250);
+    REQUIRE(limits.number_threads == 4);
+  }
+
+  SECTION("A limit needs a number") {
+    std::istringstream words("depth deep");
+    REQUIRE_THROWS_AS(Engine::ParseLimits(words), std::invalid_argument);
+  }
+
+  SECTION("Unknown limits are invalid") {
+    std::istringstream words("nodes 100");
+    REQUIRE_THROWS_AS(Engine::ParseLimits(words), std::invalid_argument);
+  }
+}
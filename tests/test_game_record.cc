@@ -0,0 +1,169 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <core/game_record.h>
+
+using connect_four::BoardState;
+using connect_four::GameBoard;
+using connect_four::GameRecordReader;
+using connect_four::GameRecordWriter;
+using connect_four::GameReplay;
+using connect_four::game_record;
+
+namespace {
+
+game_record CreateRecord(const std::string& moves, BoardState result) {
+  game_record record;
+  for (char move : moves) {
+    record.moves.push_back(static_cast<uint8_t>(move - '0'));
+  }
+  record.result = result;
+  return record;
+}
+
+} // namespace
+
+TEST_CASE("Encode game records") {
+  SECTION("Moves take three bits each after a one-byte header") {
+    REQUIRE(GameRecordWriter::Encode(game_record()).size() == 1);
+    REQUIRE(GameRecordWriter::Encode(
+        CreateRecord("0000111", BoardState::Xwins)).size() == 4);
+    REQUIRE(GameRecordWriter::Encode(
+        CreateRecord("33333", BoardState::InProgress)).size() == 3);
+  }
+
+  SECTION("Values that don't fit the format") {
+    REQUIRE_THROWS_AS(GameRecordWriter::Encode(
+                          CreateRecord("37", BoardState::InProgress)),
+                      std::invalid_argument);
+    game_record record;
+    record.moves.assign(43, 0);
+    REQUIRE_THROWS_AS(GameRecordWriter::Encode(record),
+                      std::invalid_argument);
+  }
+
+  SECTION("Move strings") {
+    REQUIRE(CreateRecord("3342", BoardState::InProgress).GetMoveString() ==
+            "3342");
+  }
+}
+
+TEST_CASE("Write and read game records") {
+  std::string path = "data/test_games.bin";
+  std::vector<game_record> games = {
+      CreateRecord("0101010", BoardState::Xwins),
+      game_record(),
+      CreateRecord("06513540306345322335400401116266445522112",
+                   BoardState::InProgress),
+      CreateRecord("3332221", BoardState::InProgress)};
+
+  SECTION("Games come back in order with the metadata") {
+    {
+      GameRecordWriter writer(path, "depth 6 vs depth 4");
+      for (const game_record& game : games) {
+        writer.Write(game);
+      }
+      REQUIRE(writer.Close() == games.size());
+    }
+
+    GameRecordReader reader(path);
+    REQUIRE(reader.GetMetadata() == "depth 6 vs depth 4");
+    REQUIRE(reader.GetNumberGames() == games.size());
+    game_record record;
+    for (const game_record& game : games) {
+      REQUIRE(reader.Next(record));
+      REQUIRE(record.moves == game.moves);
+      REQUIRE(record.result == game.result);
+    }
+    REQUIRE_FALSE(reader.Next(record));
+  }
+
+  SECTION("The number of games is written when the writer is destroyed") {
+    {
+      GameRecordWriter writer(path, "");
+      writer.Write(games[0]);
+    }
+    GameRecordReader reader(path);
+    REQUIRE(reader.GetMetadata().empty());
+    REQUIRE(reader.GetNumberGames() == 1);
+  }
+
+  SECTION("A cut off game") {
+    {
+      GameRecordWriter writer(path, "");
+      writer.Write(games[2]);
+    }
+    {
+      std::ifstream file(path, std::ios::binary);
+      std::string bytes((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+      std::ofstream cut_file(path, std::ios::binary);
+      cut_file.write(bytes.data(), bytes.size() - 1);
+    }
+    GameRecordReader reader(path);
+    game_record record;
+    REQUIRE_THROWS_AS(reader.Next(record), std::invalid_argument);
+  }
+
+  SECTION("A file that isn't a game record file") {
+    {
+      std::ofstream file(path);
+      file << "0,1,2\n";
+    }
+    REQUIRE_THROWS_AS(GameRecordReader(path.c_str()),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(GameRecordReader("data/missing_games.bin"),
+                      std::invalid_argument);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Replay games") {
+  SECTION("Positions are rebuilt one move at a time") {
+    game_record record = CreateRecord("3342", BoardState::InProgress);
+    GameReplay replay(record);
+    REQUIRE(replay.GetPly() == 0);
+    REQUIRE(replay.GetBoard().GetOccupiedBitboard() == 0);
+
+    for (size_t ply = 1; ply <= record.moves.size(); ply++) {
+      REQUIRE(replay.Next());
+      REQUIRE(replay.GetPly() == ply);
+      REQUIRE(replay.GetBoard().GetKey() ==
+              GameBoard::FromMoves(record.GetMoveString().substr(0, ply))
+                  .GetKey());
+    }
+    REQUIRE_FALSE(replay.Next());
+  }
+
+  SECTION("A finished game") {
+    game_record record = CreateRecord("0101010", BoardState::Xwins);
+    GameReplay replay(record);
+    while (replay.Next()) {
+    }
+    REQUIRE(replay.GetBoard().GetGameState() == BoardState::Xwins);
+  }
+
+  SECTION("A move into a full column") {
+    game_record record = CreateRecord("0000000", BoardState::InProgress);
+    GameReplay replay(record);
+    for (size_t ply = 0; ply < 6; ply++) {
+      REQUIRE(replay.Next());
+    }
+    REQUIRE_THROWS_AS(replay.Next(), std::invalid_argument);
+  }
+
+  SECTION("Moves that don't lead to the recorded result") {
+    game_record record = CreateRecord("0101010", BoardState::Owins);
+    GameReplay replay(record);
+    for (size_t ply = 0; ply < record.moves.size(); ply++) {
+      REQUIRE(replay.Next());
+    }
+    REQUIRE_THROWS_AS(replay.Next(), std::invalid_argument);
+  }
+}
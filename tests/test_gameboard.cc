@@ -4,8 +4,14 @@
 
 using connect_four::GameBoard;
 using connect_four::BoardState;
+using connect_four::MoveList;
 using std::vector;
 
+// Copies a move list so it can be compared against expected vectors
+vector<size_t> ToVector(const MoveList& moves) {
+  return vector<size_t>(moves.begin(), moves.end());
+}
+
 TEST_CASE("Default Constructor is valid and has no pieces") {
   GameBoard empty;
   REQUIRE(empty.GetIsXTurn());
@@ -380,7 +386,7 @@ TEST_CASE("Test calculate valid columns") {
     GameBoard test(valid, true);
 
     vector<size_t> expected_empty = {};
-    REQUIRE(test.CalculateValidColumns() == expected_empty);
+    REQUIRE(ToVector(test.CalculateValidColumns()) == expected_empty);
   }
 
   SECTION("Valid game returns non-filled columns") {
@@ -393,7 +399,7 @@ TEST_CASE("Test calculate valid columns") {
     GameBoard test(valid, true);
 
     vector<size_t> expected_empty = {3, 2, 5, 1, 6};
-    REQUIRE(test.CalculateValidColumns() == expected_empty);
+    REQUIRE(ToVector(test.CalculateValidColumns()) == expected_empty);
   }
 }
 
@@ -461,4 +467,260 @@ TEST_CASE("Test drop piece") {
   }
 }
 
+TEST_CASE("Test position keys") {
+  SECTION("Transpositions have the same key") {
+    GameBoard first;
+    first.DropPiece(3);
+    first.DropPiece(2);
+    first.DropPiece(4);
+
+    GameBoard second;
+    second.DropPiece(4);
+    second.DropPiece(2);
+    second.DropPiece(3);
+
+    REQUIRE(first.GetKey() == second.GetKey());
+  }
+
+  SECTION("Different positions have different keys") {
+    GameBoard first;
+    first.DropPiece(3);
+    first.DropPiece(2);
+
+    GameBoard second;
+    second.DropPiece(2);
+    second.DropPiece(3);
+
+    GameBoard empty;
+    REQUIRE(first.GetKey() != second.GetKey());
+    REQUIRE(first.GetKey() != empty.GetKey());
+  }
+
+  SECTION("Constructed and played positions have the same key") {
+    vector<vector<int>> valid = {   {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 1, 0, 0, 0, 0},
+                                    {0, 0, -1, 0, 0, 0, 1}};
+    GameBoard constructed(valid, false);
+
+    GameBoard played;
+    played.DropPiece(6);
+    played.DropPiece(2);
+    played.DropPiece(2);
+
+    REQUIRE(constructed.GetKey() == played.GetKey());
+  }
+
+  SECTION("Reset restores the empty key") {
+    GameBoard test;
+    GameBoard empty;
+    test.DropPiece(1);
+    test.Reset();
+
+    REQUIRE(test.GetKey() == empty.GetKey());
+  }
+}
+
+TEST_CASE("Test mirroring") {
+  SECTION("Mirror reflects every piece") {
+    vector<vector<int>> pieces = {  {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 1, 0, 0, 0, 0},
+                                    {0, 0, -1, 0, 0, 0, 1}};
+    GameBoard test(pieces, false);
+    GameBoard mirrored = test.Mirror();
+
+    for (size_t row = 0; row < GameBoard::kHeight; row++) {
+      for (size_t col = 0; col < GameBoard::kWidth; col++) {
+        REQUIRE(mirrored.GetPieceAtLocation(row, col) ==
+                test.GetPieceAtLocation(row, GameBoard::kWidth - 1 - col));
+      }
+    }
+    REQUIRE(mirrored.GetIsXTurn() == test.GetIsXTurn());
+    REQUIRE(mirrored.GetGameState() == test.GetGameState());
+  }
+
+  SECTION("Mirrored and reflected play match") {
+    GameBoard played;
+    played.DropPiece(0);
+    played.DropPiece(2);
+    played.DropPiece(3);
+
+    GameBoard reflected;
+    reflected.DropPiece(6);
+    reflected.DropPiece(4);
+    reflected.DropPiece(3);
+
+    REQUIRE(played.Mirror().GetKey() == reflected.GetKey());
+    REQUIRE(played.Mirror().Mirror().GetKey() == played.GetKey());
+  }
+
+  SECTION("A position and its mirror share a canonical key") {
+    GameBoard test;
+    test.DropPiece(1);
+    test.DropPiece(3);
+
+    REQUIRE(test.GetCanonicalKey() == test.Mirror().GetCanonicalKey());
+    REQUIRE(test.GetCanonicalKey() ==
+            std::min(test.GetKey(), test.Mirror().GetKey()));
+  }
+
+  SECTION("Different positions have different canonical keys") {
+    GameBoard first;
+    first.DropPiece(1);
+
+    GameBoard second;
+    second.DropPiece(2);
+
+    REQUIRE(first.GetCanonicalKey() != second.GetCanonicalKey());
+  }
+
+  SECTION("Symmetric positions are their own mirror") {
+    GameBoard test;
+    test.DropPiece(3);
+    test.DropPiece(3);
+
+    REQUIRE(test.Mirror().GetKey() == test.GetKey());
+    REQUIRE(test.GetCanonicalKey() == test.GetKey());
+  }
+}
+
+TEST_CASE("Test calculate threats") {
+  SECTION("Empty board has no threats") {
+    GameBoard test;
+    REQUIRE(test.CalculateThreats(true) == 0);
+    REQUIRE(test.CalculateThreats(false) == 0);
+  }
+
+  SECTION("Vertical three threatens the cell above it") {
+    vector<vector<int>> valid = {   {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 1, 0, 0, 0, 0},
+                                    {0, 0, 1, 0, -1, 0, 0},
+                                    {0, 0, 1, 0, -1, 0, 0}};
+    GameBoard test(valid, false);
+    // Column 2, fourth cell from the bottom
+    REQUIRE(test.CalculateThreats(true) == uint64_t(1) << (2 * 7 + 3));
+    REQUIRE(test.CalculateThreats(false) == 0);
+  }
+
+  SECTION("Horizontal and diagonal threats are found") {
+    vector<vector<int>> valid = {   {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, -1, 0, 0, 0},
+                                    {0, 0, -1, 1, 0, 0, 0},
+                                    {0, -1, 1, 1, 1, 0, 0}};
+    GameBoard test(valid, false);
+    // X's bottom row threatens column 5, O's diagonal threatens column 4
+    // four cells up
+    REQUIRE(test.CalculateThreats(true) == uint64_t(1) << (5 * 7 + 0));
+    REQUIRE(test.CalculateThreats(false) == uint64_t(1) << (4 * 7 + 3));
+  }
+}
+
+TEST_CASE("Test winning and non-losing moves") {
+  SECTION("Winning moves only include playable threats") {
+    vector<vector<int>> valid = {   {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, -1, 0, 0, 0},
+                                    {0, 0, -1, 1, 0, 0, 0},
+                                    {0, -1, 1, 1, 1, 0, 0}};
+    GameBoard test(valid, false);
+    REQUIRE(test.CalculateWinningMoves(true) == uint64_t(1) << (5 * 7 + 0));
+    REQUIRE(test.CalculateWinningMoves(false) == 0);
+    REQUIRE(ToVector(test.ConvertToColumns(test.CalculateWinningMoves(true))) ==
+            vector<size_t>({5}));
+  }
+
+  SECTION("Empty board has every column as non-losing") {
+    GameBoard test;
+    vector<size_t> expected = {3, 4, 2, 5, 1, 6, 0};
+    REQUIRE(ToVector(test.CalculateNonLosingColumns()) == expected);
+  }
+
+  SECTION("Opponent threat forces a block") {
+    vector<vector<int>> valid = {   {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, -1, 0, 0, 0},
+                                    {-1, 1, 1, 1, 0, 0, 0}};
+    GameBoard test(valid, false);
+    vector<size_t> expected = {4};
+    REQUIRE(ToVector(test.CalculateNonLosingColumns()) == expected);
+  }
 
+  SECTION("Two opponent threats leave no non-losing moves") {
+    vector<vector<int>> valid = {   {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, -1, 0, 0, 0},
+                                    {0, 1, 1, 1, 0, 0, -1}};
+    GameBoard test(valid, false);
+    REQUIRE(test.CalculateNonLosingMoves() == 0);
+    REQUIRE(test.CalculateNonLosingColumns().empty());
+  }
+
+  SECTION("Playing below an opponent threat is excluded") {
+    vector<vector<int>> valid = {   {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, -1, -1, -1, 0, 0, 0},
+                                    {0, 1, 1, -1, 0, 1, 1}};
+    GameBoard test(valid, true);
+    // O threatens the second cell of columns 0 and 4
+    vector<size_t> expected = {3, 2, 5, 1, 6};
+    REQUIRE(ToVector(test.CalculateNonLosingColumns()) == expected);
+  }
+
+  SECTION("Finished game has no non-losing moves") {
+    vector<vector<int>> valid = {   {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, -1, 0},
+                                    {0, 0, 0, 0, 0, -1, 0},
+                                    {1, 1, 1, 1, 0, -1, 0}};
+    GameBoard test(valid, false);
+    REQUIRE(test.CalculateNonLosingMoves() == 0);
+  }
+}
+
+TEST_CASE("Construct a board from moves") {
+  SECTION("No moves is the empty board") {
+    GameBoard board = GameBoard::FromMoves("");
+    REQUIRE(board.GetOccupiedBitboard() == 0);
+    REQUIRE(board.GetIsXTurn());
+  }
+
+  SECTION("Moves are played in order") {
+    GameBoard board = GameBoard::FromMoves("336");
+    REQUIRE(board.GetPieceAtLocation(5, 3) == GameBoard::kXPiece);
+    REQUIRE(board.GetPieceAtLocation(4, 3) == GameBoard::kOPiece);
+    REQUIRE(board.GetPieceAtLocation(5, 6) == GameBoard::kXPiece);
+    REQUIRE(board.GetIsXTurn() == false);
+  }
+
+  SECTION("A character that isn't a column is invalid") {
+    REQUIRE_THROWS_AS(GameBoard::FromMoves("37"), std::invalid_argument);
+    REQUIRE_THROWS_AS(GameBoard::FromMoves("3a"), std::invalid_argument);
+  }
+
+  SECTION("A move into a full column is invalid") {
+    REQUIRE_THROWS_AS(GameBoard::FromMoves("3333333"),
+                      std::invalid_argument);
+  }
+
+  SECTION("A move after the game is over is invalid") {
+    REQUIRE_THROWS_AS(GameBoard::FromMoves("01010102"),
+                      std::invalid_argument);
+  }
+}
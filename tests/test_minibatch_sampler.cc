@@ -0,0 +1,126 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+#include <core/minibatch_sampler.h>
+
+using connect_four::MinibatchSampler;
+using connect_four::example_buffer;
+using connect_four::training_batch;
+
+namespace {
+
+// Builds examples that each have a single X piece, in cell i for example i,
+// labeled with i % 3
+example_buffer CreateExamples(size_t number_examples) {
+  example_buffer buffer;
+  buffer.features.assign(42 * number_examples, 0);
+  for (size_t index = 0; index < number_examples; index++) {
+    buffer.features[42 * index + index] = 1;
+    buffer.labels.push_back(index % 3);
+  }
+  return buffer;
+}
+
+// Finds the cell of an example's single X piece
+size_t FindPiece(const tiny_dnn::vec_t& features) {
+  return std::find(features.begin(), features.end(), 1.0f) -
+         features.begin();
+}
+
+} // namespace
+
+TEST_CASE("Sample shuffled minibatches") {
+  example_buffer buffer = CreateExamples(20);
+  MinibatchSampler sampler(5);
+
+  SECTION("Only the requested range is added") {
+    sampler.AddExamples(buffer, 15, 100);
+    REQUIRE(sampler.GetNumberExamples() == 5);
+  }
+
+  SECTION("An epoch serves every example once") {
+    sampler.AddExamples(buffer, 0, 20);
+    sampler.StartEpoch(0);
+
+    training_batch batch;
+    std::vector<size_t> cells;
+    while (sampler.Next(8, batch)) {
+      REQUIRE(batch.features.size() <= 8);
+      REQUIRE(batch.features.size() == batch.labels.size());
+      for (size_t index = 0; index < batch.features.size(); index++) {
+        size_t cell = FindPiece(batch.features[index]);
+        REQUIRE(batch.labels[index] == cell % 3);
+        cells.push_back(cell);
+      }
+    }
+
+    std::vector<size_t> sorted = cells;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t index = 0; index < 20; index++) {
+      REQUIRE(sorted[index] == index);
+    }
+    REQUIRE(cells != sorted);
+  }
+
+  SECTION("Epochs are shuffled differently") {
+    sampler.AddExamples(buffer, 0, 20);
+    training_batch first;
+    training_batch second;
+    sampler.StartEpoch(0);
+    sampler.Next(20, first);
+    sampler.StartEpoch(1);
+    sampler.Next(20, second);
+    REQUIRE(first.labels.size() == 20);
+    REQUIRE(first.features != second.features);
+  }
+
+  SECTION("Mirroring reflects the columns of some examples") {
+    // Examples 0 to 2 have their piece in top row cell i, or 6 - i if
+    // mirrored, and are labeled i
+    sampler.AddExamples(buffer, 0, 3);
+    sampler.SetMirrorAugmentation(true);
+
+    training_batch batch;
+    size_t mirrored = 0;
+    for (size_t epoch = 0; epoch < 10; epoch++) {
+      sampler.StartEpoch(epoch);
+      sampler.Next(3, batch);
+      for (size_t index = 0; index < batch.features.size(); index++) {
+        size_t cell = FindPiece(batch.features[index]);
+        size_t label = batch.labels[index];
+        REQUIRE((cell == label || cell == 6 - label));
+        if (cell == 6 - label) {
+          mirrored++;
+        }
+      }
+    }
+    REQUIRE(mirrored > 0);
+    REQUIRE(mirrored < 30);
+  }
+
+  SECTION("An epoch can be resumed partway through") {
+    sampler.AddExamples(buffer, 0, 20);
+    sampler.SetMirrorAugmentation(true);
+    training_batch whole;
+    sampler.StartEpoch(3);
+    sampler.Next(20, whole);
+
+    // A new sampler with the same seed serves the same examples
+    MinibatchSampler resumed(5);
+    resumed.AddExamples(buffer, 0, 20);
+    resumed.SetMirrorAugmentation(true);
+    resumed.StartEpoch(3);
+    resumed.Seek(12);
+    REQUIRE(resumed.GetPosition() == 12);
+
+    training_batch rest;
+    REQUIRE(resumed.Next(20, rest));
+    REQUIRE(rest.features.size() == 8);
+    for (size_t index = 0; index < 8; index++) {
+      REQUIRE(rest.features[index] == whole.features[12 + index]);
+      REQUIRE(rest.labels[index] == whole.labels[12 + index]);
+    }
+    REQUIRE_FALSE(resumed.Next(20, rest));
+  }
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+#include <core/model_evaluator.h>
+#include <core/parallel_parser.h>
+
+using connect_four::ModelEvaluator;
+using connect_four::evaluation_result;
+using connect_four::example_buffer;
+
+TEST_CASE("Evaluate a model on a test set") {
+  // Examples with one piece each, in every cell for both players
+  std::vector<tiny_dnn::vec_t> features;
+  std::vector<tiny_dnn::label_t> labels;
+  for (size_t cell = 0; cell < 42; cell++) {
+    for (float piece : {-1.0f, 1.0f}) {
+      tiny_dnn::vec_t example(42, 0);
+      example[cell] = piece;
+      features.push_back(example);
+      labels.push_back(cell % 3);
+    }
+  }
+
+  // The predictions of a single copy of the model, one at a time
+  tiny_dnn::network<tiny_dnn::sequential> model;
+  model.load("net_2");
+  size_t expected_confusion[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+  size_t expected_correct = 0;
+  for (size_t index = 0; index < features.size(); index++) {
+    tiny_dnn::vec_t prediction = model.predict(features[index]);
+    size_t predicted = std::max_element(prediction.begin(),
+                                        prediction.end()) -
+                       prediction.begin();
+    expected_confusion[labels[index]][predicted]++;
+    if (predicted == labels[index]) {
+      expected_correct++;
+    }
+  }
+
+  SECTION("Batches on several threads match predicting one at a time") {
+    ModelEvaluator evaluator("net_2", 3, 5);
+    REQUIRE(evaluator.GetNumberThreads() == 3);
+    evaluation_result result = evaluator.Evaluate(features, labels);
+
+    REQUIRE(result.number_examples == features.size());
+    REQUIRE(result.number_correct == expected_correct);
+    for (size_t label = 0; label < 3; label++) {
+      for (size_t predicted = 0; predicted < 3; predicted++) {
+        REQUIRE(result.confusion[label][predicted] ==
+                expected_confusion[label][predicted]);
+      }
+    }
+    REQUIRE(result.CalculateAccuracy() ==
+            Approx(100.0f * expected_correct / features.size()));
+  }
+
+  SECTION("A buffer of examples is evaluated in place") {
+    example_buffer buffer;
+    for (size_t index = 0; index < features.size(); index++) {
+      buffer.features.insert(buffer.features.end(), features[index].begin(),
+                             features[index].end());
+      buffer.labels.push_back(labels[index]);
+    }
+
+    ModelEvaluator evaluator("net_2", 2, 7);
+    evaluation_result result = evaluator.Evaluate(buffer.features.data(),
+                                                  buffer.labels.data(),
+                                                  buffer.labels.size());
+    REQUIRE(result.number_examples == features.size());
+    REQUIRE(result.number_correct == expected_correct);
+    for (size_t label = 0; label < 3; label++) {
+      for (size_t predicted = 0; predicted < 3; predicted++) {
+        REQUIRE(result.confusion[label][predicted] ==
+                expected_confusion[label][predicted]);
+      }
+    }
+  }
+
+  SECTION("An empty test set has no accuracy") {
+    ModelEvaluator evaluator("net_2", 2);
+    evaluation_result result = evaluator.Evaluate({}, {});
+    REQUIRE(result.number_examples == 0);
+    REQUIRE(result.CalculateAccuracy() == 0);
+  }
+
+  SECTION("Every example needs a label") {
+    ModelEvaluator evaluator("net_2", 1);
+    labels.pop_back();
+    REQUIRE_THROWS_AS(evaluator.Evaluate(features, labels),
+                      std::invalid_argument);
+  }
+
+  SECTION("Every example needs 42 features") {
+    ModelEvaluator evaluator("net_2", 1);
+    features.back().pop_back();
+    REQUIRE_THROWS_AS(evaluator.Evaluate(features, labels),
+                      std::invalid_argument);
+  }
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+#include <core/data_parser.h>
+#include <core/packed_dataset.h>
+
+using connect_four::DataFormat;
+using connect_four::DataParser;
+using connect_four::DataStream;
+using connect_four::PackedDataset;
+using connect_four::packed_example;
+
+TEST_CASE("Pack and load datasets") {
+  DataParser test;
+  DataParser expected;
+  std::string packed_path = "data/test_dataset.bin";
+
+  SECTION("Numeric CSV round trip") {
+    DataStream stream("data/c4_short_database.csv", DataFormat::Numeric);
+    REQUIRE(PackedDataset::Convert(stream, packed_path) == 2);
+
+    PackedDataset dataset(packed_path);
+    REQUIRE(dataset.GetNumberExamples() == 2);
+    test.YieldTrainingData(dataset, 1, 2);
+    expected.YieldTrainingDataNumericCSV("data/c4_short_database.csv", 1, 2);
+    REQUIRE(test.GetTrainFeatures() == expected.GetTrainFeatures());
+    REQUIRE(test.GetTrainLabels() == expected.GetTrainLabels());
+  }
+
+  SECTION("String CSV round trip from the cursor") {
+    DataStream stream("data/connect-4.data", DataFormat::String);
+    stream.SeekToExample(6);
+    PackedDataset::Convert(stream, packed_path);
+
+    PackedDataset dataset(packed_path);
+    test.YieldTestData(dataset, 1, 2);
+    test.YieldTestData(dataset, 2001, 100);
+    expected.YieldTestDataStringCSV("data/connect-4.data", 6, 2);
+    expected.YieldTestDataStringCSV("data/connect-4.data", 2006, 100);
+    REQUIRE(test.GetTestFeatures() == expected.GetTestFeatures());
+    REQUIRE(test.GetTestLabels() == expected.GetTestLabels());
+  }
+
+  SECTION("Records hold both masks and the label") {
+    DataStream stream("data/connect-4.data", DataFormat::String);
+    stream.SeekToExample(6);
+    PackedDataset::Convert(stream, packed_path);
+
+    // The o in the bottom right corner is cell 41, the x in the third
+    // column of the bottom row is cell 37
+    PackedDataset dataset(packed_path);
+    packed_example example = dataset.GetExample(0);
+    REQUIRE(((example.o_mask >> 41) & 1) == 1);
+    REQUIRE(((example.x_mask >> 37) & 1) == 1);
+    REQUIRE((example.x_mask & example.o_mask) == 0);
+    REQUIRE(example.label == 2);
+  }
+
+  SECTION("Reading past the end stops early") {
+    DataStream stream("data/c4_short_database.csv", DataFormat::Numeric);
+    PackedDataset::Convert(stream, packed_path);
+
+    PackedDataset dataset(packed_path);
+    test.YieldTrainingData(dataset, 2, 10);
+    test.YieldTrainingData(dataset, 5, 10);
+    REQUIRE(test.GetTrainLabels().size() == 1);
+    REQUIRE_THROWS_AS(dataset.GetExample(2), std::out_of_range);
+  }
+
+  SECTION("Files that aren't packed datasets throw") {
+    std::ofstream not_packed(packed_path);
+    not_packed << "0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0" << std::endl;
+    not_packed.close();
+
+    REQUIRE_THROWS_AS(PackedDataset{packed_path}, std::invalid_argument);
+    REQUIRE_THROWS_AS(PackedDataset{"data/missing.bin"},
+                      std::invalid_argument);
+  }
+
+  std::remove(packed_path.c_str());
+}
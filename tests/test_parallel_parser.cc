@@ -0,0 +1,103 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+
+#include <core/data_parser.h>
+#include <core/parallel_parser.h>
+#include <core/thread_pool.h>
+
+using connect_four::DataFormat;
+using connect_four::DataParser;
+using connect_four::ParallelParser;
+using connect_four::ThreadPool;
+using connect_four::example_buffer;
+
+// Copies a contiguous buffer into the vector-per-example format DataParser
+// produces, so the two can be compared
+std::vector<tiny_dnn::vec_t> ToVectors(const example_buffer& buffer) {
+  std::vector<tiny_dnn::vec_t> features;
+  for (size_t i = 0; i < buffer.labels.size(); i++) {
+    features.push_back(tiny_dnn::vec_t(
+        buffer.features.begin() + i * ParallelParser::kNumberFeatures,
+        buffer.features.begin() + (i + 1) * ParallelParser::kNumberFeatures));
+  }
+  return features;
+}
+
+TEST_CASE("Thread pool") {
+  SECTION("Runs every task and returns results") {
+    ThreadPool pool(4);
+    REQUIRE(pool.GetNumberThreads() == 4);
+
+    std::atomic<int> count(0);
+    std::vector<std::future<int>> results;
+    for (int task = 0; task < 100; task++) {
+      results.push_back(pool.Submit([task, &count]() {
+        count++;
+        return task * 2;
+      }));
+    }
+    for (int task = 0; task < 100; task++) {
+      REQUIRE(results[task].get() == task * 2);
+    }
+    REQUIRE(count == 100);
+  }
+
+  SECTION("Passes exceptions to the future") {
+    ThreadPool pool(1);
+    std::future<void> result = pool.Submit([]() {
+      throw std::invalid_argument("Task failed");
+    });
+    REQUIRE_THROWS_AS(result.get(), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Parse CSVs in parallel") {
+  ThreadPool pool(4);
+  ParallelParser parser(pool);
+  example_buffer buffer;
+  DataParser expected;
+
+  SECTION("Numeric CSV matches DataParser") {
+    parser.Parse("data/c4_game_database.csv", DataFormat::Numeric, buffer);
+    expected.YieldTrainingDataNumericCSV("data/c4_game_database.csv", 1,
+                                         100000000);
+    REQUIRE(buffer.labels.size() == expected.GetTrainLabels().size());
+    REQUIRE(ToVectors(buffer) == expected.GetTrainFeatures());
+    REQUIRE(buffer.labels == expected.GetTrainLabels());
+  }
+
+  SECTION("String CSV matches DataParser") {
+    parser.Parse("data/connect-4.data", DataFormat::String, buffer);
+    expected.YieldTrainingDataStringCSV("data/connect-4.data", 1, 100000000);
+    REQUIRE(buffer.labels.size() == expected.GetTrainLabels().size());
+    REQUIRE(ToVectors(buffer) == expected.GetTrainFeatures());
+    REQUIRE(buffer.labels == expected.GetTrainLabels());
+  }
+
+  SECTION("Malformed and empty lines are skipped") {
+    std::string csv_path = "data/test_parallel.csv";
+    std::ofstream csv(csv_path, std::ios::binary);
+    csv << "header\r\n";
+    csv << "1,1,1,-1,-1,1,0,-1,-1,-1,1,-1,-1,0,-1,1,1,-1,1,1,0,1,-1,1,-1,-1,"
+           "-1,-1,1,1,-1,-1,1,1,1,-1,1,-1,1,-1,1,-1,-1\r\n";
+    csv << "\r\n";
+    csv << "1,1,not a number\r\n";
+    csv << "0,0,1,1,1,1,0,0,0,1,-1,-1,-1,0,0,0,1,1,1,-1,0,0,0,-1,-1,1,1,-1,"
+           "1,-1,-1,1,-1,-1,1,1,-1,-1,-1,1,1,-1,1";
+    csv.close();
+
+    parser.Parse(csv_path, DataFormat::Numeric, buffer);
+    expected.YieldTrainingDataNumericCSV("data/c4_short_database.csv", 1, 2);
+    REQUIRE(ToVectors(buffer) == expected.GetTrainFeatures());
+    REQUIRE(buffer.labels == expected.GetTrainLabels());
+    std::remove(csv_path.c_str());
+  }
+
+  SECTION("Missing files throw") {
+    REQUIRE_THROWS_AS(parser.Parse("data/missing.csv", DataFormat::Numeric,
+                                   buffer), std::invalid_argument);
+  }
+}
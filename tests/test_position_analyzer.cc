@@ -0,0 +1,185 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <core/position_analyzer.h>
+
+using connect_four::Computer;
+using connect_four::Evaluator;
+using connect_four::GameBoard;
+using connect_four::PositionAnalyzer;
+using connect_four::PositionFormat;
+using connect_four::PositionReader;
+using connect_four::SearchAlgorithm;
+using connect_four::analysis_options;
+using connect_four::analysis_stats;
+using connect_four::search_options;
+using connect_four::search_result;
+
+namespace {
+
+// Splits the output into lines of cells, leaving out the header
+std::vector<std::vector<std::string>> ReadRows(const std::string& text) {
+  std::vector<std::vector<std::string>> rows;
+  std::istringstream lines(text);
+  std::string line;
+  std::getline(lines, line);
+  while (std::getline(lines, line)) {
+    std::vector<std::string> cells;
+    std::istringstream cell_stream(line);
+    std::string cell;
+    while (std::getline(cell_stream, cell, ',')) {
+      cells.push_back(cell);
+    }
+    // A trailing empty cell isn't returned by getline
+    if (!line.empty() && line.back() == ',') {
+      cells.push_back("");
+    }
+    rows.push_back(cells);
+  }
+  return rows;
+}
+
+} // namespace
+
+TEST_CASE("Read positions") {
+  std::string path = "data/test_positions.txt";
+
+  SECTION("Move strings, one per line") {
+    {
+      std::ofstream file(path);
+      file << "33\n\n 42 \r\n";
+    }
+    PositionReader reader(path, PositionFormat::Moves);
+    GameBoard board;
+    REQUIRE(reader.Next(board));
+    REQUIRE(board.GetKey() == GameBoard::FromMoves("33").GetKey());
+    REQUIRE(reader.GetPositionNumber() == 1);
+
+    // A blank line is the empty board
+    REQUIRE(reader.Next(board));
+    REQUIRE(board.GetOccupiedBitboard() == 0);
+
+    REQUIRE(reader.Next(board));
+    REQUIRE(board.GetKey() == GameBoard::FromMoves("42").GetKey());
+    REQUIRE(reader.GetPositionNumber() == 3);
+    REQUIRE_FALSE(reader.Next(board));
+  }
+
+  SECTION("An invalid line throws, and reading goes on after it") {
+    {
+      std::ofstream file(path);
+      file << "39\n3\n";
+    }
+    PositionReader reader(path, PositionFormat::Moves);
+    GameBoard board;
+    REQUIRE_THROWS_AS(reader.Next(board), std::invalid_argument);
+    REQUIRE(reader.Next(board));
+    REQUIRE(reader.GetPositionNumber() == 2);
+  }
+
+  SECTION("A numeric CSV") {
+    {
+      std::ofstream file(path);
+      file << "header\n";
+      GameBoard written = GameBoard::FromMoves("334");
+      for (float feature : written.GenerateVectorFeatures()) {
+        file << static_cast<int>(feature) << ",";
+      }
+      file << "0\n";
+    }
+    PositionReader reader(path, PositionFormat::Numeric);
+    GameBoard board;
+    REQUIRE(reader.Next(board));
+    REQUIRE(board.GetKey() == GameBoard::FromMoves("334").GetKey());
+    REQUIRE_FALSE(reader.Next(board));
+  }
+
+  SECTION("A missing file") {
+    REQUIRE_THROWS_AS(PositionReader("data/missing_positions.txt",
+                                     PositionFormat::Moves),
+                      std::invalid_argument);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Analyze positions") {
+  std::string path = "data/test_analyze.txt";
+  {
+    std::ofstream file(path);
+    file << "33\n\nnot moves\n0101010\n3342\n";
+  }
+
+  analysis_options options;
+  options.depth = 4;
+  options.number_threads = 2;
+  options.batch_size = 2;
+
+  SECTION("Each valid position gets a line, in input order") {
+    PositionReader reader(path, PositionFormat::Moves);
+    std::ostringstream output;
+    PositionAnalyzer analyzer(options);
+    analysis_stats stats = analyzer.Run(reader, output);
+    REQUIRE(stats.positions == 4);
+    REQUIRE(stats.positions_skipped == 1);
+
+    REQUIRE(output.str().compare(0, 39,
+                                 "position,best_move,score,depth,nodes,pv") ==
+            0);
+    std::vector<std::vector<std::string>> rows = ReadRows(output.str());
+    REQUIRE(rows.size() == 4);
+    REQUIRE(rows[0][0] == "1");
+    REQUIRE(rows[1][0] == "2");
+    REQUIRE(rows[2][0] == "4");
+    REQUIRE(rows[3][0] == "5");
+
+    // A finished game has no move
+    REQUIRE(rows[2][1] == "none");
+    REQUIRE(rows[2][5].empty());
+
+    // Results match searching one position at a time
+    Computer computer;
+    const std::vector<std::string> kMoves = {"33", "", "", "3342"};
+    for (size_t index : {0, 1, 3}) {
+      search_result expected = computer.Search(
+          GameBoard::FromMoves(kMoves[index]),
+          search_options(4, SearchAlgorithm::PrincipalVariation,
+                         Evaluator::Threats));
+      REQUIRE(rows[index][1] == std::to_string(expected.column));
+      REQUIRE(rows[index][3] == "4");
+      REQUIRE(rows[index][4] == std::to_string(expected.nodes));
+      REQUIRE(rows[index][5].size() == expected.principal_variation.size());
+      REQUIRE(rows[index][5][0] == static_cast<char>('0' + expected.column));
+    }
+  }
+
+  SECTION("A time limit cuts searches short") {
+    options.depth = 0;
+    options.move_time_ms = 20;
+    PositionReader reader(path, PositionFormat::Moves);
+    std::ostringstream output;
+    analysis_stats stats = PositionAnalyzer(options).Run(reader, output);
+    REQUIRE(stats.positions == 4);
+    REQUIRE(stats.seconds < 10);
+
+    std::vector<std::vector<std::string>> rows = ReadRows(output.str());
+    REQUIRE(std::stoul(rows[0][3]) >= 1);
+    REQUIRE(std::stoul(rows[0][3]) < 40);
+  }
+
+  SECTION("Positions per second need a measured time") {
+    analysis_stats stats;
+    stats.positions = 10;
+    REQUIRE(stats.CalculatePositionsPerSecond() == 0);
+    stats.seconds = 2;
+    REQUIRE(stats.CalculatePositionsPerSecond() == Approx(5));
+  }
+
+  std::remove(path.c_str());
+}
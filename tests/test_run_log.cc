@@ -0,0 +1,63 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <core/run_log.h>
+
+using connect_four::RunLog;
+using connect_four::epoch_record;
+using connect_four::step_record;
+
+TEST_CASE("Write a training run log") {
+  std::string log_path = "data/test_run_log.jsonl";
+
+  SECTION("Steps and epochs are written one per line") {
+    {
+      RunLog run_log(log_path);
+      step_record step;
+      step.epoch = 1;
+      step.step = 2;
+      step.examples = 100;
+      step.train_seconds = 0.5;
+      step.loss = 0.25f;
+      run_log.LogStep(step);
+
+      epoch_record epoch;
+      epoch.epoch = 1;
+      epoch.test_accuracy = 75;
+      run_log.LogEpoch(epoch);
+    }
+
+    std::ifstream log(log_path);
+    std::string step_line;
+    std::string epoch_line;
+    std::string extra_line;
+    REQUIRE(std::getline(log, step_line));
+    REQUIRE(std::getline(log, epoch_line));
+    REQUIRE_FALSE(std::getline(log, extra_line));
+
+    REQUIRE(step_line.front() == '{');
+    REQUIRE(step_line.back() == '}');
+    REQUIRE(step_line.find("\"type\":\"step\"") != std::string::npos);
+    REQUIRE(step_line.find("\"step\":2") != std::string::npos);
+    REQUIRE(step_line.find("\"examples_per_sec\":200") != std::string::npos);
+    REQUIRE(step_line.find("\"loss\":0.25") != std::string::npos);
+    REQUIRE(step_line.find("\"elapsed_seconds\":") != std::string::npos);
+
+    REQUIRE(epoch_line.find("\"type\":\"epoch\"") != std::string::npos);
+    REQUIRE(epoch_line.find("\"test_accuracy\":75") != std::string::npos);
+    REQUIRE(epoch_line.find("\"peak_rss_bytes\":") != std::string::npos);
+    std::remove(log_path.c_str());
+  }
+
+  SECTION("Peak memory is reported") {
+    REQUIRE(RunLog::GetPeakMemoryBytes() > 0);
+  }
+
+  SECTION("Unwritable paths throw") {
+    REQUIRE_THROWS_AS(RunLog("missing_directory/log.jsonl"),
+                      std::invalid_argument);
+  }
+}
@@ -0,0 +1,52 @@
+#include <catch2/catch.hpp>
+
+#include <core/search_bench.h>
+
+using connect_four::BoardState;
+using connect_four::Computer;
+using connect_four::GameBoard;
+using connect_four::SearchAlgorithm;
+using connect_four::SearchBench;
+using connect_four::bench_result;
+
+TEST_CASE("Bench the search on fixed positions") {
+  Computer computer;
+
+  SECTION("Every position is a game in progress") {
+    for (const std::string& moves : SearchBench::GetPositions()) {
+      GameBoard board = GameBoard::FromMoves(moves);
+      REQUIRE(board.GetGameState() == BoardState::InProgress);
+    }
+  }
+
+  SECTION("Every position is searched") {
+    bench_result result = SearchBench(3).Run(computer);
+    REQUIRE(result.positions == SearchBench::GetPositions().size());
+    REQUIRE(result.nodes > result.positions);
+  }
+
+  SECTION("The node count is the same on every run") {
+    SearchBench bench(4);
+    size_t nodes = bench.Run(computer).nodes;
+    REQUIRE(bench.Run(computer).nodes == nodes);
+
+    // Nothing carries over from earlier searches
+    Computer fresh_computer;
+    REQUIRE(bench.Run(fresh_computer).nodes == nodes);
+  }
+
+  SECTION("A different search has a different node count") {
+    size_t shallow_nodes = SearchBench(3).Run(computer).nodes;
+    REQUIRE(SearchBench(4).Run(computer).nodes != shallow_nodes);
+    REQUIRE(SearchBench(4, SearchAlgorithm::AlphaBeta).Run(computer).nodes !=
+            SearchBench(4).Run(computer).nodes);
+  }
+
+  SECTION("Nodes per second need a measured time") {
+    bench_result result;
+    result.nodes = 100;
+    REQUIRE(result.CalculateNodesPerSecond() == 0);
+    result.seconds = 0.5;
+    REQUIRE(result.CalculateNodesPerSecond() == Approx(200));
+  }
+}
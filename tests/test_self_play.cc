@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <random>
+
+#include <core/packed_dataset.h>
+#include <core/self_play.h>
+
+using connect_four::BoardState;
+using connect_four::Computer;
+using connect_four::GameBoard;
+using connect_four::PackedDataset;
+using connect_four::SelfPlay;
+using connect_four::self_play_options;
+using connect_four::self_play_stats;
+
+TEST_CASE("Self-play games") {
+  self_play_options options;
+  options.number_games = 4;
+  options.depth = 2;
+  options.number_threads = 2;
+  SelfPlay self_play(options);
+
+  SECTION("A game is played to the end") {
+    Computer computer;
+    std::mt19937 random(0);
+    std::vector<GameBoard> positions;
+    BoardState result = self_play.PlayGame(computer, random, positions);
+
+    REQUIRE(result != BoardState::InProgress);
+    REQUIRE(positions.back().GetGameState() == result);
+    REQUIRE(positions.size() <= GameBoard::kWidth * GameBoard::kHeight);
+  }
+
+  SECTION("The same seed plays the same game") {
+    Computer computer;
+    std::mt19937 first_random(3);
+    std::mt19937 second_random(3);
+    std::vector<GameBoard> first_positions;
+    std::vector<GameBoard> second_positions;
+    self_play.PlayGame(computer, first_random, first_positions);
+    self_play.PlayGame(computer, second_random, second_positions);
+
+    REQUIRE(first_positions.size() == second_positions.size());
+    REQUIRE(first_positions.back().GetKey() ==
+            second_positions.back().GetKey());
+  }
+
+  SECTION("A winning move is always taken") {
+    // X has three in the bottom row and no noise can outweigh a win
+    Computer computer;
+    std::mt19937 random(0);
+    GameBoard board;
+    for (size_t col : {0, 0, 1, 1, 2, 2}) {
+      board.DropPiece(col);
+    }
+    REQUIRE(self_play.ChooseMove(computer, board, random) == 3);
+  }
+
+  SECTION("Every position is written to the shards") {
+    self_play_stats stats = self_play.Run("data/test_self_play");
+    REQUIRE(stats.games == 4);
+    REQUIRE(stats.x_wins + stats.draws + stats.o_wins == 4);
+
+    size_t positions = 0;
+    for (size_t shard = 0; shard < 2; shard++) {
+      std::string path = SelfPlay::GetShardPath("data/test_self_play", shard);
+      {
+        PackedDataset dataset(path);
+        positions += dataset.GetNumberExamples();
+      }
+      std::remove(path.c_str());
+    }
+    REQUIRE(positions == stats.positions);
+  }
+}
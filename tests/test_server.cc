@@ -0,0 +1,271 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <core/load_generator.h>
+#include <core/server.h>
+#include <core/socket.h>
+
+using connect_four::Evaluator;
+using connect_four::LatencyRecorder;
+using connect_four::LoadGenerator;
+using connect_four::Server;
+using connect_four::Socket;
+using connect_four::load_options;
+using connect_four::load_stats;
+using connect_four::server_options;
+using connect_four::server_stats;
+
+namespace {
+
+server_options CreateOptions() {
+  server_options options;
+  // Port 0 picks a free port
+  options.address = "tcp:0";
+  options.number_threads = 2;
+  options.evaluator = Evaluator::Threats;
+  options.table_size_log2 = 12;
+  return options;
+}
+
+// Reads lines until one that isn't an info line
+std::string ReadReply(Socket& socket) {
+  std::string line;
+  while (socket.ReadLine(line)) {
+    if (line.compare(0, 5, "info ") != 0) {
+      return line;
+    }
+  }
+  return "";
+}
+
+} // namespace
+
+TEST_CASE("Latency percentiles") {
+  LatencyRecorder recorder(100);
+  REQUIRE(recorder.CalculatePercentile(50) == 0);
+
+  for (size_t latency = 1; latency <= 100; latency++) {
+    recorder.Record(static_cast<double>(latency));
+  }
+  REQUIRE(recorder.CalculatePercentile(50) == 50);
+  REQUIRE(recorder.CalculatePercentile(99) == 99);
+  REQUIRE(recorder.CalculatePercentile(100) == 100);
+  REQUIRE(recorder.CalculatePercentile(0) == 1);
+
+  // Only the most recent latencies are kept
+  for (size_t latency = 0; latency < 100; latency++) {
+    recorder.Record(1000);
+  }
+  REQUIRE(recorder.CalculatePercentile(1) == 1000);
+  REQUIRE(recorder.GetNumberRecorded() == 200);
+}
+
+TEST_CASE("Sockets") {
+  SECTION("Lines go both ways over TCP") {
+    Socket listener = Socket::Listen("tcp:0");
+    std::string address = listener.GetAddress();
+    REQUIRE(address.compare(0, 4, "tcp:") == 0);
+    REQUIRE(address != "tcp:0");
+
+    Socket client = Socket::Connect(address);
+    Socket connection = listener.Accept();
+    REQUIRE(client.WriteLine("one\r"));
+    REQUIRE(client.WriteLine("two"));
+    std::string line;
+    REQUIRE(connection.ReadLine(line));
+    REQUIRE(line == "one");
+    REQUIRE(connection.ReadLine(line));
+    REQUIRE(line == "two");
+
+    client.Shutdown();
+    REQUIRE_FALSE(connection.ReadLine(line));
+  }
+
+  SECTION("Addresses that can't be used") {
+    REQUIRE_THROWS_AS(Socket::Listen("localhost"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Socket::Listen("tcp:port"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Socket::Connect("unix:data/missing.sock"),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("Serve sessions") {
+  server_options options = CreateOptions();
+
+  SECTION("A session plays over TCP") {
+    Server server(options);
+    server.Start();
+    Socket socket = Socket::Connect(server.GetAddress());
+
+    REQUIRE(socket.WriteLine("isready"));
+    REQUIRE(ReadReply(socket) == "readyok");
+
+    socket.WriteLine("position 33");
+    socket.WriteLine("go depth 4");
+    std::string line;
+    REQUIRE(socket.ReadLine(line));
+    REQUIRE(line.compare(0, 13, "info depth 4 ") == 0);
+    REQUIRE(socket.ReadLine(line));
+    REQUIRE(line.compare(0, 9, "bestmove ") == 0);
+
+    // A finished game has no move
+    socket.WriteLine("position 0101010");
+    socket.WriteLine("go");
+    REQUIRE(ReadReply(socket) == "bestmove none");
+
+    socket.WriteLine("go nodes 10");
+    REQUIRE(socket.ReadLine(line));
+    REQUIRE(line.compare(0, 12, "info string ") == 0);
+
+    socket.WriteLine("stats");
+    REQUIRE(ReadReply(socket).compare(0, 25, "stats sessions 1 queue 0 ") ==
+            0);
+    server_stats stats = server.GetStats();
+    REQUIRE(stats.completed_searches == 1);
+    REQUIRE(stats.tables == 1);
+    REQUIRE(stats.latency_p50_ms > 0);
+    server.Stop();
+  }
+
+  SECTION("A session plays over a Unix socket") {
+    options.address = "unix:data/test_server.sock";
+    Server server(options);
+    server.Start();
+    REQUIRE(server.GetAddress() == options.address);
+
+    Socket socket = Socket::Connect(options.address);
+    socket.WriteLine("position 3");
+    socket.WriteLine("go depth 2");
+    REQUIRE(ReadReply(socket).compare(0, 9, "bestmove ") == 0);
+  }
+
+  SECTION("A time budget cuts a search short") {
+    Server server(options);
+    server.Start();
+    Socket socket = Socket::Connect(server.GetAddress());
+
+    auto start = std::chrono::steady_clock::now();
+    socket.WriteLine("go movetime 50");
+    REQUIRE(ReadReply(socket).compare(0, 9, "bestmove ") == 0);
+    REQUIRE(std::chrono::steady_clock::now() - start <
+            std::chrono::seconds(5));
+  }
+
+  SECTION("Searches beyond the queue are turned away") {
+    options.number_threads = 1;
+    options.max_queue_depth = 0;
+    Server server(options);
+    server.Start();
+
+    // The first search holds the only thread for its whole budget
+    Socket first = Socket::Connect(server.GetAddress());
+    first.WriteLine("go movetime 500");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    Socket second = Socket::Connect(server.GetAddress());
+    second.WriteLine("go movetime 500");
+    REQUIRE(ReadReply(second) == "busy");
+    REQUIRE(ReadReply(first).compare(0, 9, "bestmove ") == 0);
+    REQUIRE(server.GetStats().rejected_searches == 1);
+  }
+
+  SECTION("Sessions beyond the limit are turned away") {
+    options.max_sessions = 1;
+    Server server(options);
+    server.Start();
+
+    Socket first = Socket::Connect(server.GetAddress());
+    first.WriteLine("isready");
+    REQUIRE(ReadReply(first) == "readyok");
+
+    Socket second = Socket::Connect(server.GetAddress());
+    REQUIRE(ReadReply(second) == "busy");
+    std::string line;
+    REQUIRE_FALSE(second.ReadLine(line));
+  }
+
+  SECTION("The least recently used table is evicted") {
+    options.max_tables = 1;
+    Server server(options);
+    server.Start();
+
+    Socket first = Socket::Connect(server.GetAddress());
+    Socket second = Socket::Connect(server.GetAddress());
+    for (Socket* socket : {&first, &second, &first}) {
+      socket->WriteLine("go depth 3");
+      REQUIRE(ReadReply(*socket).compare(0, 9, "bestmove ") == 0);
+    }
+    server_stats stats = server.GetStats();
+    REQUIRE(stats.tables == 1);
+    REQUIRE(stats.evicted_tables == 2);
+
+    // Closing a session frees its table
+    first.WriteLine("quit");
+    std::string line;
+    REQUIRE_FALSE(first.ReadLine(line));
+    REQUIRE(server.GetStats().tables == 0);
+  }
+
+  SECTION("Sessions without a table search with a fallback one") {
+    options.max_tables = 0;
+    Server server(options);
+    server.Start();
+
+    Socket socket = Socket::Connect(server.GetAddress());
+    for (size_t search = 0; search < 2; search++) {
+      socket.WriteLine("go depth 3");
+      REQUIRE(ReadReply(socket).compare(0, 9, "bestmove ") == 0);
+    }
+    REQUIRE(server.GetStats().tables == 0);
+  }
+
+  SECTION("Load from many sessions") {
+    options.max_queue_depth = 64;
+    Server server(options);
+    server.Start();
+
+    load_options load;
+    load.address = server.GetAddress();
+    load.number_sessions = 4;
+    load.games_per_session = 1;
+    load.depth = 3;
+    load_stats stats = LoadGenerator(load).Run();
+    REQUIRE(stats.games == 4);
+    REQUIRE(stats.rejected_requests == 0);
+    REQUIRE(stats.requests >= 4 * 7);
+    REQUIRE(stats.latency_p50_ms <= stats.latency_p99_ms);
+    REQUIRE(stats.latency_p99_ms <= stats.latency_max_ms);
+    REQUIRE(server.GetStats().completed_searches == stats.requests);
+  }
+
+  SECTION("Load sessions reconnect when turned away") {
+    options.max_sessions = 1;
+    Server server(options);
+    server.Start();
+
+    // Holds the only session until the load has been refused a while
+    Socket held = Socket::Connect(server.GetAddress());
+    held.WriteLine("isready");
+    REQUIRE(ReadReply(held) == "readyok");
+
+    load_options load;
+    load.address = server.GetAddress();
+    load.number_sessions = 2;
+    load.games_per_session = 1;
+    load.depth = 2;
+    std::future<load_stats> result = std::async(std::launch::async, [&]() {
+      return LoadGenerator(load).Run();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    held.WriteLine("quit");
+
+    load_stats stats = result.get();
+    REQUIRE(stats.games == 2);
+    REQUIRE(stats.refused_connections >= 2);
+  }
+}
@@ -0,0 +1,219 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include <core/data_parser.h>
+#include <core/solver.h>
+
+using connect_four::BoardState;
+using connect_four::DataFormat;
+using connect_four::DataParser;
+using connect_four::DataStream;
+using connect_four::DatasetSolver;
+using connect_four::GameBoard;
+using connect_four::SharedTranspositionTable;
+using connect_four::Solver;
+using connect_four::dataset_solver_options;
+using connect_four::dataset_solver_stats;
+using connect_four::solve_result;
+
+namespace {
+
+// Plays every line to the end without any pruning, scoring positions the
+// same way as Solver
+int ReferenceScore(const GameBoard& board, int number_moves) {
+  int best = -Solver::kNumberCells;
+  for (size_t col : board.CalculateValidColumns()) {
+    GameBoard child = board;
+    child.DropPiece(col);
+
+    int score;
+    if (child.GetGameState() == BoardState::Tie) {
+      score = 0;
+    } else if (child.GetGameState() != BoardState::InProgress) {
+      score = (Solver::kNumberCells + 1 - number_moves) / 2;
+    } else {
+      score = -ReferenceScore(child, number_moves + 1);
+    }
+    best = std::max(best, score);
+  }
+  return best;
+}
+
+// Plays random moves until the board has the given number of pieces,
+// returning false if the game ends first
+bool PlayRandomMoves(GameBoard& board, size_t number_moves,
+                     std::mt19937& random) {
+  for (size_t move = 0; move < number_moves; move++) {
+    std::vector<size_t> columns;
+    for (size_t col : board.CalculateValidColumns()) {
+      columns.push_back(col);
+    }
+    if (columns.empty()) {
+      return false;
+    }
+    board.DropPiece(columns[random() % columns.size()]);
+  }
+  return board.GetGameState() == BoardState::InProgress;
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+} // namespace
+
+TEST_CASE("Solve positions exactly") {
+  SharedTranspositionTable table(16);
+  Solver solver(table);
+
+  SECTION("An immediate win") {
+    GameBoard board;
+    for (size_t col : {0, 0, 1, 1, 2, 2}) {
+      board.DropPiece(col);
+    }
+
+    solve_result result = solver.Solve(board);
+    REQUIRE(result.score == 18);
+    REQUIRE(result.depth == 1);
+    REQUIRE(result.outcome == BoardState::Xwins);
+  }
+
+  SECTION("A double threat loses in two plies") {
+    // X threatens both ends of the bottom row and O can only block one
+    GameBoard board;
+    for (size_t col : {2, 2, 3, 3, 4}) {
+      board.DropPiece(col);
+    }
+    REQUIRE(board.GetIsXTurn() == false);
+
+    solve_result result = solver.Solve(board);
+    REQUIRE(result.score < 0);
+    REQUIRE(result.depth == 2);
+    REQUIRE(result.outcome == BoardState::Xwins);
+  }
+
+  SECTION("A finished game has depth 0") {
+    GameBoard board;
+    for (size_t col : {0, 1, 0, 1, 0, 1, 0}) {
+      board.DropPiece(col);
+    }
+
+    solve_result result = solver.Solve(board);
+    REQUIRE(result.depth == 0);
+    REQUIRE(result.outcome == BoardState::Xwins);
+  }
+
+  SECTION("Scores match a search without pruning") {
+    std::mt19937 random(7);
+    size_t checked = 0;
+    while (checked < 20) {
+      GameBoard board;
+      if (!PlayRandomMoves(board, 34, random) ||
+          board.CalculateWinningMoves(board.GetIsXTurn()) != 0) {
+        continue;
+      }
+
+      solve_result result = solver.Solve(board);
+      REQUIRE(result.score == ReferenceScore(board, 34));
+      checked++;
+    }
+  }
+
+  SECTION("Depth follows from the score") {
+    REQUIRE(Solver::CalculateDepth(0, 30) == 12);
+    // Winning with the next piece
+    REQUIRE(Solver::CalculateDepth(18, 6) == 1);
+    REQUIRE(Solver::CalculateDepth(18, 7) == 1);
+    // Losing to the opponent's next piece
+    REQUIRE(Solver::CalculateDepth(-18, 6) == 2);
+  }
+}
+
+TEST_CASE("Solve a dataset") {
+  std::string csv_path = "data/test_solve.csv";
+  std::string output_path = "data/test_solve_output.csv";
+  std::string checkpoint_path = DatasetSolver::GetCheckpointPath(output_path);
+  std::remove(checkpoint_path.c_str());
+
+  // Three late positions, labeled wrongly on purpose
+  std::mt19937 random(3);
+  std::ofstream csv(csv_path);
+  csv << "header" << std::endl;
+  size_t written = 0;
+  while (written < 3) {
+    GameBoard board;
+    if (!PlayRandomMoves(board, 30, random)) {
+      continue;
+    }
+    for (float feature : board.GenerateVectorFeatures()) {
+      csv << static_cast<int>(feature) << ",";
+    }
+    csv << "0" << std::endl;
+    written++;
+  }
+  csv.close();
+
+  dataset_solver_options options;
+  options.number_threads = 2;
+  options.table_size_log2 = 16;
+  options.batch_size = 1;
+
+  SECTION("Every position is labeled with its exact result") {
+    DataStream stream(csv_path, DataFormat::Numeric);
+    DatasetSolver dataset_solver(options);
+    dataset_solver_stats stats = dataset_solver.Run(stream, output_path);
+    REQUIRE(stats.examples_solved == 3);
+    REQUIRE(stats.examples_skipped == 0);
+
+    DataParser parser;
+    DataStream output(output_path, DataFormat::Numeric);
+    parser.YieldTrainingData(output, 10);
+    REQUIRE(parser.GetTrainLabels().size() == 3);
+
+    SharedTranspositionTable table(16);
+    Solver solver(table);
+    for (size_t index = 0; index < 3; index++) {
+      GameBoard board = DatasetSolver::CreateBoard(
+          parser.GetTrainFeatures()[index].data());
+      solve_result result = solver.Solve(board);
+      size_t label = result.outcome == BoardState::Xwins ? 2
+                     : result.outcome == BoardState::Owins ? 0 : 1;
+      REQUIRE(parser.GetTrainLabels()[index] == label);
+    }
+  }
+
+  SECTION("An interrupted run resumes from its checkpoint") {
+    DataStream stream(csv_path, DataFormat::Numeric);
+    DatasetSolver(options).Run(stream, output_path);
+    std::string expected = ReadFile(output_path);
+
+    // Pretend the run stopped partway through the second example
+    size_t first_line_end = expected.find('\n', expected.find('\n') + 1) + 1;
+    {
+      std::ofstream checkpoint(checkpoint_path);
+      checkpoint << 2 << " " << first_line_end << std::endl;
+      std::fstream output(output_path, std::ios::in | std::ios::out |
+                                       std::ios::binary);
+      output.seekp(first_line_end);
+      output << "garbage";
+    }
+
+    DataStream resumed_stream(csv_path, DataFormat::Numeric);
+    dataset_solver_stats stats = DatasetSolver(options).Run(resumed_stream,
+                                                            output_path);
+    REQUIRE(stats.first_example == 2);
+    REQUIRE(stats.examples_solved == 2);
+    REQUIRE(ReadFile(output_path) == expected);
+  }
+
+  std::remove(csv_path.c_str());
+  std::remove(output_path.c_str());
+  std::remove(checkpoint_path.c_str());
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+
+#include <core/threat_evaluator.h>
+
+using connect_four::GameBoard;
+using connect_four::ThreatEvaluator;
+using std::vector;
+
+TEST_CASE("Threat evaluator scores symmetric positions as even") {
+  ThreatEvaluator evaluator;
+
+  SECTION("Empty board is even") {
+    GameBoard empty;
+    REQUIRE(evaluator.EvaluateBoard(empty, true) == 0);
+    REQUIRE(evaluator.EvaluateBoard(empty, false) == 0);
+  }
+
+  SECTION("Mirrored pieces in the center are even") {
+    GameBoard test;
+    test.DropPiece(3);
+    test.DropPiece(3);
+    REQUIRE(evaluator.EvaluateBoard(test, true) == 0);
+  }
+}
+
+TEST_CASE("Threat evaluator rewards features") {
+  ThreatEvaluator evaluator;
+
+  SECTION("Center control favors the player in the center") {
+    GameBoard test;
+    test.DropPiece(3);
+    REQUIRE(evaluator.EvaluateBoard(test, true) > 0);
+    REQUIRE(evaluator.EvaluateBoard(test, false) ==
+            -evaluator.EvaluateBoard(test, true));
+  }
+
+  SECTION("Open three favors its owner") {
+    vector<vector<int>> valid = {   {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {-1, 1, 1, 0, 1, -1, -1}};
+    GameBoard test(valid, true);
+    REQUIRE(evaluator.EvaluateBoard(test, true) > 0);
+  }
+
+  SECTION("First player's threat on an odd row beats one on an even row") {
+    // X threatens the empty cell in the third row of column 3
+    vector<vector<int>> odd = {   {0, 0, 0, 0, 0, 0, 0},
+                                  {0, 0, 0, 0, 0, 0, 0},
+                                  {0, 0, 0, 0, 0, 0, 0},
+                                  {1, 1, 1, 0, 0, 0, 0},
+                                  {-1, -1, 1, 0, 0, 0, 0},
+                                  {1, -1, -1, 0, 0, 0, -1}};
+    // X threatens the empty cell in the second row of column 3
+    vector<vector<int>> even = {   {0, 0, 0, 0, 0, 0, 0},
+                                   {0, 0, 0, 0, 0, 0, 0},
+                                   {0, 0, 0, 0, 0, 0, 0},
+                                   {0, 0, 0, 0, 0, 0, 0},
+                                   {1, 1, 1, 0, 0, 0, 0},
+                                   {-1, -1, 1, 0, 0, 0, -1}};
+    GameBoard odd_board(odd, true);
+    GameBoard even_board(even, false);
+    REQUIRE(evaluator.EvaluateBoard(odd_board, true) > 0);
+    REQUIRE(evaluator.EvaluateBoard(even_board, true) > 0);
+    REQUIRE(evaluator.EvaluateBoard(odd_board, true) >
+            evaluator.EvaluateBoard(even_board, true));
+  }
+
+  SECTION("Scores stay inside the network's range") {
+    vector<vector<int>> valid = {   {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 0, 0, 0, 0, 0, 0},
+                                    {0, 1, 0, 1, 0, 1, 0},
+                                    {0, 1, -1, 1, -1, 1, 0},
+                                    {-1, 1, -1, 1, -1, -1, 0},
+                                    {-1, -1, 1, -1, 1, -1, 1}};
+    GameBoard test(valid, false);
+    float score = evaluator.EvaluateBoard(test, true);
+    REQUIRE(score > -1);
+    REQUIRE(score < 1);
+  }
+}
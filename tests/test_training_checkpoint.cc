@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <core/persistent_adam.h>
+#include <core/training_checkpoint.h>
+
+using connect_four::PersistentAdam;
+using connect_four::TrainingCheckpoint;
+using connect_four::training_state;
+
+namespace {
+
+tiny_dnn::network<tiny_dnn::sequential> CreateNetwork() {
+  tiny_dnn::network<tiny_dnn::sequential> net;
+  net << tiny_dnn::fully_connected_layer(42, 8) << tiny_dnn::relu()
+      << tiny_dnn::fully_connected_layer(8, 3) << tiny_dnn::softmax();
+  return net;
+}
+
+// Trains a few steps so the optimizer has estimates to save
+void TrainBriefly(tiny_dnn::network<tiny_dnn::sequential>& net,
+                  PersistentAdam& optimizer) {
+  std::vector<tiny_dnn::vec_t> features(4, tiny_dnn::vec_t(42, 0));
+  std::vector<tiny_dnn::label_t> labels = {0, 1, 2, 1};
+  features[0][3] = 1;
+  features[1][10] = -1;
+  net.train<tiny_dnn::cross_entropy>(optimizer, features, labels, 2, 1);
+}
+
+void RemoveCheckpoint(const std::string& path) {
+  std::remove(path.c_str());
+  std::remove((path + ".model0").c_str());
+  std::remove((path + ".model1").c_str());
+}
+
+} // namespace
+
+TEST_CASE("Persistent Adam state") {
+  tiny_dnn::network<tiny_dnn::sequential> net = CreateNetwork();
+  PersistentAdam optimizer;
+  optimizer.alpha = 0.005f;
+  TrainBriefly(net, optimizer);
+
+  SECTION("Saved state loads back the same") {
+    std::stringstream saved;
+    optimizer.SaveState(saved, net);
+
+    PersistentAdam restored;
+    restored.LoadState(saved, net);
+    REQUIRE(restored.alpha == 0.005f);
+    REQUIRE(restored.b1_t == optimizer.b1_t);
+    REQUIRE(restored.b2_t == optimizer.b2_t);
+
+    std::stringstream resaved;
+    restored.SaveState(resaved, net);
+    REQUIRE(resaved.str() == saved.str());
+  }
+
+  SECTION("Cut short state throws") {
+    std::stringstream saved;
+    optimizer.SaveState(saved, net);
+    std::string contents = saved.str();
+    std::stringstream truncated(contents.substr(0, contents.size() / 2));
+
+    PersistentAdam restored;
+    REQUIRE_THROWS_AS(restored.LoadState(truncated, net),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("Training checkpoints") {
+  std::string path = "data/test_checkpoint";
+  RemoveCheckpoint(path);
+  tiny_dnn::network<tiny_dnn::sequential> net = CreateNetwork();
+  PersistentAdam optimizer;
+  TrainBriefly(net, optimizer);
+
+  training_state state;
+  state.epoch = 2;
+  state.position = 4096;
+  state.batch_size = 64;
+  state.seed = 1234;
+  state.is_mirrored = true;
+  state.best_accuracy = 81.5f;
+
+  SECTION("No checkpoint to load") {
+    TrainingCheckpoint checkpoint(path);
+    training_state loaded;
+    REQUIRE_FALSE(checkpoint.Load(net, optimizer, loaded));
+  }
+
+  SECTION("The state is restored") {
+    TrainingCheckpoint(path).Save(net, optimizer, state);
+
+    tiny_dnn::network<tiny_dnn::sequential> restored_net = CreateNetwork();
+    PersistentAdam restored_optimizer;
+    training_state loaded;
+    REQUIRE(TrainingCheckpoint(path).Load(restored_net, restored_optimizer,
+                                          loaded));
+    REQUIRE(loaded.epoch == 2);
+    REQUIRE(loaded.position == 4096);
+    REQUIRE(loaded.batch_size == 64);
+    REQUIRE(loaded.seed == 1234);
+    REQUIRE(loaded.is_mirrored);
+    REQUIRE(loaded.best_accuracy == 81.5f);
+  }
+
+  SECTION("The sampler settings are restored as saved") {
+    state.seed = 7;
+    state.is_mirrored = false;
+    TrainingCheckpoint(path).Save(net, optimizer, state);
+
+    training_state loaded;
+    loaded.seed = 99;
+    loaded.is_mirrored = true;
+    REQUIRE(TrainingCheckpoint(path).Load(net, optimizer, loaded));
+    REQUIRE(loaded.seed == 7);
+    REQUIRE_FALSE(loaded.is_mirrored);
+    REQUIRE(loaded.position == 4096);
+  }
+
+  SECTION("Model files are used in turn") {
+    TrainingCheckpoint checkpoint(path);
+    checkpoint.Save(net, optimizer, state);
+    REQUIRE(std::ifstream(path + ".model1").good());
+    REQUIRE_FALSE(std::ifstream(path + ".model0").good());
+
+    // A new writer continues from the saved generation
+    TrainingCheckpoint(path).Save(net, optimizer, state);
+    REQUIRE(std::ifstream(path + ".model0").good());
+  }
+
+  SECTION("Other files aren't loaded") {
+    std::ofstream(path) << "not a checkpoint";
+    training_state loaded;
+    REQUIRE_THROWS_AS(TrainingCheckpoint(path).Load(net, optimizer, loaded),
+                      std::invalid_argument);
+  }
+
+  RemoveCheckpoint(path);
+}
@@ -0,0 +1,114 @@
+#include <catch2/catch.hpp>
+
+#include <core/gameboard.h>
+#include <core/transposition_table.h>
+
+using connect_four::GameBoard;
+using connect_four::SharedTranspositionTable;
+using connect_four::TranspositionTable;
+using connect_four::solved_bounds;
+using connect_four::table_entry;
+
+TEST_CASE("Transposition table stores and finds entries") {
+  TranspositionTable table(10);
+  GameBoard board;
+  board.DropPiece(3);
+
+  table_entry entry;
+  entry.key = board.GetKey();
+  entry.lower_bound = -0.5f;
+  entry.upper_bound = 0.25f;
+  entry.depth = 4;
+  entry.column = 2;
+
+  SECTION("Empty table finds nothing") {
+    table_entry found;
+    REQUIRE(table.GetCapacity() == 1024);
+    REQUIRE_FALSE(table.Probe(entry.key, found));
+  }
+
+  SECTION("Stored entry is found with the same values") {
+    table.Store(entry);
+
+    table_entry found;
+    REQUIRE(table.Probe(entry.key, found));
+    REQUIRE(found.key == entry.key);
+    REQUIRE(found.lower_bound == entry.lower_bound);
+    REQUIRE(found.upper_bound == entry.upper_bound);
+    REQUIRE(found.depth == 4);
+    REQUIRE(found.column == 2);
+  }
+
+  SECTION("Other positions are not found") {
+    table.Store(entry);
+    board.DropPiece(3);
+
+    table_entry found;
+    REQUIRE_FALSE(table.Probe(board.GetKey(), found));
+  }
+
+  SECTION("Clearing removes entries") {
+    table.Store(entry);
+    table.Clear();
+
+    table_entry found;
+    REQUIRE_FALSE(table.Probe(entry.key, found));
+  }
+
+  SECTION("Entries stored after clearing are found") {
+    table.Store(entry);
+    table.Clear();
+    table.Store(entry);
+
+    table_entry found;
+    REQUIRE(table.Probe(entry.key, found));
+    REQUIRE(found.depth == 4);
+  }
+
+  SECTION("Entries stay removed once the generation wraps around") {
+    table.Store(entry);
+    for (size_t clear = 0; clear < 256; clear++) {
+      table.Clear();
+    }
+
+    table_entry found;
+    REQUIRE_FALSE(table.Probe(entry.key, found));
+  }
+}
+
+TEST_CASE("Shared transposition table stores and finds bounds") {
+  SharedTranspositionTable table(10);
+  GameBoard board;
+  board.DropPiece(3);
+
+  SECTION("Empty table finds nothing") {
+    solved_bounds found;
+    REQUIRE(table.GetCapacity() == 1024);
+    REQUIRE_FALSE(table.Probe(board.GetKey(), found));
+  }
+
+  SECTION("Stored bounds are found, including negative ones") {
+    table.Store(board.GetKey(), solved_bounds(-18, 5));
+
+    solved_bounds found;
+    REQUIRE(table.Probe(board.GetKey(), found));
+    REQUIRE(found.lower_bound == -18);
+    REQUIRE(found.upper_bound == 5);
+  }
+
+  SECTION("Other positions are not found") {
+    table.Store(board.GetKey(), solved_bounds(0, 1));
+    board.DropPiece(3);
+
+    solved_bounds found;
+    REQUIRE_FALSE(table.Probe(board.GetKey(), found));
+  }
+
+  SECTION("Clearing removes entries") {
+    table.Store(board.GetKey(), solved_bounds(0, 1));
+    table.Clear();
+
+    solved_bounds found;
+    REQUIRE_FALSE(table.Probe(board.GetKey(), found));
+  }
+}